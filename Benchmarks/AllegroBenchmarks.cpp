@@ -0,0 +1,37 @@
+/// Review03: DrawFrame, drawing into an off-screen memory bitmap so no display is
+/// needed. Only built when Allegro was found.
+#include "Benchmark.h"
+
+#include "DrawFrame.h"
+
+#include <allegro5/allegro.h>
+
+// Allegro only needs setting up once for the whole run.
+static bool InitAllegro()
+{
+    static bool initialized = al_init();
+    return initialized;
+}
+
+static void Review03DrawFrame(BenchmarkState& state)
+{
+    if (!InitAllegro())
+    {
+        state.SkipWithMessage("al_init failed");
+        return;
+    }
+
+    al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+    ALLEGRO_BITMAP* target = al_create_bitmap(800, 600);
+    al_set_target_bitmap(target);
+    state.SetItemsPerIteration(kPixelsPerFrame);
+
+    while (state.KeepRunning())
+    {
+        DrawFrame(800, 600);
+    }
+
+    al_set_target_bitmap(nullptr);
+    al_destroy_bitmap(target);
+}
+BENCHMARK(Review03DrawFrame);
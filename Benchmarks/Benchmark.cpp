@@ -0,0 +1,373 @@
+#include "Benchmark.h"
+#include "AllocationTracker.h"
+#include "PerfCounters.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <chrono>
+#include <thread>
+
+#if defined(_WIN32)
+#include <io.h>
+#define dup _dup
+#define dup2 _dup2
+#define fileno _fileno
+#define close _close
+static const char* kNullDevice = "NUL";
+#else
+#include <unistd.h>
+static const char* kNullDevice = "/dev/null";
+#endif
+
+#ifndef BENCH_BUILD_TYPE
+#define BENCH_BUILD_TYPE "unknown"
+#endif
+
+static double NowSeconds()
+{
+    typedef std::chrono::steady_clock Clock;
+    return std::chrono::duration<double>(Clock::now().time_since_epoch()).count();
+}
+
+// One counter for the whole run; opening a perf event isn't free.
+static CacheMissCounter& GetCacheMissCounter()
+{
+    static CacheMissCounter counter;
+    return counter;
+}
+
+BenchmarkState::BenchmarkState(uint64_t iterations, int64_t argument)
+    : mIterations(iterations)
+    , mRemaining(iterations)
+    , mArgument(argument)
+    , mItemsPerIteration(1)
+    , mStarted(false)
+    , mRunning(false)
+    , mElapsedSeconds(0.0)
+    , mAllocations(0)
+    , mAllocatedBytes(0)
+    , mCacheMisses(0)
+    , mStartSeconds(0.0)
+    , mStartAllocations(0)
+    , mStartAllocatedBytes(0)
+{}
+
+bool BenchmarkState::KeepRunning()
+{
+    if (!mStarted)
+    {
+        mStarted = true;
+        Start();
+    }
+
+    if (mRemaining > 0 && !Skipped())
+    {
+        mRemaining--;
+        return true;
+    }
+
+    if (mRunning)
+        Stop();
+
+    return false;
+}
+
+void BenchmarkState::PauseTiming()
+{
+    if (mRunning)
+        Stop();
+}
+
+void BenchmarkState::ResumeTiming()
+{
+    if (!mRunning)
+        Start();
+}
+
+void BenchmarkState::SkipWithMessage(const char* message)
+{
+    mSkipMessage = message;
+}
+
+void BenchmarkState::SetCounter(const char* name, double value)
+{
+    for (std::pair<std::string, double>& counter : mCounters)
+    {
+        if (counter.first == name)
+        {
+            counter.second = value;
+            return;
+        }
+    }
+    mCounters.emplace_back(name, value);
+}
+
+void BenchmarkState::Start()
+{
+    mRunning = true;
+    mStartAllocations = TotalAllocationCount();
+    mStartAllocatedBytes = TotalAllocatedBytes();
+    GetCacheMissCounter().Start();
+    mStartSeconds = NowSeconds();
+}
+
+void BenchmarkState::Stop()
+{
+    double now = NowSeconds();
+    mCacheMisses += GetCacheMissCounter().Stop();
+    mElapsedSeconds += now - mStartSeconds;
+    mAllocations += TotalAllocationCount() - mStartAllocations;
+    mAllocatedBytes += TotalAllocatedBytes() - mStartAllocatedBytes;
+    mRunning = false;
+}
+
+Benchmark::Benchmark(const char* name, BenchmarkFunction function)
+    : mName(name)
+    , mFunction(function)
+{}
+
+Benchmark* Benchmark::Argument(int64_t argument)
+{
+    mArguments.push_back(argument);
+    return this;
+}
+
+static std::vector<Benchmark*>& BenchmarkList()
+{
+    static std::vector<Benchmark*> benchmarks;
+    return benchmarks;
+}
+
+Benchmark* RegisterBenchmark(const char* name, BenchmarkFunction function)
+{
+    Benchmark* benchmark = new Benchmark(name, function);
+    BenchmarkList().push_back(benchmark);
+    return benchmark;
+}
+
+const std::vector<Benchmark*>& RegisteredBenchmarks()
+{
+    return BenchmarkList();
+}
+
+SilenceStdout::SilenceStdout()
+{
+    fflush(stdout);
+    mSavedDescriptor = dup(fileno(stdout));
+
+    FILE* null = fopen(kNullDevice, "w");
+    if (null != nullptr)
+    {
+        dup2(fileno(null), fileno(stdout));
+        fclose(null);
+    }
+}
+
+SilenceStdout::~SilenceStdout()
+{
+    fflush(stdout);
+    if (mSavedDescriptor >= 0)
+    {
+        dup2(mSavedDescriptor, fileno(stdout));
+        close(mSavedDescriptor);
+    }
+}
+
+struct BenchmarkResult
+{
+    std::string name;
+    uint64_t    iterations;
+    uint64_t    operations;
+    double      seconds;
+    uint64_t    allocations;
+    uint64_t    allocatedBytes;
+    uint64_t    cacheMisses;
+    std::string skipMessage;
+    std::vector<std::pair<std::string, double>> counters;
+};
+
+static BenchmarkResult RunOne(const Benchmark& benchmark, int64_t argument, bool hasArgument, double minTime)
+{
+    BenchmarkResult result;
+    result.name = benchmark.Name();
+    if (hasArgument)
+        result.name += "/" + std::to_string(argument);
+
+    uint64_t iterations = 1;
+    const uint64_t maxIterations = 1000000000;
+
+    while (true)
+    {
+        BenchmarkState state(iterations, argument);
+        benchmark.Function()(state);
+
+        double elapsed = state.ElapsedSeconds();
+        if (state.Skipped() || elapsed >= minTime || iterations >= maxIterations)
+        {
+            result.iterations = iterations;
+            result.operations = iterations * state.ItemsPerIteration();
+            result.seconds = elapsed;
+            result.allocations = state.Allocations();
+            result.allocatedBytes = state.AllocatedBytes();
+            result.cacheMisses = state.CacheMisses();
+            result.skipMessage = state.SkipMessage();
+            result.counters = state.Counters();
+            return result;
+        }
+
+        // Aim a little past minTime, but never grow by more than 10x at once.
+        double multiplier = elapsed > 0.0 ? (minTime * 1.4) / elapsed : 10.0;
+        if (multiplier > 10.0)
+            multiplier = 10.0;
+
+        uint64_t next = (uint64_t)(iterations * multiplier);
+        iterations = next > iterations ? next : iterations + 1;
+        if (iterations > maxIterations)
+            iterations = maxIterations;
+    }
+}
+
+static void WriteJsonString(FILE* out, const std::string& text)
+{
+    fputc('"', out);
+    for (char character : text)
+    {
+        if (character == '"' || character == '\\')
+            fputc('\\', out);
+        fputc(character, out);
+    }
+    fputc('"', out);
+}
+
+int RunBenchmarks(int argc, char* argv[])
+{
+    const char* filter = "";
+    const char* outPath = nullptr;
+    double minTime = 0.2;
+    bool listOnly = false;
+
+    for (int index = 1; index < argc; index++)
+    {
+        const char* argument = argv[index];
+
+        if (strncmp(argument, "--filter=", 9) == 0)
+            filter = argument + 9;
+        else if (strncmp(argument, "--min-time=", 11) == 0)
+            minTime = atof(argument + 11);
+        else if (strncmp(argument, "--out=", 6) == 0)
+            outPath = argument + 6;
+        else if (strcmp(argument, "--list") == 0)
+            listOnly = true;
+        else
+        {
+            fprintf(stderr, "usage: %s [--filter=<text>] [--min-time=<seconds>] [--out=<file>] [--list]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // Counting allocations is cheap, but recording their call stacks isn't, and would
+    // show up in the timings
+    SetAllocationSampleInterval(0);
+
+    std::vector<BenchmarkResult> results;
+
+    for (const Benchmark* benchmark : RegisteredBenchmarks())
+    {
+        if (strstr(benchmark->Name().c_str(), filter) == nullptr)
+            continue;
+
+        std::vector<int64_t> arguments = benchmark->Arguments();
+        bool hasArguments = !arguments.empty();
+        if (!hasArguments)
+            arguments.push_back(0);
+
+        for (int64_t argument : arguments)
+        {
+            if (listOnly)
+            {
+                printf("%s", benchmark->Name().c_str());
+                if (hasArguments)
+                    printf("/%lld", (long long)argument);
+                printf("\n");
+                continue;
+            }
+
+            BenchmarkResult result = RunOne(*benchmark, argument, hasArguments, minTime);
+            fprintf(stderr, "%-48s %12.2f ns/op\n", result.name.c_str(),
+                    result.operations ? result.seconds * 1e9 / result.operations : 0.0);
+            results.push_back(result);
+        }
+    }
+
+    if (listOnly)
+        return 0;
+
+    FILE* out = stdout;
+    if (outPath != nullptr)
+    {
+        out = fopen(outPath, "w");
+        if (out == nullptr)
+        {
+            fprintf(stderr, "Can't open %s for writing\n", outPath);
+            return 1;
+        }
+    }
+
+    char date[64];
+    time_t now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+    bool perfAvailable = GetCacheMissCounter().IsAvailable();
+
+    fprintf(out, "{\n  \"context\": {\n");
+    fprintf(out, "    \"date\": \"%s\",\n", date);
+    fprintf(out, "    \"num_cpus\": %u,\n", std::thread::hardware_concurrency());
+    fprintf(out, "    \"build_type\": \"%s\",\n", BENCH_BUILD_TYPE);
+    fprintf(out, "    \"min_time\": %g,\n", minTime);
+    fprintf(out, "    \"cache_miss_counter\": %s\n", perfAvailable ? "true" : "false");
+    fprintf(out, "  },\n  \"benchmarks\": [");
+
+    for (size_t index = 0; index < results.size(); index++)
+    {
+        const BenchmarkResult& result = results[index];
+        double operations = (double)(result.operations ? result.operations : 1);
+
+        fprintf(out, "%s\n    {\n      \"name\": ", index == 0 ? "" : ",");
+        WriteJsonString(out, result.name);
+
+        if (!result.skipMessage.empty())
+        {
+            fprintf(out, ",\n      \"skipped\": ");
+            WriteJsonString(out, result.skipMessage);
+            fprintf(out, "\n    }");
+            continue;
+        }
+
+        fprintf(out, ",\n      \"iterations\": %llu", (unsigned long long)result.iterations);
+        fprintf(out, ",\n      \"operations\": %llu", (unsigned long long)result.operations);
+        fprintf(out, ",\n      \"real_time_s\": %.9g", result.seconds);
+        fprintf(out, ",\n      \"ns_per_op\": %.6g", result.seconds * 1e9 / operations);
+        fprintf(out, ",\n      \"allocs_per_op\": %.6g", result.allocations / operations);
+        fprintf(out, ",\n      \"bytes_allocated_per_op\": %.6g", result.allocatedBytes / operations);
+        if (perfAvailable)
+            fprintf(out, ",\n      \"cache_misses_per_op\": %.6g", result.cacheMisses / operations);
+        else
+            fprintf(out, ",\n      \"cache_misses_per_op\": null");
+        for (const std::pair<std::string, double>& counter : result.counters)
+        {
+            fprintf(out, ",\n      ");
+            WriteJsonString(out, counter.first);
+            fprintf(out, ": %.6g", counter.second);
+        }
+        fprintf(out, "\n    }");
+    }
+
+    fprintf(out, "\n  ]\n}\n");
+
+    if (out != stdout)
+        fclose(out);
+
+    return 0;
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+/// ---------------------------------------------------------------------------------
+/// A very small, Google Benchmark style harness. A benchmark is a function that takes
+/// a `BenchmarkState` and runs its body inside `while (state.KeepRunning())`:
+///
+///     static void FibbonaciIterative(BenchmarkState& state)
+///     {
+///         while (state.KeepRunning())
+///             DoNotOptimize(Fibbonaci64((unsigned int)state.Argument(), ...));
+///     }
+///     BENCHMARK(FibbonaciIterative)->Argument(10)->Argument(90);
+///
+/// The runner keeps increasing the iteration count until a run takes long enough to
+/// be measured, then reports ns/op, allocations/op and (on Linux, when
+/// perf_event_open lets us) cache misses/op as JSON.
+/// ---------------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+class BenchmarkState
+{
+public:
+    BenchmarkState(uint64_t iterations, int64_t argument);
+
+    /// Returns true until the body has been run `Iterations()` times. The clock and
+    /// counters are started on the first call, and stopped on the last.
+    bool KeepRunning();
+
+    uint64_t Iterations() const { return mIterations; }
+    int64_t Argument() const { return mArgument; }
+
+    /// Pause and resume the measurement, for setup that shouldn't be counted.
+    void PauseTiming();
+    void ResumeTiming();
+
+    /// How many 'operations' one iteration represents (e.g. one per shape drawn).
+    /// Per-op numbers are divided by Iterations() * ItemsPerIteration().
+    void SetItemsPerIteration(uint64_t items) { mItemsPerIteration = items; }
+    uint64_t ItemsPerIteration() const { return mItemsPerIteration; }
+
+    /// A number of your own to go in the JSON next to the timings, as is (it's not
+    /// divided by anything): how much of the screen a frame redrew, say.
+    void SetCounter(const char* name, double value);
+    const std::vector<std::pair<std::string, double>>& Counters() const { return mCounters; }
+
+    /// Mark the benchmark as skipped, with a reason that ends up in the JSON.
+    void SkipWithMessage(const char* message);
+    bool Skipped() const { return !mSkipMessage.empty(); }
+    const std::string& SkipMessage() const { return mSkipMessage; }
+
+    double ElapsedSeconds() const { return mElapsedSeconds; }
+    uint64_t Allocations() const { return mAllocations; }
+    uint64_t AllocatedBytes() const { return mAllocatedBytes; }
+    uint64_t CacheMisses() const { return mCacheMisses; }
+
+private:
+    void Start();
+    void Stop();
+
+    uint64_t mIterations;
+    uint64_t mRemaining;
+    int64_t  mArgument;
+    uint64_t mItemsPerIteration;
+    bool     mStarted;
+    bool     mRunning;
+
+    double   mElapsedSeconds;
+    uint64_t mAllocations;
+    uint64_t mAllocatedBytes;
+    uint64_t mCacheMisses;
+
+    // Snapshots taken when the clock was last (re)started.
+    double   mStartSeconds;
+    uint64_t mStartAllocations;
+    uint64_t mStartAllocatedBytes;
+
+    std::string mSkipMessage;
+    std::vector<std::pair<std::string, double>> mCounters;
+};
+
+typedef void (*BenchmarkFunction)(BenchmarkState& state);
+
+class Benchmark
+{
+public:
+    Benchmark(const char* name, BenchmarkFunction function);
+
+    /// Run the benchmark once per argument. No arguments means one run with 0.
+    Benchmark* Argument(int64_t argument);
+
+    const std::string& Name() const { return mName; }
+    BenchmarkFunction Function() const { return mFunction; }
+    const std::vector<int64_t>& Arguments() const { return mArguments; }
+
+private:
+    std::string mName;
+    BenchmarkFunction mFunction;
+    std::vector<int64_t> mArguments;
+};
+
+/// Adds a benchmark to the global list; use the BENCHMARK macro instead.
+Benchmark* RegisterBenchmark(const char* name, BenchmarkFunction function);
+
+/// All registered benchmarks, in registration order.
+const std::vector<Benchmark*>& RegisteredBenchmarks();
+
+#define BENCHMARK_CONCAT2(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT2(a, b)
+#define BENCHMARK(function) \
+    static Benchmark* BENCHMARK_CONCAT(gBenchmark_, __LINE__) = RegisterBenchmark(#function, function)
+
+/// Parses the command line, runs every registered benchmark and writes the JSON
+/// report. Returns the process exit code.
+///   --filter=<text>   only run benchmarks whose name contains <text>
+///   --min-time=<s>    keep growing the iteration count until a run takes this long
+///   --out=<file>      write the JSON here instead of stdout
+///   --list            print the benchmark names and exit
+int RunBenchmarks(int argc, char* argv[]);
+
+/// Stops the compiler from throwing away a value we computed only to time it.
+template<typename T>
+inline void DoNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    const volatile char* volatile sink = reinterpret_cast<const volatile char*>(&value);
+    (void)sink;
+#endif
+}
+
+/// Tells the compiler that any memory may have been read or written.
+inline void ClobberMemory()
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#endif
+}
+
+/// Points stdout at the null device while it's alive, for benchmarking code that
+/// printf's (like the PointerIntro shapes) without flooding the terminal.
+class SilenceStdout
+{
+public:
+    SilenceStdout();
+    ~SilenceStdout();
+
+private:
+    int mSavedDescriptor;
+};
@@ -0,0 +1,124 @@
+/// Review/Review05/DirtyRegions.h: redrawing a frame after a few shapes have moved.
+///
+/// 2000 shapes are scattered over an 800x600 SoftwareBackend. Each op is one frame:
+/// `argument` of the shapes jump somewhere new, and then the frame is either redrawn
+/// from scratch (`Full`: clear the screen, draw every shape) or just where something
+/// changed (`Dirty`: RedrawDirty() with a UniformGrid). Each Dirty run also reports
+/// `dirty_percent`, the share of the screen's pixels it redrew per frame on average.
+#include "Benchmark.h"
+
+#include "DirtyRegions.h"
+#include "ShapeStore.h"
+#include "SoftwareBackend.h"
+#include "SpatialIndex.h"
+
+#include <stdint.h>
+
+static const size_t kDirtySceneShapes = 2000;
+
+// A fixed sequence, so every run moves the same shapes
+static float NextDirtyRandom(uint32_t& state)
+{
+    state = state * 1664525u + 1013904223u;
+    return (float)(state >> 8) * (1.0f / 16777216.0f);
+}
+
+static void FillDirtyScene(ShapeStore& store, uint32_t& random)
+{
+    store.Reserve(kDirtySceneShapes / 2, kDirtySceneShapes / 2);
+    for (size_t index = 0; index < kDirtySceneShapes; index++)
+    {
+        float x = NextDirtyRandom(random) * 800.0f;
+        float y = NextDirtyRandom(random) * 600.0f;
+        if (index % 2 == 0)
+            store.AddCircle(x, y, 2.0f + NextDirtyRandom(random) * 8.0f);
+        else
+            store.AddRectangle(x, y, 4.0f + NextDirtyRandom(random) * 16.0f, 4.0f + NextDirtyRandom(random) * 16.0f);
+    }
+}
+
+static ShapeId MoveRandomShape(ShapeStore& store, uint32_t& random)
+{
+    size_t shape = (size_t)(NextDirtyRandom(random) * (float)store.Count());
+    if (shape >= store.Count())
+        shape = store.Count() - 1;
+
+    size_t circles = store.Circles().Count();
+    ShapeId id = shape < circles ? CircleId(shape) : RectangleId(shape - circles);
+    store.SetCenter(id, Vec2(NextDirtyRandom(random) * 800.0f, NextDirtyRandom(random) * 600.0f));
+    return id;
+}
+
+static void Review05RedrawFull(BenchmarkState& state)
+{
+    uint32_t random = 2468u;
+    ShapeStore store;
+    FillDirtyScene(store, random);
+
+    SoftwareBackend backend(800, 600);
+    SetRenderBackend(&backend);
+
+    const int moves = (int)state.Argument();
+    while (state.KeepRunning())
+    {
+        for (int move = 0; move < moves; move++)
+        {
+            MoveRandomShape(store, random);
+        }
+
+        backend.Clear(MakeRenderColor(0, 0, 0));
+        store.Draw();
+    }
+
+    SetRenderBackend(nullptr);
+    DoNotOptimize(backend.Pixels()[0]);
+}
+
+static void Review05RedrawDirty(BenchmarkState& state)
+{
+    uint32_t random = 2468u;
+    ShapeStore store;
+    FillDirtyScene(store, random);
+
+    UniformGrid grid(AABB(Vec2(0.0f, 0.0f), Vec2(800.0f, 600.0f)), 32.0f);
+    for (size_t circle = 0; circle < store.Circles().Count(); circle++)
+    {
+        grid.Insert(CircleId(circle), store.Bounds(CircleId(circle)));
+    }
+    for (size_t rectangle = 0; rectangle < store.Rectangles().Count(); rectangle++)
+    {
+        grid.Insert(RectangleId(rectangle), store.Bounds(RectangleId(rectangle)));
+    }
+
+    SoftwareBackend backend(800, 600);
+    SetRenderBackend(&backend);
+    backend.Clear(MakeRenderColor(0, 0, 0));
+    store.Draw();
+
+    DirtyRegions dirty(800, 600);
+    store.TrackChanges(&dirty);
+    std::vector<ShapeId> visible;
+
+    const int moves = (int)state.Argument();
+    double totalPercent = 0.0;
+    while (state.KeepRunning())
+    {
+        for (int move = 0; move < moves; move++)
+        {
+            ShapeId id = MoveRandomShape(store, random);
+            grid.Update(id, store.Bounds(id));
+        }
+
+        RedrawDirty(store, grid, dirty, MakeRenderColor(0, 0, 0), visible);
+        totalPercent += dirty.DirtyPercent();
+        dirty.Clear();
+    }
+
+    state.SetCounter("dirty_percent", totalPercent / (double)state.Iterations());
+    store.TrackChanges(nullptr);
+    SetRenderBackend(nullptr);
+    DoNotOptimize(backend.Pixels()[0]);
+}
+
+BENCHMARK(Review05RedrawFull)->Argument(1)->Argument(10)->Argument(100)->Argument(1000);
+BENCHMARK(Review05RedrawDirty)->Argument(1)->Argument(10)->Argument(100)->Argument(1000);
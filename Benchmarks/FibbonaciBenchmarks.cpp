@@ -0,0 +1,87 @@
+/// Review01/Review02: the original recursive Fibbonaci against the faster strategies
+/// in Review01/Fibbonaci.h.
+#include "Benchmark.h"
+
+#include "Fibbonaci.h"
+#include "Functions.h"
+#include "BigNumber.h"
+
+#include <vector>
+
+static void FibbonaciRecursive(BenchmarkState& state)
+{
+    unsigned int index = (unsigned int)state.Argument();
+    while (state.KeepRunning())
+    {
+        DoNotOptimize(Fibbonaci64(index, FibbonaciStrategy::Recursive));
+    }
+}
+BENCHMARK(FibbonaciRecursive)->Argument(10)->Argument(20)->Argument(30);
+
+static void FibbonaciIterative(BenchmarkState& state)
+{
+    unsigned int index = (unsigned int)state.Argument();
+    while (state.KeepRunning())
+    {
+        DoNotOptimize(Fibbonaci64(index, FibbonaciStrategy::Iterative));
+    }
+}
+BENCHMARK(FibbonaciIterative)->Argument(10)->Argument(30)->Argument(90);
+
+static void FibbonaciLookupTable(BenchmarkState& state)
+{
+    unsigned int index = (unsigned int)state.Argument();
+    while (state.KeepRunning())
+    {
+        DoNotOptimize(Fibbonaci64(index, FibbonaciStrategy::LookupTable));
+    }
+}
+BENCHMARK(FibbonaciLookupTable)->Argument(10)->Argument(30)->Argument(90);
+
+static void FibbonaciFastDoubling(BenchmarkState& state)
+{
+    unsigned int index = (unsigned int)state.Argument();
+    while (state.KeepRunning())
+    {
+        DoNotOptimize(Fibbonaci64(index, FibbonaciStrategy::FastDoubling));
+    }
+}
+BENCHMARK(FibbonaciFastDoubling)->Argument(10)->Argument(30)->Argument(90);
+
+// The function Review01/main.cpp actually calls.
+static void FibbonaciUnsigned(BenchmarkState& state)
+{
+    unsigned int index = (unsigned int)state.Argument();
+    while (state.KeepRunning())
+    {
+        DoNotOptimize(Fibbonaci(index));
+    }
+}
+BENCHMARK(FibbonaciUnsigned)->Argument(30);
+
+// One op per value filled in.
+static void FibbonaciRangeFill(BenchmarkState& state)
+{
+    unsigned int count = (unsigned int)state.Argument();
+    std::vector<uint64_t> values(count);
+    state.SetItemsPerIteration(count);
+
+    while (state.KeepRunning())
+    {
+        FibbonaciRange(0, count, values.data());
+        ClobberMemory();
+    }
+}
+BENCHMARK(FibbonaciRangeFill)->Argument(1000)->Argument(1 << 20);
+
+static void FibbonaciBigNumber(BenchmarkState& state)
+{
+    unsigned int index = (unsigned int)state.Argument();
+    while (state.KeepRunning())
+    {
+        BigNumber value;
+        FibbonaciBig(index, value);
+        DoNotOptimize(value.LimbCount());
+    }
+}
+BENCHMARK(FibbonaciBigNumber)->Argument(1000)->Argument(100000);
@@ -0,0 +1,81 @@
+/// Common/Math2DBatch.h: transforming arrays of points, once per instruction set.
+/// The argument is the Math2DKernels (0 = scalar, 1 = SSE2/NEON, 2 = AVX). One op is
+/// one point; 4096 of them fit in the L1 cache, so this is the arithmetic, not the
+/// memory.
+#include "Benchmark.h"
+
+#include "Math2DBatch.h"
+
+#include <vector>
+
+static const size_t kPointCount = 4096;
+
+static bool UseMath2DKernels(BenchmarkState& state)
+{
+    Math2DKernels wanted = (Math2DKernels)state.Argument();
+    if (SetMath2DKernels(wanted) != wanted)
+    {
+        state.SkipWithMessage("not supported by this CPU");
+        SetMath2DKernels(Math2DKernels::Avx);
+        return false;
+    }
+    return true;
+}
+
+// A small rotation about the middle of the screen, so the points stay put
+static Affine2D MakeTransform()
+{
+    const Vec2 middle(400.0f, 300.0f);
+    return Affine2D::Translation(middle) * Affine2D::Rotation(0.001f) * Affine2D::Translation(-middle);
+}
+
+static void Math2DTransformPoints(BenchmarkState& state)
+{
+    if (!UseMath2DKernels(state))
+        return;
+
+    std::vector<Point2D> points(kPointCount);
+    for (size_t index = 0; index < kPointCount; index++)
+    {
+        points[index] = Point2D((float)(index % 800), (float)(index % 600));
+    }
+
+    Affine2D transform = MakeTransform();
+    state.SetItemsPerIteration(kPointCount);
+
+    while (state.KeepRunning())
+    {
+        TransformPoints(points.data(), points.data(), kPointCount, transform);
+        ClobberMemory();
+    }
+
+    SetMath2DKernels(Math2DKernels::Avx);
+}
+
+static void Math2DTransformPointsSoA(BenchmarkState& state)
+{
+    if (!UseMath2DKernels(state))
+        return;
+
+    std::vector<float> x(kPointCount);
+    std::vector<float> y(kPointCount);
+    for (size_t index = 0; index < kPointCount; index++)
+    {
+        x[index] = (float)(index % 800);
+        y[index] = (float)(index % 600);
+    }
+
+    Affine2D transform = MakeTransform();
+    state.SetItemsPerIteration(kPointCount);
+
+    while (state.KeepRunning())
+    {
+        TransformPoints(x.data(), y.data(), x.data(), y.data(), kPointCount, transform);
+        ClobberMemory();
+    }
+
+    SetMath2DKernels(Math2DKernels::Avx);
+}
+
+BENCHMARK(Math2DTransformPoints)->Argument(0)->Argument(1)->Argument(2);
+BENCHMARK(Math2DTransformPointsSoA)->Argument(0)->Argument(1)->Argument(2);
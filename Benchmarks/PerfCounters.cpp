@@ -0,0 +1,61 @@
+#include "PerfCounters.h"
+
+#if defined(__linux__)
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+CacheMissCounter::CacheMissCounter() : mDescriptor(-1)
+{
+    perf_event_attr attributes;
+    memset(&attributes, 0, sizeof(attributes));
+    attributes.type = PERF_TYPE_HARDWARE;
+    attributes.size = sizeof(attributes);
+    attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+    attributes.disabled = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+
+    // pid 0, cpu -1: this thread, on whichever CPU it runs.
+    mDescriptor = (int)syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0);
+}
+
+CacheMissCounter::~CacheMissCounter()
+{
+    if (mDescriptor >= 0)
+        close(mDescriptor);
+}
+
+void CacheMissCounter::Start()
+{
+    if (mDescriptor < 0)
+        return;
+
+    ioctl(mDescriptor, PERF_EVENT_IOC_RESET, 0);
+    ioctl(mDescriptor, PERF_EVENT_IOC_ENABLE, 0);
+}
+
+uint64_t CacheMissCounter::Stop()
+{
+    if (mDescriptor < 0)
+        return 0;
+
+    ioctl(mDescriptor, PERF_EVENT_IOC_DISABLE, 0);
+
+    uint64_t count = 0;
+    if (read(mDescriptor, &count, sizeof(count)) != sizeof(count))
+        return 0;
+
+    return count;
+}
+
+#else
+
+CacheMissCounter::CacheMissCounter() : mDescriptor(-1) {}
+CacheMissCounter::~CacheMissCounter() {}
+void CacheMissCounter::Start() {}
+uint64_t CacheMissCounter::Stop() { return 0; }
+
+#endif
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stdint.h>
+
+/// Counts hardware cache misses for the calling thread using perf_event_open.
+/// That's Linux only, and even there it may be refused (perf_event_paranoid,
+/// containers, virtual machines), in which case IsAvailable() returns false and
+/// the benchmarks just don't report cache misses.
+class CacheMissCounter
+{
+public:
+    CacheMissCounter();
+    ~CacheMissCounter();
+
+    bool IsAvailable() const { return mDescriptor >= 0; }
+
+    void Start();
+    /// Stops counting and returns the misses since Start().
+    uint64_t Stop();
+
+private:
+    int mDescriptor;
+};
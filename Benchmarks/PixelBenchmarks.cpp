@@ -0,0 +1,40 @@
+/// Review03: ScatterPixels into a plain MemorySurface, the same loop DrawFrame runs
+/// on a locked Allegro bitmap, and the tiled, multi-threaded version of a frame.
+#include "Benchmark.h"
+
+#include "DrawFrame.h"
+#include "PixelSurface.h"
+#include "ThreadPool.h"
+#include "TiledFrame.h"
+
+// The argument is the number of pixels per frame
+static void Review03ScatterPixels(BenchmarkState& state)
+{
+    MemorySurface memory(800, 600);
+    PixelSurface surface = memory.Surface();
+    int count = (int)state.Argument();
+    state.SetItemsPerIteration((uint64_t)count);
+
+    while (state.KeepRunning())
+    {
+        ScatterPixels(surface, count);
+    }
+    DoNotOptimize(memory.Pixels()[0]);
+}
+BENCHMARK(Review03ScatterPixels)->Argument(50)->Argument(1000000);
+
+// A whole tiled frame (kPixelsPerFrame pixels in 64x64 tiles) on a pool of the
+// argument's number of threads
+static void Review03TiledFrame(BenchmarkState& state)
+{
+    ThreadPool pool((int)state.Argument());
+    TiledFrame frame(800, 600);
+    state.SetItemsPerIteration(kPixelsPerFrame);
+
+    while (state.KeepRunning())
+    {
+        frame.Render(pool, kPixelsPerFrame);
+    }
+    DoNotOptimize(frame.Frame().Pixels()[0]);
+}
+BENCHMARK(Review03TiledFrame)->Argument(1)->Argument(2)->Argument(4)->Argument(8);
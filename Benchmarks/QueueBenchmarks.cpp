@@ -0,0 +1,170 @@
+/// Common/LockFreeQueue.h: handing items from one thread to another.
+///
+/// Each op is one item through the queue. An iteration starts the producer thread(s),
+/// pushes kQueueItems through, and joins them, so starting the threads is counted
+/// too - but it's spread over a lot of items. A producer that finds the queue full
+/// yields and tries again, and a consumer that finds it empty does the same.
+///
+/// `Spsc` takes the capacity as its argument. `Mpsc` takes the number of producers
+/// (splitting the items between them), with a capacity of 1024. `MutexDeque` is the
+/// obvious alternative, a std::deque behind a std::mutex, with one producer.
+///
+/// The lock-free ones also report `stalls_per_item` (pushes that found the queue
+/// full, per item) and `max_depth` (the most items that were ever waiting): the
+/// numbers to look at when choosing a capacity.
+#include "Benchmark.h"
+
+#include "LockFreeQueue.h"
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static const uint64_t kQueueItems = 100000;
+
+static void SetQueueCounters(BenchmarkState& state, const QueueStats& stats)
+{
+    state.SetCounter("stalls_per_item", (double)stats.fullStalls / (double)stats.pushed);
+    state.SetCounter("max_depth", (double)stats.maxDepth);
+}
+
+static void QueueSpsc(BenchmarkState& state)
+{
+    SpscQueue<uint64_t> queue((size_t)state.Argument());
+    state.SetItemsPerIteration(kQueueItems);
+
+    uint64_t sum = 0;
+    while (state.KeepRunning())
+    {
+        std::thread producer([&queue]()
+        {
+            for (uint64_t item = 0; item < kQueueItems; item++)
+            {
+                while (!queue.TryPush(item))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        uint64_t item;
+        for (uint64_t popped = 0; popped < kQueueItems;)
+        {
+            if (queue.TryPop(item))
+            {
+                sum += item;
+                popped++;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+    }
+
+    SetQueueCounters(state, queue.Stats());
+    DoNotOptimize(sum);
+}
+BENCHMARK(QueueSpsc)->Argument(16)->Argument(1024)->Argument(65536);
+
+static void QueueMpsc(BenchmarkState& state)
+{
+    MpscQueue<uint64_t> queue(1024);
+    const int producers = (int)state.Argument();
+    const uint64_t share = kQueueItems / producers;
+    state.SetItemsPerIteration(share * producers);
+
+    uint64_t sum = 0;
+    std::vector<std::thread> threads;
+    while (state.KeepRunning())
+    {
+        for (int producer = 0; producer < producers; producer++)
+        {
+            threads.emplace_back([&queue, share]()
+            {
+                for (uint64_t item = 0; item < share; item++)
+                {
+                    while (!queue.TryPush(item))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        uint64_t item;
+        for (uint64_t popped = 0; popped < share * producers;)
+        {
+            if (queue.TryPop(item))
+            {
+                sum += item;
+                popped++;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        threads.clear();
+    }
+
+    SetQueueCounters(state, queue.Stats());
+    DoNotOptimize(sum);
+}
+BENCHMARK(QueueMpsc)->Argument(1)->Argument(2)->Argument(4);
+
+static void QueueMutexDeque(BenchmarkState& state)
+{
+    std::mutex mutex;
+    std::deque<uint64_t> queue;
+    state.SetItemsPerIteration(kQueueItems);
+
+    uint64_t sum = 0;
+    while (state.KeepRunning())
+    {
+        std::thread producer([&mutex, &queue]()
+        {
+            for (uint64_t item = 0; item < kQueueItems; item++)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                queue.push_back(item);
+            }
+        });
+
+        for (uint64_t popped = 0; popped < kQueueItems;)
+        {
+            bool got = false;
+            uint64_t item = 0;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!queue.empty())
+                {
+                    item = queue.front();
+                    queue.pop_front();
+                    got = true;
+                }
+            }
+
+            if (got)
+            {
+                sum += item;
+                popped++;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+    }
+
+    DoNotOptimize(sum);
+}
+BENCHMARK(QueueMutexDeque);
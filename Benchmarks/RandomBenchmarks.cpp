@@ -0,0 +1,72 @@
+/// Review03: the random number generators from Random.h against rand(). Every
+/// benchmark makes the argument's worth of numbers in [0, 800) per iteration.
+#include "Benchmark.h"
+
+#include "Random.h"
+
+#include <stdlib.h>
+#include <vector>
+
+// What DrawFrame used to do
+static void RandomRandModulo(BenchmarkState& state)
+{
+    std::vector<uint32_t> values((size_t)state.Argument());
+    state.SetItemsPerIteration(values.size());
+
+    while (state.KeepRunning())
+    {
+        for (uint32_t& value : values)
+            value = (uint32_t)(rand() % 800);
+    }
+    DoNotOptimize(values[0]);
+}
+
+template<typename Engine>
+static void BoundedWith(BenchmarkState& state)
+{
+    Engine engine;
+    std::vector<uint32_t> values((size_t)state.Argument());
+    state.SetItemsPerIteration(values.size());
+
+    while (state.KeepRunning())
+    {
+        for (uint32_t& value : values)
+            value = Bounded(engine, 800);
+    }
+    DoNotOptimize(values[0]);
+}
+
+static void RandomXoshiroBounded(BenchmarkState& state) { BoundedWith<Xoshiro256pp>(state); }
+static void RandomPcgBounded(BenchmarkState& state) { BoundedWith<Pcg32>(state); }
+
+static void RandomBatchBounded(BenchmarkState& state)
+{
+    RandomBatch& random = ThreadRandomBatch();
+    std::vector<uint32_t> values((size_t)state.Argument());
+    state.SetItemsPerIteration(values.size());
+
+    while (state.KeepRunning())
+    {
+        random.FillBounded(values.data(), values.size(), 800);
+    }
+    DoNotOptimize(values[0]);
+}
+
+static void RandomBatchFill(BenchmarkState& state)
+{
+    RandomBatch& random = ThreadRandomBatch();
+    std::vector<uint32_t> values((size_t)state.Argument());
+    state.SetItemsPerIteration(values.size());
+
+    while (state.KeepRunning())
+    {
+        random.Fill(values.data(), values.size());
+    }
+    DoNotOptimize(values[0]);
+}
+
+BENCHMARK(RandomRandModulo)->Argument(1024);
+BENCHMARK(RandomXoshiroBounded)->Argument(1024);
+BENCHMARK(RandomPcgBounded)->Argument(1024);
+BENCHMARK(RandomBatchBounded)->Argument(1024);
+BENCHMARK(RandomBatchFill)->Argument(1024);
@@ -0,0 +1,186 @@
+/// Review04: transforming and culling vertices in each of the layouts from
+/// VertexLayouts.h. Only the positions are used, so this mostly measures how many
+/// bytes each layout drags through the cache per position - plus, for the packed
+/// VisibleVertex02, what misaligned floats cost. The argument is the vertex count.
+#include "Benchmark.h"
+
+#include "ThreadPool.h"
+#include "VertexLayouts.h"
+#include "VisibilityStream.h"
+
+#include <math.h>
+
+// Positions spread over twice the screen, so about a quarter are visible
+static Vertex MakeVertex(size_t index)
+{
+    Vertex vertex;
+    vertex.position.x = (float)((index * 7919) % 1600) - 400.0f;
+    vertex.position.y = (float)((index * 104729) % 1200) - 300.0f;
+    vertex.color.r = (float)(index % 256) / 255.0f;
+    vertex.color.g = 0.5f;
+    vertex.color.b = 1.0f;
+    vertex.texCoord.u = (float)(index % 64) / 64.0f;
+    vertex.texCoord.v = (float)(index % 32) / 32.0f;
+    return vertex;
+}
+
+// A small rotation about the origin. The benchmarks apply it again every iteration,
+// and a rotation keeps the points from drifting off to infinity.
+static Transform2D MakeTransform()
+{
+    const float angle = 0.001f;
+    Transform2D transform = { cosf(angle), -sinf(angle), sinf(angle), cosf(angle), 0.0f, 0.0f };
+    return transform;
+}
+
+static const CullRect kScreen = { 0.0f, 0.0f, 800.0f, 600.0f };
+
+template<typename Layout>
+static void TransformLayout(BenchmarkState& state)
+{
+    size_t count = (size_t)state.Argument();
+    Layout vertices;
+    vertices.Resize(count);
+    for (size_t index = 0; index < count; index++)
+    {
+        vertices.Set(index, MakeVertex(index));
+    }
+
+    Transform2D transform = MakeTransform();
+    state.SetItemsPerIteration(count);
+
+    while (state.KeepRunning())
+    {
+        DoNotOptimize(TransformAndCull(vertices, transform, kScreen));
+    }
+}
+
+template<typename VisibleVertex>
+static void TransformVisible(BenchmarkState& state)
+{
+    size_t count = (size_t)state.Argument();
+    std::vector<VisibleVertex> vertices(count);
+    for (size_t index = 0; index < count; index++)
+    {
+        Vertex vertex = MakeVertex(index);
+        vertices[index].visible = false;
+        vertices[index].position = vertex.position;
+        vertices[index].color = vertex.color;
+        vertices[index].texCoord = vertex.texCoord;
+    }
+
+    Transform2D transform = MakeTransform();
+    state.SetItemsPerIteration(count);
+
+    while (state.KeepRunning())
+    {
+        DoNotOptimize(TransformAndCull(vertices.data(), count, transform, kScreen));
+    }
+}
+
+static void Review04TransformAoS(BenchmarkState& state) { TransformLayout<VertexArrayAoS>(state); }
+static void Review04TransformSoA(BenchmarkState& state) { TransformLayout<VertexArraySoA>(state); }
+static void Review04TransformAoSoA8(BenchmarkState& state) { TransformLayout<VertexArrayAoSoA>(state); }
+static void Review04TransformCompact(BenchmarkState& state) { TransformLayout<CompactVertexArray>(state); }
+static void Review04TransformVisible01(BenchmarkState& state) { TransformVisible<VisibleVertex01>(state); }
+static void Review04TransformVisible02Packed(BenchmarkState& state) { TransformVisible<VisibleVertex02>(state); }
+
+BENCHMARK(Review04TransformAoS)->Argument(100000)->Argument(10000000);
+BENCHMARK(Review04TransformSoA)->Argument(100000)->Argument(10000000);
+BENCHMARK(Review04TransformAoSoA8)->Argument(100000)->Argument(10000000);
+BENCHMARK(Review04TransformCompact)->Argument(100000)->Argument(10000000);
+BENCHMARK(Review04TransformVisible01)->Argument(100000)->Argument(10000000);
+BENCHMARK(Review04TransformVisible02Packed)->Argument(100000)->Argument(10000000);
+
+/// Culling and then compacting - copying just the visible vertices into a buffer of
+/// their own - with no transform, so it's only the visibility that's measured. About a
+/// quarter of the vertices are visible, scattered at random, so a branch on `visible`
+/// is mispredicted a lot.
+static void Review04CompactVisible01(BenchmarkState& state)
+{
+    size_t count = (size_t)state.Argument();
+    std::vector<VisibleVertex01> vertices(count);
+    for (size_t index = 0; index < count; index++)
+    {
+        Vertex vertex = MakeVertex(index);
+        vertices[index].position = vertex.position;
+        vertices[index].color = vertex.color;
+        vertices[index].texCoord = vertex.texCoord;
+    }
+
+    std::vector<Vertex> out(count);
+    state.SetItemsPerIteration(count);
+
+    while (state.KeepRunning())
+    {
+        size_t written = 0;
+        for (size_t index = 0; index < count; index++)
+        {
+            const Point2D& position = vertices[index].position;
+            vertices[index].visible = position.x >= kScreen.left && position.x < kScreen.right &&
+                                      position.y >= kScreen.top && position.y < kScreen.bottom;
+        }
+        for (size_t index = 0; index < count; index++)
+        {
+            if (vertices[index].visible)
+            {
+                out[written].position = vertices[index].position;
+                out[written].color = vertices[index].color;
+                out[written].texCoord = vertices[index].texCoord;
+                written++;
+            }
+        }
+        DoNotOptimize(written);
+    }
+}
+
+static void FillStream(VisibleVertexStream& stream, size_t count)
+{
+    stream.Resize(count);
+    for (size_t index = 0; index < count; index++)
+    {
+        stream.vertices.Set(index, MakeVertex(index));
+    }
+}
+
+static void Review04CompactBitset(BenchmarkState& state)
+{
+    size_t count = (size_t)state.Argument();
+    VisibleVertexStream stream;
+    FillStream(stream, count);
+
+    VertexArraySoA out;
+    state.SetItemsPerIteration(count);
+
+    while (state.KeepRunning())
+    {
+        Cull(stream, kScreen);
+        DoNotOptimize(Compact(stream, out));
+    }
+}
+
+// 10 million vertices, compacted in parallel on a pool of the argument's number of
+// threads
+static void Review04CompactBitsetParallel(BenchmarkState& state)
+{
+    const size_t count = 10000000;
+    VisibleVertexStream stream;
+    FillStream(stream, count);
+
+    ThreadPool pool((int)state.Argument());
+    VertexArraySoA out;
+    state.SetItemsPerIteration(count);
+
+    while (state.KeepRunning())
+    {
+        Cull(stream, kScreen);
+        CompactionPlan plan = PlanCompaction(stream.visible, pool.ThreadCount() * 4);
+        out.Resize(plan.total);
+        pool.ParallelFor(plan.ChunkCount(), [&](int chunk) { CompactChunk(plan, chunk, stream, out); });
+        DoNotOptimize(out.x[0]);
+    }
+}
+
+BENCHMARK(Review04CompactVisible01)->Argument(100000)->Argument(10000000);
+BENCHMARK(Review04CompactBitset)->Argument(100000)->Argument(10000000);
+BENCHMARK(Review04CompactBitsetParallel)->Argument(1)->Argument(2)->Argument(4)->Argument(8);
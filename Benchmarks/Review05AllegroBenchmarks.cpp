@@ -0,0 +1,70 @@
+/// Review/Review05: the same benchmarks as Review05Benchmarks.cpp, drawn by the
+/// Allegro primitives addon into an off-screen memory bitmap.
+#include "Review05Benchmarks.h"
+
+#include "AllegroBackend.h"
+#include "ShapeBatcher.h"
+#include "ShapeStore.h"
+
+#include <allegro5/allegro.h>
+#include <allegro5/allegro_primitives.h>
+
+static bool InitAllegro()
+{
+    static bool initialized = al_init() && al_init_primitives_addon();
+    return initialized;
+}
+
+template<typename Backend>
+static void WithBackend(BenchmarkState& state, void (*benchmark)(BenchmarkState&))
+{
+    if (!InitAllegro())
+    {
+        state.SkipWithMessage("al_init failed");
+        return;
+    }
+
+    al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+    ALLEGRO_BITMAP* target = al_create_bitmap(800, 600);
+    al_set_target_bitmap(target);
+
+    Backend backend;
+    SetRenderBackend(&backend);
+    benchmark(state);
+    SetRenderBackend(nullptr);
+
+    al_set_target_bitmap(nullptr);
+    al_destroy_bitmap(target);
+}
+
+static void WithAllegroBackend(BenchmarkState& state, void (*benchmark)(BenchmarkState&))
+{
+    WithBackend<AllegroBackend>(state, benchmark);
+}
+
+// ShapeStore::Draw() into a ShapeBatcher, then Flush(): two al_draw_indexed_prim
+// calls per iteration instead of one al_draw_* per shape.
+static void DrawShapeStoreBatched(BenchmarkState& state)
+{
+    size_t count = (size_t)state.Argument();
+    ShapeStore store;
+    FillShapeStore(store, count);
+    state.SetItemsPerIteration(count);
+
+    ShapeBatcher& batcher = static_cast<ShapeBatcher&>(GetRenderBackend());
+    while (state.KeepRunning())
+    {
+        store.Draw();
+        batcher.Flush();
+    }
+}
+
+static void Review05VirtualDraw(BenchmarkState& state) { WithAllegroBackend(state, DrawVirtualShapes); }
+static void Review05StoreDraw(BenchmarkState& state) { WithAllegroBackend(state, DrawShapeStore); }
+static void Review05StoreForEachDraw(BenchmarkState& state) { WithAllegroBackend(state, DrawShapeStoreForEach); }
+static void Review05StoreBatchedDraw(BenchmarkState& state) { WithBackend<ShapeBatcher>(state, DrawShapeStoreBatched); }
+
+BENCHMARK(Review05VirtualDraw)->Argument(10)->Argument(1000)->Argument(100000);
+BENCHMARK(Review05StoreDraw)->Argument(10)->Argument(1000)->Argument(100000);
+BENCHMARK(Review05StoreForEachDraw)->Argument(10)->Argument(1000)->Argument(100000);
+BENCHMARK(Review05StoreBatchedDraw)->Argument(10)->Argument(1000)->Argument(100000);
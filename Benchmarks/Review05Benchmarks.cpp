@@ -0,0 +1,118 @@
+/// Review/Review05: virtual Draw() dispatch through VirtualShape*, against the same
+/// shapes held in a ShapeStore, drawn by the software rasterizer into an 800x600
+/// framebuffer in memory.
+///
+/// Review05 and PointerIntro both define their own VirtualShape, Circle and Rectangle,
+/// so they can't be linked into the same program. These live in `bench_review05`.
+#include "Review05Benchmarks.h"
+
+#include "Shape.h"
+#include "Circle.h"
+#include "Rectangle.h"
+#include "ShapeStore.h"
+#include "SoftwareBackend.h"
+
+#include <vector>
+
+void DrawVirtualShapes(BenchmarkState& state)
+{
+    size_t count = (size_t)state.Argument();
+    std::vector<VirtualShape*> shapes(count);
+    for (size_t index = 0; index < count; index++)
+    {
+        float position = (float)(index % 600);
+        if (index % 2 == 0)
+            shapes[index] = new Circle(position, position, 5.0f);
+        else
+            shapes[index] = new Rectangle(position, position, 5.0f, 10.0f);
+    }
+    state.SetItemsPerIteration(count);
+
+    while (state.KeepRunning())
+    {
+        for (VirtualShape* shape : shapes)
+        {
+            shape->Draw();
+        }
+    }
+
+    for (VirtualShape* shape : shapes)
+    {
+        delete shape;
+    }
+}
+
+void FillShapeStore(ShapeStore& store, size_t count)
+{
+    store.Reserve(count / 2 + 1, count / 2 + 1);
+    for (size_t index = 0; index < count; index++)
+    {
+        float position = (float)(index % 600);
+        if (index % 2 == 0)
+            store.AddCircle(position, position, 5.0f);
+        else
+            store.AddRectangle(position, position, 5.0f, 10.0f);
+    }
+}
+
+void DrawShapeStore(BenchmarkState& state)
+{
+    size_t count = (size_t)state.Argument();
+    ShapeStore store;
+    FillShapeStore(store, count);
+    state.SetItemsPerIteration(count);
+
+    while (state.KeepRunning())
+    {
+        store.Draw();
+    }
+}
+
+void DrawShapeStoreForEach(BenchmarkState& state)
+{
+    size_t count = (size_t)state.Argument();
+    ShapeStore store;
+    FillShapeStore(store, count);
+    state.SetItemsPerIteration(count);
+
+    while (state.KeepRunning())
+    {
+        store.ForEach([](VirtualShape& shape) { shape.Draw(); });
+    }
+}
+
+/// ---------------------------------------------------------------------------------
+/// With the software rasterizer
+/// ---------------------------------------------------------------------------------
+static void WithSoftwareBackend(BenchmarkState& state, void (*benchmark)(BenchmarkState&))
+{
+    SoftwareBackend backend(800, 600);
+    SetRenderBackend(&backend);
+    benchmark(state);
+    SetRenderBackend(nullptr);
+    DoNotOptimize(backend.Pixels()[0]);
+}
+
+static void Review05SoftwareVirtualDraw(BenchmarkState& state) { WithSoftwareBackend(state, DrawVirtualShapes); }
+static void Review05SoftwareStoreDraw(BenchmarkState& state) { WithSoftwareBackend(state, DrawShapeStore); }
+static void Review05SoftwareStoreForEachDraw(BenchmarkState& state) { WithSoftwareBackend(state, DrawShapeStoreForEach); }
+
+BENCHMARK(Review05SoftwareVirtualDraw)->Argument(10)->Argument(1000)->Argument(100000);
+BENCHMARK(Review05SoftwareStoreDraw)->Argument(10)->Argument(1000)->Argument(100000);
+BENCHMARK(Review05SoftwareStoreForEachDraw)->Argument(10)->Argument(1000)->Argument(100000);
+
+// The rasterizer on its own: filled circles and rectangles of the given size
+static void Review05SoftwareFill(BenchmarkState& state)
+{
+    SoftwareBackend backend(800, 600);
+    float size = (float)state.Argument();
+    RenderColor color = MakeRenderColor(255, 128, 0);
+
+    while (state.KeepRunning())
+    {
+        backend.FillCircle(400.0f, 300.0f, size * 0.5f, color);
+        backend.FillRectangle(400.0f - size * 0.5f, 300.0f - size * 0.5f, 400.0f + size * 0.5f, 300.0f + size * 0.5f, color);
+    }
+    DoNotOptimize(backend.Pixels()[0]);
+}
+BENCHMARK(Review05SoftwareFill)->Argument(10)->Argument(100)->Argument(500);
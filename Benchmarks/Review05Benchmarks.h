@@ -0,0 +1,24 @@
+#pragma once
+
+/// The Review05 drawing benchmarks, written once and run against each RenderBackend
+/// (Review05Benchmarks.cpp for the software one, Review05AllegroBenchmarks.cpp for
+/// Allegro). They draw with whatever backend is current; the argument is the number
+/// of shapes, half circles and half rectangles.
+#include "Benchmark.h"
+
+#include <stddef.h>
+
+class ShapeStore;
+
+/// The store every ShapeStore benchmark draws: `count` shapes, alternating circles
+/// and rectangles.
+void FillShapeStore(ShapeStore& store, size_t count);
+
+/// VirtualShape* array, virtual Draw() per shape
+void DrawVirtualShapes(BenchmarkState& state);
+
+/// ShapeStore::Draw(): one loop per type
+void DrawShapeStore(BenchmarkState& state);
+
+/// ShapeStore::ForEach() with VirtualShape::Draw(), the compatibility path
+void DrawShapeStoreForEach(BenchmarkState& state);
@@ -0,0 +1,170 @@
+/// Review/Review05/SceneFile.h: getting a scene of shapes off disk.
+///
+/// Each benchmark writes a scene of `argument` shapes (half circles, half rectangles)
+/// to a file in the current directory, and deletes it when it's done. The file is in
+/// the operating system's cache after it's been written, so these time the loading,
+/// not the disk.
+///
+/// `Objects` is the old way: a `new Circle` or `new Rectangle` per shape, behind
+/// VirtualShape pointers. `Store` copies the arrays into a ShapeStore. `Mapped` is just
+/// MappedScene::Open() without checking the arrays' CRCs, `MappedVerified` with, and
+/// `MappedIterate` opens it and reads every float in place. `Write` is SceneWriter
+/// writing the whole file.
+#include "Benchmark.h"
+
+#include "Circle.h"
+#include "Rectangle.h"
+#include "SceneFile.h"
+#include "ShapeStore.h"
+
+#include <stdio.h>
+#include <vector>
+
+static const char* kScenePath = "bench_review05_scene.r05";
+
+static void FillSceneStore(ShapeStore& store, size_t count)
+{
+    store.Reserve(count / 2 + 1, count / 2 + 1);
+    for (size_t index = 0; index < count; index++)
+    {
+        float position = (float)(index % 600);
+        if (index % 2 == 0)
+            store.AddCircle(position, position, 5.0f);
+        else
+            store.AddRectangle(position, position, 5.0f, 10.0f);
+    }
+}
+
+static bool WriteBenchmarkScene(BenchmarkState& state)
+{
+    ShapeStore store;
+    FillSceneStore(store, (size_t)state.Argument());
+    if (!WriteScene(kScenePath, store))
+    {
+        state.SkipWithMessage("couldn't write the scene file in the current directory");
+        return false;
+    }
+
+    state.SetItemsPerIteration(store.Count());
+    return true;
+}
+
+static void Review05SceneLoadObjects(BenchmarkState& state)
+{
+    if (!WriteBenchmarkScene(state))
+        return;
+
+    std::vector<VirtualShape*> shapes;
+    while (state.KeepRunning())
+    {
+        MappedScene scene;
+        scene.Open(kScenePath);
+
+        const MappedScene::CircleArrays& circles = scene.Circles();
+        const MappedScene::RectangleArrays& rectangles = scene.Rectangles();
+        shapes.reserve(scene.Count());
+        for (size_t index = 0; index < circles.Count(); index++)
+        {
+            shapes.push_back(new Circle(circles.x[index], circles.y[index], circles.radius[index]));
+        }
+        for (size_t index = 0; index < rectangles.Count(); index++)
+        {
+            shapes.push_back(new Rectangle(rectangles.x[index], rectangles.y[index], rectangles.width[index], rectangles.height[index]));
+        }
+        DoNotOptimize(shapes.data());
+
+        state.PauseTiming();
+        for (VirtualShape* shape : shapes)
+        {
+            delete shape;
+        }
+        shapes.clear();
+        state.ResumeTiming();
+    }
+
+    remove(kScenePath);
+}
+
+static void Review05SceneLoadStore(BenchmarkState& state)
+{
+    if (!WriteBenchmarkScene(state))
+        return;
+
+    while (state.KeepRunning())
+    {
+        MappedScene scene;
+        scene.Open(kScenePath);
+
+        ShapeStore store;
+        scene.CopyTo(store);
+        DoNotOptimize(store.Count());
+    }
+
+    remove(kScenePath);
+}
+
+static void RunMappedScene(BenchmarkState& state, bool verifyChecksums, bool iterate)
+{
+    if (!WriteBenchmarkScene(state))
+        return;
+
+    while (state.KeepRunning())
+    {
+        MappedScene scene;
+        if (scene.Open(kScenePath, verifyChecksums) != SceneFileStatus::Ok)
+        {
+            state.SkipWithMessage("couldn't open the scene file");
+            break;
+        }
+
+        if (iterate)
+        {
+            const MappedScene::CircleArrays& circles = scene.Circles();
+            const MappedScene::RectangleArrays& rectangles = scene.Rectangles();
+
+            float sum = 0.0f;
+            for (size_t index = 0; index < circles.Count(); index++)
+            {
+                sum += circles.x[index] + circles.y[index] + circles.radius[index];
+            }
+            for (size_t index = 0; index < rectangles.Count(); index++)
+            {
+                sum += rectangles.x[index] + rectangles.y[index] + rectangles.width[index] + rectangles.height[index];
+            }
+            DoNotOptimize(sum);
+        }
+
+        DoNotOptimize(scene.Count());
+    }
+
+    remove(kScenePath);
+}
+
+static void Review05SceneMapped(BenchmarkState& state) { RunMappedScene(state, false, false); }
+static void Review05SceneMappedVerified(BenchmarkState& state) { RunMappedScene(state, true, false); }
+static void Review05SceneMappedIterate(BenchmarkState& state) { RunMappedScene(state, false, true); }
+
+static void Review05SceneWrite(BenchmarkState& state)
+{
+    ShapeStore store;
+    FillSceneStore(store, (size_t)state.Argument());
+    state.SetItemsPerIteration(store.Count());
+
+    while (state.KeepRunning())
+    {
+        if (!WriteScene(kScenePath, store))
+        {
+            state.SkipWithMessage("couldn't write the scene file in the current directory");
+            break;
+        }
+    }
+
+    remove(kScenePath);
+}
+
+BENCHMARK(Review05SceneLoadObjects)->Argument(10000)->Argument(1000000);
+BENCHMARK(Review05SceneLoadStore)->Argument(10000)->Argument(1000000);
+BENCHMARK(Review05SceneMapped)->Argument(10000)->Argument(1000000);
+BENCHMARK(Review05SceneMappedVerified)->Argument(10000)->Argument(1000000);
+BENCHMARK(Review05SceneMappedIterate)->Argument(10000)->Argument(1000000);
+BENCHMARK(Review05SceneWrite)->Argument(10000)->Argument(1000000);
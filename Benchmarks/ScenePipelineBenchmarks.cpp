@@ -0,0 +1,76 @@
+/// Review/Review05/ScenePipeline.h: a million moving shapes, one frame per op.
+///
+/// The argument is the number of threads in the pool (1 is the serial baseline: the
+/// same stages, all on the calling thread). The shapes are scattered over a world 64
+/// screens across and turn slowly about the middle of the screen, so a few hundred
+/// are visible each frame. `Prepare` is the four parallel stages; `Frame` adds the
+/// Submit() to the SoftwareBackend, which stays on the calling thread.
+#include "Benchmark.h"
+
+#include "ScenePipeline.h"
+#include "ShapeStore.h"
+#include "SoftwareBackend.h"
+#include "ThreadPool.h"
+
+#include <stdint.h>
+
+static const size_t kSceneShapeCount = 1000000;
+
+// A fixed sequence, so every run gets the same scene
+static float NextSceneRandom(uint32_t& state)
+{
+    state = state * 1664525u + 1013904223u;
+    return (float)(state >> 8) * (1.0f / 16777216.0f);
+}
+
+static void FillScene(ShapeStore& store)
+{
+    const float width = 800.0f * 64.0f;
+    const float height = 600.0f * 64.0f;
+
+    uint32_t random = 54321u;
+    store.Reserve(kSceneShapeCount / 2, kSceneShapeCount / 2);
+    for (size_t index = 0; index < kSceneShapeCount; index++)
+    {
+        float x = 400.0f + (NextSceneRandom(random) - 0.5f) * width;
+        float y = 300.0f + (NextSceneRandom(random) - 0.5f) * height;
+        if (index % 2 == 0)
+            store.AddCircle(x, y, 4.0f + NextSceneRandom(random) * 12.0f);
+        else
+            store.AddRectangle(x, y, 8.0f + NextSceneRandom(random) * 24.0f, 8.0f + NextSceneRandom(random) * 24.0f);
+    }
+}
+
+static void RunScenePipeline(BenchmarkState& state, bool submit)
+{
+    ShapeStore store;
+    FillScene(store);
+
+    ThreadPool pool((int)state.Argument());
+    ScenePipeline pipeline(pool);
+
+    SoftwareBackend backend(800, 600);
+    SetRenderBackend(&backend);
+
+    const Vec2 middle(400.0f, 300.0f);
+    const Affine2D motion = Affine2D::Translation(middle) * Affine2D::Rotation(0.001f) * Affine2D::Translation(-middle);
+    const AABB viewport(Vec2(0.0f, 0.0f), Vec2(800.0f, 600.0f));
+
+    state.SetItemsPerIteration(store.Count());
+    while (state.KeepRunning())
+    {
+        pipeline.Prepare(store, motion, viewport);
+        if (submit)
+            pipeline.Submit();
+        DoNotOptimize(pipeline.DrawList().size());
+    }
+
+    SetRenderBackend(nullptr);
+    DoNotOptimize(backend.Pixels()[0]);
+}
+
+static void Review05ScenePipelinePrepare(BenchmarkState& state) { RunScenePipeline(state, false); }
+static void Review05ScenePipelineFrame(BenchmarkState& state) { RunScenePipeline(state, true); }
+
+BENCHMARK(Review05ScenePipelinePrepare)->Argument(1)->Argument(2)->Argument(4)->Argument(8)->Argument(32);
+BENCHMARK(Review05ScenePipelineFrame)->Argument(1)->Argument(2)->Argument(4)->Argument(8)->Argument(32);
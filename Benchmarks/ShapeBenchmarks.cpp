@@ -0,0 +1,292 @@
+/// Pointers/PointerIntro: virtual Draw() dispatch through VirtualShape*. The shapes
+/// printf when they draw (and when they're constructed), so stdout is pointed at the
+/// null device while these run - the numbers include the printf.
+#include "Benchmark.h"
+
+#include "Shape.h"
+#include "Circle.h"
+#include "Rectangle.h"
+#include "PoolAllocator.h"
+#include "ShapeDispatch.h"
+#include "CompactShape.h"
+
+#include <stdlib.h>
+#include <algorithm>
+#include <random>
+
+#include <vector>
+
+static std::vector<VirtualShape*> CreateShapes(size_t count)
+{
+    std::vector<VirtualShape*> shapes(count);
+    for (size_t index = 0; index < count; index++)
+    {
+        float position = (float)index;
+        if (index % 2 == 0)
+            shapes[index] = new Circle(position, position, 5.0f);
+        else
+            shapes[index] = new Rectangle(position, position, 5.0f, 10.0f);
+    }
+    return shapes;
+}
+
+static void DestroyShapes(std::vector<VirtualShape*>& shapes)
+{
+    for (VirtualShape* shape : shapes)
+    {
+        delete shape;
+    }
+    shapes.clear();
+}
+
+static void PointerIntroVirtualDraw(BenchmarkState& state)
+{
+    SilenceStdout silence;
+
+    std::vector<VirtualShape*> shapes = CreateShapes((size_t)state.Argument());
+    state.SetItemsPerIteration(shapes.size());
+
+    while (state.KeepRunning())
+    {
+        for (VirtualShape* shape : shapes)
+        {
+            shape->Draw();
+        }
+    }
+
+    DestroyShapes(shapes);
+}
+BENCHMARK(PointerIntroVirtualDraw)->Argument(10)->Argument(1000);
+
+// The one-new-per-shape pattern in PointerIntro/main.cpp. Circle and Rectangle are
+// PoolAllocated, so after the first run these come out of their pools.
+static void PointerIntroCreateShapes(BenchmarkState& state)
+{
+    SilenceStdout silence;
+
+    size_t count = (size_t)state.Argument();
+    state.SetItemsPerIteration(count);
+
+    while (state.KeepRunning())
+    {
+        std::vector<VirtualShape*> shapes = CreateShapes(count);
+        DestroyShapes(shapes);
+    }
+}
+BENCHMARK(PointerIntroCreateShapes)->Argument(1000);
+
+// Building a scene with `new` out of the pools, then throwing the whole thing away
+// with ResetPool() instead of deleting each shape.
+static void PointerIntroPoolResetScene(BenchmarkState& state)
+{
+    SilenceStdout silence;
+
+    size_t count = (size_t)state.Argument();
+    std::vector<VirtualShape*> shapes;
+    state.SetItemsPerIteration(count);
+
+    while (state.KeepRunning())
+    {
+        shapes = CreateShapes(count);
+        Circle::ResetPool();
+        Rectangle::ResetPool();
+    }
+}
+BENCHMARK(PointerIntroPoolResetScene)->Argument(1000);
+
+// The same scene out of a FrameArena, freed with one Reset().
+static void PointerIntroArenaScene(BenchmarkState& state)
+{
+    SilenceStdout silence;
+
+    size_t count = (size_t)state.Argument();
+    FrameArena arena;
+    std::vector<VirtualShape*> shapes(count);
+    state.SetItemsPerIteration(count);
+
+    while (state.KeepRunning())
+    {
+        for (size_t index = 0; index < count; index++)
+        {
+            float position = (float)index;
+            if (index % 2 == 0)
+                shapes[index] = arena.New<Circle>(position, position, 5.0f);
+            else
+                shapes[index] = arena.New<Rectangle>(position, position, 5.0f, 10.0f);
+        }
+        DoNotOptimize(shapes.data());
+        arena.Reset();
+    }
+}
+BENCHMARK(PointerIntroArenaScene)->Argument(1000);
+
+/// ---------------------------------------------------------------------------------
+/// Virtual calls vs std::variant vs CompactShape vs CRTP. Each op is one Area() call
+/// on one shape (Draw() would just be measuring printf), half circles and half
+/// rectangles.
+///
+/// "Sorted" has all the circles first, then all the rectangles, so the branch (or
+/// indirect call) always goes the same way. "Shuffled" mixes them up at random, so
+/// the CPU's branch predictor gets it wrong about half the time. CRTP keeps each type
+/// in its own vector, so it's always sorted.
+///
+/// 100M shapes needs several GB, so it's skipped unless BENCH_HUGE is set.
+/// ---------------------------------------------------------------------------------
+static const int64_t kHugeShapeCount = 100000000;
+
+static bool SkipIfTooBig(BenchmarkState& state)
+{
+    if (state.Argument() >= kHugeShapeCount && getenv("BENCH_HUGE") == nullptr)
+    {
+        state.SkipWithMessage("set BENCH_HUGE=1 to run with 100M shapes");
+        return true;
+    }
+    return false;
+}
+
+// true = circle. Exactly half of each, in order or shuffled.
+static std::vector<bool> ShapeKinds(size_t count, bool shuffled)
+{
+    std::vector<bool> kinds(count);
+    for (size_t index = 0; index < count; index++)
+    {
+        kinds[index] = index < count / 2;
+    }
+
+    if (shuffled)
+    {
+        std::mt19937 random(1234);
+        std::shuffle(kinds.begin(), kinds.end(), random);
+    }
+    return kinds;
+}
+
+static void DispatchVirtual(BenchmarkState& state, bool shuffled)
+{
+    if (SkipIfTooBig(state))
+        return;
+
+    size_t count = (size_t)state.Argument();
+    std::vector<VirtualShape*> shapes(count);
+    {
+        SilenceStdout silence;
+        std::vector<bool> kinds = ShapeKinds(count, shuffled);
+        for (size_t index = 0; index < count; index++)
+        {
+            if (kinds[index])
+                shapes[index] = new Circle(1.0f, 1.0f, 5.0f);
+            else
+                shapes[index] = new Rectangle(1.0f, 1.0f, 5.0f, 10.0f);
+        }
+    }
+    state.SetItemsPerIteration(count);
+
+    while (state.KeepRunning())
+    {
+        float total = 0.0f;
+        for (const VirtualShape* shape : shapes)
+        {
+            total += shape->Area();
+        }
+        DoNotOptimize(total);
+    }
+
+    DestroyShapes(shapes);
+}
+
+static void DispatchVariant(BenchmarkState& state, bool shuffled)
+{
+    if (SkipIfTooBig(state))
+        return;
+
+    size_t count = (size_t)state.Argument();
+    std::vector<ShapeVariant> shapes;
+    {
+        SilenceStdout silence;
+        std::vector<bool> kinds = ShapeKinds(count, shuffled);
+        shapes.reserve(count);
+        for (size_t index = 0; index < count; index++)
+        {
+            if (kinds[index])
+                shapes.emplace_back(std::in_place_type<Circle>, 1.0f, 1.0f, 5.0f);
+            else
+                shapes.emplace_back(std::in_place_type<Rectangle>, 1.0f, 1.0f, 5.0f, 10.0f);
+        }
+    }
+    state.SetItemsPerIteration(count);
+
+    while (state.KeepRunning())
+    {
+        float total = 0.0f;
+        for (const ShapeVariant& shape : shapes)
+        {
+            total += Area(shape);
+        }
+        DoNotOptimize(total);
+    }
+}
+
+// CompactShape: 16 bytes, the type in the last 4, Area() a branch on it
+static void DispatchCompact(BenchmarkState& state, bool shuffled)
+{
+    if (SkipIfTooBig(state))
+        return;
+
+    size_t count = (size_t)state.Argument();
+    std::vector<CompactShape> shapes(count);
+    {
+        std::vector<bool> kinds = ShapeKinds(count, shuffled);
+        for (size_t index = 0; index < count; index++)
+        {
+            if (kinds[index])
+                shapes[index] = CompactShape::MakeCircle(1.0f, 1.0f, 5.0f);
+            else
+                shapes[index] = CompactShape::MakeRectangle(1.0f, 1.0f, 5.0f, 10.0f);
+        }
+    }
+    state.SetItemsPerIteration(count);
+
+    while (state.KeepRunning())
+    {
+        float total = 0.0f;
+        for (const CompactShape& shape : shapes)
+        {
+            total += shape.Area();
+        }
+        DoNotOptimize(total);
+    }
+}
+
+static void PointerIntroDispatchVirtualSorted(BenchmarkState& state) { DispatchVirtual(state, false); }
+static void PointerIntroDispatchVirtualShuffled(BenchmarkState& state) { DispatchVirtual(state, true); }
+static void PointerIntroDispatchVariantSorted(BenchmarkState& state) { DispatchVariant(state, false); }
+static void PointerIntroDispatchVariantShuffled(BenchmarkState& state) { DispatchVariant(state, true); }
+static void PointerIntroDispatchCompactSorted(BenchmarkState& state) { DispatchCompact(state, false); }
+static void PointerIntroDispatchCompactShuffled(BenchmarkState& state) { DispatchCompact(state, true); }
+
+static void PointerIntroDispatchCrtp(BenchmarkState& state)
+{
+    if (SkipIfTooBig(state))
+        return;
+
+    size_t count = (size_t)state.Argument();
+    StaticShapeList shapes;
+    shapes.circles.assign(count / 2, StaticCircle(1.0f, 1.0f, 5.0f));
+    shapes.rectangles.assign(count - count / 2, StaticRectangle(1.0f, 1.0f, 5.0f, 10.0f));
+    state.SetItemsPerIteration(count);
+
+    while (state.KeepRunning())
+    {
+        float total = 0.0f;
+        shapes.ForEach([&total](const auto& shape) { total += shape.Area(); });
+        DoNotOptimize(total);
+    }
+}
+
+BENCHMARK(PointerIntroDispatchVirtualSorted)->Argument(1000)->Argument(1000000)->Argument(kHugeShapeCount);
+BENCHMARK(PointerIntroDispatchVirtualShuffled)->Argument(1000)->Argument(1000000)->Argument(kHugeShapeCount);
+BENCHMARK(PointerIntroDispatchVariantSorted)->Argument(1000)->Argument(1000000)->Argument(kHugeShapeCount);
+BENCHMARK(PointerIntroDispatchVariantShuffled)->Argument(1000)->Argument(1000000)->Argument(kHugeShapeCount);
+BENCHMARK(PointerIntroDispatchCompactSorted)->Argument(1000)->Argument(1000000)->Argument(kHugeShapeCount);
+BENCHMARK(PointerIntroDispatchCompactShuffled)->Argument(1000)->Argument(1000000)->Argument(kHugeShapeCount);
+BENCHMARK(PointerIntroDispatchCrtp)->Argument(1000)->Argument(1000000)->Argument(kHugeShapeCount);
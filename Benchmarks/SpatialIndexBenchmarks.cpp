@@ -0,0 +1,165 @@
+/// Review/Review05/SpatialIndex.h: drawing what's on screen out of a big world.
+///
+/// The argument is the number of shapes, spread evenly over a world 64 screens wide
+/// and 64 screens high, with the 800x600 screen in the middle of it - so roughly one
+/// shape in 4096 is visible. Drawing everything makes the rasterizer clip every
+/// off-screen shape; culling means only the visible ones reach Draw().
+#include "Benchmark.h"
+
+#include "ShapeStore.h"
+#include "SpatialIndex.h"
+#include "SoftwareBackend.h"
+
+#include <stdint.h>
+#include <vector>
+
+static const float kWorldWidth = 800.0f * 64.0f;
+static const float kWorldHeight = 600.0f * 64.0f;
+
+// The screen is the part of the world from (0, 0) to (800, 600), which is what the
+// SoftwareBackend draws, so the world is centered on it.
+static AABB World()
+{
+    return AABB(Vec2(-kWorldWidth * 0.5f, -kWorldHeight * 0.5f), Vec2(kWorldWidth * 0.5f, kWorldHeight * 0.5f));
+}
+
+static AABB Viewport()
+{
+    return AABB(Vec2(0.0f, 0.0f), Vec2(800.0f, 600.0f));
+}
+
+// A fixed sequence, so every run (and every benchmark) gets the same world
+static float NextRandom(uint32_t& state)
+{
+    state = state * 1664525u + 1013904223u;
+    return (float)(state >> 8) * (1.0f / 16777216.0f);
+}
+
+static void FillWorld(ShapeStore& store, size_t count)
+{
+    uint32_t random = 12345u;
+    store.Reserve(count / 2 + 1, count / 2 + 1);
+    for (size_t index = 0; index < count; index++)
+    {
+        float x = World().min.x + NextRandom(random) * kWorldWidth;
+        float y = World().min.y + NextRandom(random) * kWorldHeight;
+        if (index % 2 == 0)
+            store.AddCircle(x, y, 4.0f + NextRandom(random) * 12.0f);
+        else
+            store.AddRectangle(x, y, 8.0f + NextRandom(random) * 24.0f, 8.0f + NextRandom(random) * 24.0f);
+    }
+}
+
+// Drawing everything makes the backend clip every shape outside the screen, which is
+// exactly the work culling saves.
+static void WithWorldBackend(BenchmarkState& state, void (*benchmark)(BenchmarkState&, const ShapeStore&))
+{
+    ShapeStore store;
+    FillWorld(store, (size_t)state.Argument());
+
+    SoftwareBackend backend(800, 600);
+    SetRenderBackend(&backend);
+    benchmark(state, store);
+    SetRenderBackend(nullptr);
+    DoNotOptimize(backend.Pixels()[0]);
+}
+
+static void DrawAll(BenchmarkState& state, const ShapeStore& store)
+{
+    state.SetItemsPerIteration(store.Count());
+    while (state.KeepRunning())
+    {
+        store.Draw();
+    }
+}
+
+static void DrawBvhCulled(BenchmarkState& state, const ShapeStore& store)
+{
+    BoundingVolumeHierarchy bvh;
+    bvh.Build(store);
+
+    std::vector<ShapeId> visible;
+    state.SetItemsPerIteration(store.Count());
+    while (state.KeepRunning())
+    {
+        DoNotOptimize(DrawVisible(store, bvh, Viewport(), visible));
+    }
+}
+
+static void DrawGridCulled(BenchmarkState& state, const ShapeStore& store)
+{
+    UniformGrid grid(World(), 64.0f);
+    std::vector<ShapeId> ids;
+    std::vector<AABB> bounds;
+    store.CollectBounds(ids, bounds);
+    for (size_t index = 0; index < ids.size(); index++)
+    {
+        grid.Insert(ids[index], bounds[index]);
+    }
+
+    std::vector<ShapeId> visible;
+    state.SetItemsPerIteration(store.Count());
+    while (state.KeepRunning())
+    {
+        DoNotOptimize(DrawVisible(store, grid, Viewport(), visible));
+    }
+}
+
+static void SpatialDrawAll(BenchmarkState& state) { WithWorldBackend(state, DrawAll); }
+static void SpatialDrawBvhCulled(BenchmarkState& state) { WithWorldBackend(state, DrawBvhCulled); }
+static void SpatialDrawGridCulled(BenchmarkState& state) { WithWorldBackend(state, DrawGridCulled); }
+
+BENCHMARK(SpatialDrawAll)->Argument(10000)->Argument(1000000);
+BENCHMARK(SpatialDrawBvhCulled)->Argument(10000)->Argument(1000000);
+BENCHMARK(SpatialDrawGridCulled)->Argument(10000)->Argument(1000000);
+
+/// Building the BVH from scratch; one op is one shape.
+static void SpatialBvhBuild(BenchmarkState& state)
+{
+    ShapeStore store;
+    FillWorld(store, (size_t)state.Argument());
+
+    std::vector<ShapeId> ids;
+    std::vector<AABB> bounds;
+    store.CollectBounds(ids, bounds);
+
+    BoundingVolumeHierarchy bvh;
+    state.SetItemsPerIteration(ids.size());
+    while (state.KeepRunning())
+    {
+        bvh.Build(ids.data(), bounds.data(), ids.size());
+        DoNotOptimize(bvh.NodeCount());
+    }
+}
+BENCHMARK(SpatialBvhBuild)->Argument(10000)->Argument(1000000);
+
+/// Moving every shape in the grid a little, as a dynamic scene would each frame.
+/// Most stay in the same cells; one op is one Update().
+static void SpatialGridUpdate(BenchmarkState& state)
+{
+    ShapeStore store;
+    FillWorld(store, (size_t)state.Argument());
+
+    std::vector<ShapeId> ids;
+    std::vector<AABB> bounds;
+    store.CollectBounds(ids, bounds);
+
+    UniformGrid grid(World(), 64.0f);
+    for (size_t index = 0; index < ids.size(); index++)
+    {
+        grid.Insert(ids[index], bounds[index]);
+    }
+
+    float step = 1.0f;
+    state.SetItemsPerIteration(ids.size());
+    while (state.KeepRunning())
+    {
+        for (size_t index = 0; index < ids.size(); index++)
+        {
+            bounds[index] = AABB(bounds[index].min + Vec2(step, 0.0f), bounds[index].max + Vec2(step, 0.0f));
+            grid.Update(ids[index], bounds[index]);
+        }
+        step = -step;
+    }
+}
+BENCHMARK(SpatialGridUpdate)->Argument(10000)->Argument(1000000);
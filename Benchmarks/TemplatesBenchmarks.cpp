@@ -0,0 +1,182 @@
+/// Intermediate/Templates01: the Min/Max templates. One op is one comparison.
+#include "Benchmark.h"
+
+#include "MinMax.h"
+#include "MinMaxSimd.h"
+
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+static const size_t kValueCount = 4096;
+
+template<typename T>
+static std::vector<T> RandomValues()
+{
+    std::vector<T> values(kValueCount);
+    srand(1234);
+    for (size_t index = 0; index < kValueCount; index++)
+    {
+        values[index] = (T)(rand() % 10000);
+    }
+    return values;
+}
+
+template<typename T>
+static void MinOverValues(BenchmarkState& state)
+{
+    std::vector<T> values = RandomValues<T>();
+    state.SetItemsPerIteration(kValueCount - 1);
+
+    while (state.KeepRunning())
+    {
+        T result = values[0];
+        for (size_t index = 1; index < kValueCount; index++)
+        {
+            result = Min(result, values[index]);
+        }
+        DoNotOptimize(result);
+    }
+}
+
+template<typename T>
+static void MaxOverValues(BenchmarkState& state)
+{
+    std::vector<T> values = RandomValues<T>();
+    state.SetItemsPerIteration(kValueCount - 1);
+
+    while (state.KeepRunning())
+    {
+        T result = values[0];
+        for (size_t index = 1; index < kValueCount; index++)
+        {
+            result = Max(result, values[index]);
+        }
+        DoNotOptimize(result);
+    }
+}
+
+static void MinInt(BenchmarkState& state) { MinOverValues<int>(state); }
+static void MinFloat(BenchmarkState& state) { MinOverValues<float>(state); }
+static void MinDouble(BenchmarkState& state) { MinOverValues<double>(state); }
+static void MaxInt(BenchmarkState& state) { MaxOverValues<int>(state); }
+static void MaxFloat(BenchmarkState& state) { MaxOverValues<float>(state); }
+static void MaxDouble(BenchmarkState& state) { MaxOverValues<double>(state); }
+
+BENCHMARK(MinInt);
+BENCHMARK(MinFloat);
+BENCHMARK(MinDouble);
+BENCHMARK(MaxInt);
+BENCHMARK(MaxFloat);
+BENCHMARK(MaxDouble);
+
+// The original Min, which takes its arguments by value
+template<typename T>
+static T MinByValue(T valueA, T valueB)
+{
+    return valueA < valueB ? valueA : valueB;
+}
+
+// Every call copies both strings, and the result. 64 characters is too long for the
+// small string optimisation, so each copy is an allocation.
+static void MinStringByValue(BenchmarkState& state)
+{
+    std::string valueA(64, 'a');
+    std::string valueB(64, 'b');
+
+    while (state.KeepRunning())
+    {
+        DoNotOptimize(MinByValue(valueA, valueB));
+    }
+}
+BENCHMARK(MinStringByValue);
+
+// Min takes references and, given two lvalues, hands one back: no copies at all.
+static void MinString(BenchmarkState& state)
+{
+    std::string valueA(64, 'a');
+    std::string valueB(64, 'b');
+
+    while (state.KeepRunning())
+    {
+        DoNotOptimize(Min(valueA, valueB));
+    }
+}
+BENCHMARK(MinString);
+
+static void MinStringVariadic(BenchmarkState& state)
+{
+    std::string valueA(64, 'a');
+    std::string valueB(64, 'b');
+    std::string valueC(64, 'c');
+    std::string valueD(64, 'd');
+
+    while (state.KeepRunning())
+    {
+        DoNotOptimize(Min(valueD, valueC, valueB, valueA));
+    }
+}
+BENCHMARK(MinStringVariadic);
+
+// The array versions, once per instruction set: the argument is the SimdLevel
+// (0 = scalar, 1 = SSE2, 2 = AVX2).
+static bool UseSimdLevel(BenchmarkState& state)
+{
+    SimdLevel wanted = (SimdLevel)state.Argument();
+    if (SetSimdLevel(wanted) != wanted)
+    {
+        state.SkipWithMessage("not supported by this CPU");
+        SetSimdLevel(DetectSimdLevel());
+        return false;
+    }
+    return true;
+}
+
+template<typename T>
+static void SpanMinOverValues(BenchmarkState& state)
+{
+    if (!UseSimdLevel(state))
+        return;
+
+    std::vector<T> values = RandomValues<T>();
+    state.SetItemsPerIteration(kValueCount - 1);
+
+    while (state.KeepRunning())
+    {
+        DoNotOptimize(Min(Span<const T>(values)));
+    }
+
+    SetSimdLevel(DetectSimdLevel());
+}
+
+template<typename T>
+static void SpanElementwiseMin(BenchmarkState& state)
+{
+    if (!UseSimdLevel(state))
+        return;
+
+    std::vector<T> valuesA = RandomValues<T>();
+    std::vector<T> valuesB(valuesA.rbegin(), valuesA.rend());
+    std::vector<T> out(kValueCount);
+    state.SetItemsPerIteration(kValueCount);
+
+    while (state.KeepRunning())
+    {
+        Min(Span<const T>(valuesA), Span<const T>(valuesB), Span<T>(out));
+        ClobberMemory();
+    }
+
+    SetSimdLevel(DetectSimdLevel());
+}
+
+static void SpanMinInt32(BenchmarkState& state) { SpanMinOverValues<int32_t>(state); }
+static void SpanMinUInt8(BenchmarkState& state) { SpanMinOverValues<uint8_t>(state); }
+static void SpanMinFloat(BenchmarkState& state) { SpanMinOverValues<float>(state); }
+static void SpanMinDouble(BenchmarkState& state) { SpanMinOverValues<double>(state); }
+static void SpanElementwiseMinFloat(BenchmarkState& state) { SpanElementwiseMin<float>(state); }
+
+BENCHMARK(SpanMinInt32)->Argument(0)->Argument(1)->Argument(2);
+BENCHMARK(SpanMinUInt8)->Argument(0)->Argument(1)->Argument(2);
+BENCHMARK(SpanMinFloat)->Argument(0)->Argument(1)->Argument(2);
+BENCHMARK(SpanMinDouble)->Argument(0)->Argument(1)->Argument(2);
+BENCHMARK(SpanElementwiseMinFloat)->Argument(0)->Argument(1)->Argument(2);
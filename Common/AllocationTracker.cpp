@@ -0,0 +1,329 @@
+#include "AllocationTracker.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__GLIBC__) || defined(__APPLE__)
+#include <execinfo.h>
+#define ALLOCATION_TRACKER_BACKTRACE 1
+#endif
+
+/// ---------------------------------------------------------------------------------
+/// The counters. Everything in here is either an atomic or plain data that starts
+/// out zeroed, so it's all ready before the first `new` - even one that happens
+/// while some other file's statics are being built.
+/// ---------------------------------------------------------------------------------
+static std::atomic<uint64_t> gAllocations(0);
+static std::atomic<uint64_t> gFrees(0);
+static std::atomic<uint64_t> gAllocatedBytes(0);
+static std::atomic<uint64_t> gLiveBytes(0);
+static std::atomic<uint64_t> gPeakLiveBytes(0);
+static std::atomic<uint64_t> gSizeHistogram[kAllocationSizeBuckets];
+static std::atomic<uint32_t> gSampleInterval(1024);
+
+/// In front of every block. It's as big as malloc's alignment, so the memory after
+/// it is still aligned for anything.
+struct BlockHeader
+{
+    uint64_t size;
+    uint32_t sample;    ///< 1 + its index in gSamples, or 0 if it wasn't sampled
+    uint32_t unused;
+};
+static const size_t kHeaderSize = alignof(std::max_align_t) > sizeof(BlockHeader) ? alignof(std::max_align_t) : sizeof(BlockHeader);
+
+/// The live sampled allocations. A fixed table rather than a container, because a
+/// container would have to allocate - from inside operator new. When it's full,
+/// allocations just don't get sampled until some of these are freed.
+static const int kMaxSamples = 4096;
+static const int kMaxFrames = 16;
+
+struct Sample
+{
+    const void* memory;     ///< nullptr if the slot is free
+    uint64_t    size;
+    void*       frames[kMaxFrames];
+    int         frameCount;
+};
+
+static std::mutex gSamplesMutex;
+static Sample     gSamples[kMaxSamples];
+static uint64_t   gDroppedSamples;    ///< Allocations that found the table full, ever
+
+static int SizeBucket(size_t size)
+{
+    int bucket = 0;
+    for (size_t limit = 16; size > limit && bucket < kAllocationSizeBuckets - 1; limit *= 2)
+    {
+        bucket++;
+    }
+    return bucket;
+}
+
+#if defined(_MSC_VER)
+#define ALLOCATION_TRACKER_NOINLINE __declspec(noinline)
+#else
+#define ALLOCATION_TRACKER_NOINLINE __attribute__((noinline))
+#endif
+
+// Returns 1 + the slot it went into, or 0 if there wasn't one. The stack is captured
+// before taking the lock, since that's the slow part. It's never inlined, so the
+// first frame of the stack is always this function, and can be dropped; the next is
+// operator new.
+static ALLOCATION_TRACKER_NOINLINE uint32_t RecordSample(const void* memory, size_t size)
+{
+    void* frames[kMaxFrames + 1];
+#if defined(_WIN32)
+    int frameCount = (int)CaptureStackBackTrace(0, (DWORD)(kMaxFrames + 1), frames, nullptr);
+#elif defined(ALLOCATION_TRACKER_BACKTRACE)
+    int frameCount = backtrace(frames, kMaxFrames + 1);
+#else
+    int frameCount = 0;
+#endif
+    int skipped = frameCount > 0 ? 1 : 0;
+
+    std::lock_guard<std::mutex> lock(gSamplesMutex);
+    for (int index = 0; index < kMaxSamples; index++)
+    {
+        Sample& sample = gSamples[index];
+        if (sample.memory != nullptr)
+            continue;
+
+        sample.memory = memory;
+        sample.size = size;
+        sample.frameCount = frameCount - skipped;
+        for (int frame = 0; frame < sample.frameCount; frame++)
+        {
+            sample.frames[frame] = frames[frame + skipped];
+        }
+        return (uint32_t)index + 1;
+    }
+
+    gDroppedSamples++;
+    return 0;
+}
+
+static void* TrackedAllocate(size_t size)
+{
+    // Adding the header to a size this close to the top would wrap around, and we'd
+    // hand back a tiny block to somebody who asked for a huge one
+    if (size > SIZE_MAX - kHeaderSize)
+        throw std::bad_alloc();
+
+    // What every operator new has to do when there's no memory: call the new handler
+    // (which may free some) and try again, until there isn't one
+    void* block = malloc(kHeaderSize + size);
+    while (block == nullptr)
+    {
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr)
+            throw std::bad_alloc();
+
+        handler();
+        block = malloc(kHeaderSize + size);
+    }
+
+    uint64_t count = gAllocations.fetch_add(1, std::memory_order_relaxed) + 1;
+    gAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    gSizeHistogram[SizeBucket(size)].fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t live = gLiveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    uint64_t peak = gPeakLiveBytes.load(std::memory_order_relaxed);
+    while (live > peak && !gPeakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+    {
+    }
+
+    void* memory = static_cast<char*>(block) + kHeaderSize;
+    BlockHeader* header = static_cast<BlockHeader*>(block);
+    header->size = size;
+    header->sample = 0;
+
+    uint32_t interval = gSampleInterval.load(std::memory_order_relaxed);
+    if (interval != 0 && count % interval == 0)
+    {
+        header->sample = RecordSample(memory, size);
+    }
+
+    return memory;
+}
+
+static void TrackedFree(void* memory)
+{
+    if (memory == nullptr)
+        return;
+
+    void* block = static_cast<char*>(memory) - kHeaderSize;
+    BlockHeader* header = static_cast<BlockHeader*>(block);
+
+    gFrees.fetch_add(1, std::memory_order_relaxed);
+    gLiveBytes.fetch_sub(header->size, std::memory_order_relaxed);
+
+    if (header->sample != 0)
+    {
+        std::lock_guard<std::mutex> lock(gSamplesMutex);
+        gSamples[header->sample - 1].memory = nullptr;
+    }
+
+    free(block);
+}
+
+/// ---------------------------------------------------------------------------------
+/// The replacements. The nothrow versions are the runtime's, which call these.
+/// ---------------------------------------------------------------------------------
+void* operator new(size_t size)
+{
+    return TrackedAllocate(size);
+}
+
+void* operator new[](size_t size)
+{
+    return TrackedAllocate(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    TrackedFree(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    TrackedFree(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    TrackedFree(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+    TrackedFree(memory);
+}
+
+/// ---------------------------------------------------------------------------------
+/// Reading the counters
+/// ---------------------------------------------------------------------------------
+AllocationStats GetAllocationStats()
+{
+    AllocationStats stats;
+    stats.allocations = gAllocations.load(std::memory_order_relaxed);
+    stats.frees = gFrees.load(std::memory_order_relaxed);
+    stats.allocatedBytes = gAllocatedBytes.load(std::memory_order_relaxed);
+    stats.liveBytes = gLiveBytes.load(std::memory_order_relaxed);
+    stats.peakLiveBytes = gPeakLiveBytes.load(std::memory_order_relaxed);
+    for (int bucket = 0; bucket < kAllocationSizeBuckets; bucket++)
+    {
+        stats.sizeHistogram[bucket] = gSizeHistogram[bucket].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+uint64_t TotalAllocationCount()
+{
+    return gAllocations.load(std::memory_order_relaxed);
+}
+
+uint64_t TotalAllocatedBytes()
+{
+    return gAllocatedBytes.load(std::memory_order_relaxed);
+}
+
+void SetAllocationSampleInterval(uint32_t interval)
+{
+    gSampleInterval.store(interval, std::memory_order_relaxed);
+}
+
+static void PrintStack(FILE* out, void* const* frames, int frameCount)
+{
+#if defined(ALLOCATION_TRACKER_BACKTRACE)
+    // Straight to the file descriptor: backtrace_symbols() would need to malloc
+    fflush(out);
+    backtrace_symbols_fd(frames, frameCount, fileno(out));
+#else
+    for (int frame = 0; frame < frameCount; frame++)
+    {
+        fprintf(out, "        %p\n", frames[frame]);
+    }
+#endif
+}
+
+void PrintAllocationReport(FILE* out)
+{
+    AllocationStats stats = GetAllocationStats();
+
+    fprintf(out, "Allocations: %llu (%llu bytes), frees: %llu\n",
+            (unsigned long long)stats.allocations, (unsigned long long)stats.allocatedBytes, (unsigned long long)stats.frees);
+    fprintf(out, "Still allocated: %llu (%llu bytes), at most %llu bytes at once\n",
+            (unsigned long long)stats.LiveAllocations(), (unsigned long long)stats.liveBytes, (unsigned long long)stats.peakLiveBytes);
+
+    fprintf(out, "Sizes:\n");
+    for (int bucket = 0; bucket < kAllocationSizeBuckets; bucket++)
+    {
+        if (stats.sizeHistogram[bucket] == 0)
+            continue;
+
+        if (bucket == kAllocationSizeBuckets - 1)
+            fprintf(out, "    > %8llu bytes: %llu\n", 16ull << (bucket - 1), (unsigned long long)stats.sizeHistogram[bucket]);
+        else
+            fprintf(out, "    <= %7llu bytes: %llu\n", 16ull << bucket, (unsigned long long)stats.sizeHistogram[bucket]);
+    }
+
+    // Copied out first, so nothing's printed (and nothing allocates) with the lock held
+    static Sample live[kMaxSamples];
+    int liveCount = 0;
+    uint64_t dropped;
+    {
+        std::lock_guard<std::mutex> lock(gSamplesMutex);
+        for (int index = 0; index < kMaxSamples; index++)
+        {
+            if (gSamples[index].memory != nullptr)
+                live[liveCount++] = gSamples[index];
+        }
+        dropped = gDroppedSamples;
+    }
+
+    if (liveCount > 0)
+    {
+        fprintf(out, "Sampled allocations still alive:\n");
+        for (int index = 0; index < liveCount; index++)
+        {
+            fprintf(out, "    %llu bytes at %p, from:\n", (unsigned long long)live[index].size, live[index].memory);
+            PrintStack(out, live[index].frames, live[index].frameCount);
+        }
+    }
+
+    // Counted since the program started: most of them have probably been freed since
+    if (dropped > 0)
+        fprintf(out, "%llu allocations were never sampled: the table was full when they were made\n", (unsigned long long)dropped);
+}
+
+static void PrintLeakReport()
+{
+    AllocationStats stats = GetAllocationStats();
+    if (stats.LiveAllocations() == 0)
+    {
+        printf("No leaks: all %llu allocations were freed\n", (unsigned long long)stats.allocations);
+        return;
+    }
+
+    printf("Leaks: %llu allocations (%llu bytes) were never freed\n",
+           (unsigned long long)stats.LiveAllocations(), (unsigned long long)stats.liveBytes);
+    PrintAllocationReport(stdout);
+}
+
+void ReportLeaksAtExit()
+{
+    static bool registered = false;
+    if (!registered)
+    {
+        registered = true;
+        atexit(PrintLeakReport);
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+/// ---------------------------------------------------------------------------------
+/// Watching what the program does with the heap.
+///
+/// AllocationTracker.cpp replaces the global operator new and delete (the plain,
+/// array and sized versions; the runtime's nothrow versions call those), so linking
+/// it into a program is all it takes for every `new` to be counted: how many, how many bytes, how big they tend to be,
+/// and how much is in use at once. It's a handful of relaxed atomic adds per call,
+/// cheap enough to leave on in the benchmarks.
+///
+/// Each block gets a small header in front of it, holding its size, which is how
+/// `delete` knows how many bytes just went back.
+///
+/// On top of that, one allocation in every SampleInterval also records the call
+/// stack it came from, for as long as it's alive. That's what makes a leak report
+/// useful: not just "24 bytes were never freed", but where they came from. Capturing
+/// a stack costs microseconds, which is why it's only done for a sample. Set the
+/// interval to 1 to record every allocation (fine for a small program like
+/// PointerIntro), or 0 for none at all.
+///
+/// Things it can't see: malloc()/free(), which don't go through operator new, and
+/// anything handed out by a class's own operator new, like the pools in
+/// PointerIntro's PoolAllocator.h (only the big chunks the pool gets from the heap
+/// show up). Aligned `new` of over-aligned types also goes straight to the runtime.
+///
+/// The stacks are printed as raw addresses. On Linux and macOS, they're turned into
+/// function names where possible (link with -rdynamic to get more of them); on
+/// Windows, look them up in the debugger or with the .pdb.
+/// ---------------------------------------------------------------------------------
+
+const int kAllocationSizeBuckets = 16;
+
+struct AllocationStats
+{
+    uint64_t allocations;       ///< Calls to operator new since the program started
+    uint64_t frees;
+    uint64_t allocatedBytes;    ///< Everything ever asked for, freed or not
+    uint64_t liveBytes;         ///< Allocated and not freed yet
+    uint64_t peakLiveBytes;     ///< The most liveBytes has ever been
+
+    /// How many allocations of each size: [0] is up to 16 bytes, [1] up to 32, [2] up
+    /// to 64 and so on, doubling each time; the last one is everything bigger.
+    uint64_t sizeHistogram[kAllocationSizeBuckets];
+
+    uint64_t LiveAllocations() const { return allocations - frees; }
+};
+
+AllocationStats GetAllocationStats();
+
+/// Running totals since the program started, for a benchmark harness to take the
+/// difference of before and after.
+uint64_t TotalAllocationCount();
+uint64_t TotalAllocatedBytes();
+
+/// Record the call stack of one allocation in every `interval` (0 means never). The
+/// default is 1024.
+void SetAllocationSampleInterval(uint32_t interval);
+
+/// The stats, the size histogram, and where each sampled allocation that's still
+/// alive came from.
+void PrintAllocationReport(FILE* out);
+
+/// Prints a report of whatever hasn't been freed when the program exits. Call it
+/// early in main(): anything static that's built before the call is still alive
+/// when the report is printed, and would look like a leak.
+void ReportLeaksAtExit();
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <stddef.h>
+
+/// The size of a cache line on every x86 and most ARM CPUs. Memory moves between RAM
+/// and the caches in lines this big, so it's the unit that decides what a loop over
+/// an array really costs. It matters between threads too: two variables written by
+/// different threads should be at least this far apart, or each write slows the
+/// other thread down ('false sharing': they'd be in the same line, which has to move
+/// between the cores every time).
+const size_t kCacheLineSize = 64;
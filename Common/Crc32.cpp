@@ -0,0 +1,61 @@
+#include "Crc32.h"
+
+/// tables[0] is the usual byte-at-a-time table. tables[n][byte] is the CRC of `byte`
+/// followed by n zero bytes, which lets eight table lookups, one per byte, handle
+/// eight bytes at once.
+struct Crc32Tables
+{
+    uint32_t tables[8][256];
+
+    Crc32Tables()
+    {
+        for (uint32_t index = 0; index < 256; index++)
+        {
+            uint32_t value = index;
+            for (int bit = 0; bit < 8; bit++)
+                value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+            tables[0][index] = value;
+        }
+
+        for (uint32_t index = 0; index < 256; index++)
+        {
+            for (int slice = 1; slice < 8; slice++)
+            {
+                uint32_t previous = tables[slice - 1][index];
+                tables[slice][index] = tables[0][previous & 0xFF] ^ (previous >> 8);
+            }
+        }
+    }
+};
+
+// Built the first time it's needed; C++11 makes that thread safe
+static const Crc32Tables& GetCrc32Tables()
+{
+    static const Crc32Tables tables;
+    return tables;
+}
+
+uint32_t Crc32(uint32_t crc, const void* data, size_t size)
+{
+    const uint32_t (*table)[256] = GetCrc32Tables().tables;
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+
+    crc = ~crc;
+    while (size >= 8)
+    {
+        // Read byte by byte, so it doesn't matter which way round the CPU stores words
+        uint32_t low = crc ^ ((uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24));
+        crc = table[7][low & 0xFF] ^ table[6][(low >> 8) & 0xFF] ^ table[5][(low >> 16) & 0xFF] ^ table[4][low >> 24] ^
+              table[3][bytes[4]] ^ table[2][bytes[5]] ^ table[1][bytes[6]] ^ table[0][bytes[7]];
+        bytes += 8;
+        size -= 8;
+    }
+
+    while (size > 0)
+    {
+        crc = table[0][(crc ^ *bytes) & 0xFF] ^ (crc >> 8);
+        bytes++;
+        size--;
+    }
+    return ~crc;
+}
@@ -0,0 +1,334 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "CacheLine.h"
+
+/// ---------------------------------------------------------------------------------
+/// Fixed size queues for handing things from one thread to another, without locks.
+///
+/// With a mutex around a std::deque, a thread that's pushing while another is popping
+/// has to wait for it - and if the thread holding the lock gets descheduled, everyone
+/// waits for the scheduler too. These are rings of slots instead: a push writes a
+/// slot and then moves the tail on, a pop reads a slot and moves the head on, and
+/// the two sides only meet through those two atomic counters. Neither ever waits for
+/// the other. A push into a full queue, or a pop from an empty one, just returns
+/// false, and it's up to the caller what to do about it (try again, drop it, or get
+/// on with something else).
+///
+/// SpscQueue is for exactly one thread pushing and one popping. MpscQueue lets any
+/// number of threads push (still one popping); each push is a compare-and-swap on
+/// the tail, so it costs a bit more. Items from any one thread come out in the order
+/// that thread pushed them.
+///
+/// The capacity is rounded up to a power of two. How big to make it is a trade-off:
+/// too small and producers keep finding it full; too big and it's memory (and
+/// latency, if it fills up) for nothing. Stats() counts exactly that: how often a
+/// push found it full, and the deepest it's been.
+///
+/// Trying again straight away, in a loop, keeps a whole core busy doing nothing -
+/// and on a machine with few cores, it's the core the other thread needed to get on
+/// with it. A thread that has to wait should sleep on a Wakeup instead.
+/// ---------------------------------------------------------------------------------
+
+struct QueueStats
+{
+    uint64_t pushed;        ///< Items that have gone in
+    uint64_t fullStalls;    ///< TryPush() calls that found the queue full
+    uint64_t emptyPolls;    ///< TryPop() calls that found it empty
+    size_t   maxDepth;      ///< The most items ever waiting at once (as TryPop saw it)
+};
+
+inline size_t RoundUpQueueCapacity(size_t capacity)
+{
+    size_t rounded = 2;
+    while (rounded < capacity)
+    {
+        rounded *= 2;
+    }
+    return rounded;
+}
+
+template<typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(size_t capacity)
+        : mHead(0)
+        , mCachedTail(0)
+        , mEmptyPolls(0)
+        , mMaxDepth(0)
+        , mTail(0)
+        , mCachedHead(0)
+        , mFullStalls(0)
+        , mMask(RoundUpQueueCapacity(capacity) - 1)
+        , mItems(mMask + 1)
+    {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    size_t Capacity() const { return mMask + 1; }
+
+    /// The producer thread only.
+    bool TryPush(const T& item)
+    {
+        // The producer's copy of the head is only refreshed when the queue looks full,
+        // so most pushes don't touch the consumer's cache line at all.
+        const size_t tail = mTail.load(std::memory_order_relaxed);
+        if (tail - mCachedHead > mMask)
+        {
+            mCachedHead = mHead.load(std::memory_order_acquire);
+            if (tail - mCachedHead > mMask)
+            {
+                mFullStalls.store(mFullStalls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+
+        mItems[tail & mMask] = item;
+        mTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// The consumer thread only.
+    bool TryPop(T& item)
+    {
+        const size_t head = mHead.load(std::memory_order_relaxed);
+        if (head == mCachedTail)
+        {
+            mCachedTail = mTail.load(std::memory_order_acquire);
+            if (head == mCachedTail)
+            {
+                mEmptyPolls.store(mEmptyPolls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+
+        const size_t depth = mCachedTail - head;
+        if (depth > mMaxDepth.load(std::memory_order_relaxed))
+            mMaxDepth.store(depth, std::memory_order_relaxed);
+
+        item = mItems[head & mMask];
+        mHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Items waiting right now. From any thread, but by the time it returns it may
+    /// already be out of date.
+    size_t Depth() const
+    {
+        const size_t head = mHead.load(std::memory_order_acquire);
+        return mTail.load(std::memory_order_acquire) - head;
+    }
+
+    QueueStats Stats() const
+    {
+        QueueStats stats;
+        stats.pushed = mTail.load(std::memory_order_relaxed);
+        stats.fullStalls = mFullStalls.load(std::memory_order_relaxed);
+        stats.emptyPolls = mEmptyPolls.load(std::memory_order_relaxed);
+        stats.maxDepth = mMaxDepth.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    // The consumer's side, the producer's side, and the ring, each in its own cache
+    // line(s). The counters only ever have one writer, so they're plain loads and
+    // stores rather than read-modify-writes.
+    alignas(kCacheLineSize) std::atomic<size_t> mHead;
+    size_t                mCachedTail;
+    std::atomic<uint64_t> mEmptyPolls;
+    std::atomic<size_t>   mMaxDepth;
+
+    alignas(kCacheLineSize) std::atomic<size_t> mTail;
+    size_t                mCachedHead;
+    std::atomic<uint64_t> mFullStalls;
+
+    alignas(kCacheLineSize) const size_t mMask;
+    std::vector<T>        mItems;
+};
+
+/// Dmitry Vyukov's bounded queue. Every slot has a sequence number saying whose turn
+/// it is: a producer claims slot `tail` by moving the tail on with a compare-and-swap,
+/// fills it, and then sets its sequence to tail + 1, which tells the consumer it's
+/// ready. Popping it sets the sequence to tail + capacity, ready for the producer
+/// that comes round to it next time.
+///
+/// A producer that's descheduled between claiming its slot and filling it holds up
+/// the consumer (TryPop() says empty until it's done) - but not the other producers.
+template<typename T>
+class MpscQueue
+{
+public:
+    explicit MpscQueue(size_t capacity)
+        : mHead(0)
+        , mEmptyPolls(0)
+        , mMaxDepth(0)
+        , mTail(0)
+        , mFullStalls(0)
+        , mMask(RoundUpQueueCapacity(capacity) - 1)
+        , mCells(new Cell[mMask + 1])
+    {
+        for (size_t index = 0; index <= mMask; index++)
+        {
+            mCells[index].sequence.store(index, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    size_t Capacity() const { return mMask + 1; }
+
+    /// Any thread.
+    bool TryPush(const T& item)
+    {
+        size_t tail = mTail.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Cell& cell = mCells[tail & mMask];
+            const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const ptrdiff_t lead = (ptrdiff_t)(sequence - tail);
+
+            if (lead == 0)
+            {
+                // Our turn, if nobody else claims it first (which reloads `tail`)
+                if (mTail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed))
+                {
+                    cell.item = item;
+                    cell.sequence.store(tail + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (lead < 0)
+            {
+                // Still holding what was pushed a lap ago: full
+                mFullStalls.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+            {
+                // Another producer got this one; try the next
+                tail = mTail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// The consumer thread only.
+    bool TryPop(T& item)
+    {
+        const size_t head = mHead.load(std::memory_order_relaxed);
+        Cell& cell = mCells[head & mMask];
+        if (cell.sequence.load(std::memory_order_acquire) != head + 1)
+        {
+            mEmptyPolls.store(mEmptyPolls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        const size_t depth = mTail.load(std::memory_order_relaxed) - head;
+        if (depth > mMaxDepth.load(std::memory_order_relaxed))
+            mMaxDepth.store(depth, std::memory_order_relaxed);
+
+        item = cell.item;
+        cell.sequence.store(head + mMask + 1, std::memory_order_release);
+        mHead.store(head + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /// Items claimed but not popped yet (including any still being written). From any
+    /// thread, but it may be out of date by the time it returns.
+    size_t Depth() const
+    {
+        const size_t head = mHead.load(std::memory_order_relaxed);
+        const size_t tail = mTail.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    QueueStats Stats() const
+    {
+        QueueStats stats;
+        stats.pushed = mTail.load(std::memory_order_relaxed);
+        stats.fullStalls = mFullStalls.load(std::memory_order_relaxed);
+        stats.emptyPolls = mEmptyPolls.load(std::memory_order_relaxed);
+        stats.maxDepth = mMaxDepth.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T                   item;
+    };
+
+    alignas(kCacheLineSize) std::atomic<size_t> mHead;
+    std::atomic<uint64_t> mEmptyPolls;
+    std::atomic<size_t>   mMaxDepth;
+
+    alignas(kCacheLineSize) std::atomic<size_t> mTail;
+    std::atomic<uint64_t> mFullStalls;
+
+    alignas(kCacheLineSize) const size_t mMask;
+    std::unique_ptr<Cell[]> mCells;
+};
+
+/// Lets a thread sleep until another one has something for it: a consumer whose
+/// queue is empty, say, or a producer whose queue is full. The thread with news calls
+/// Notify(), which is an atomic increment - it only takes the lock (to wake somebody)
+/// when somebody's actually asleep.
+///
+/// Take Prepare()'s value *before* checking for work, and pass it to Wait(). Then a
+/// Notify() between the check and the Wait() isn't lost: Wait() sees the count has
+/// moved on, and returns straight away.
+///
+///     uint64_t seen = wakeup.Prepare();
+///     if (!queue.TryPop(item))
+///         wakeup.Wait(seen);
+class Wakeup
+{
+public:
+    Wakeup()
+        : mCount(0)
+        , mSleepers(0)
+    {}
+
+    Wakeup(const Wakeup&) = delete;
+    Wakeup& operator=(const Wakeup&) = delete;
+
+    uint64_t Prepare() const { return mCount.load(); }
+
+    /// Sleeps until there's been a Notify() since Prepare() returned `seen`.
+    void Wait(uint64_t seen)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mSleepers.fetch_add(1);
+        mCondition.wait(lock, [this, seen]() { return mCount.load() != seen; });
+        mSleepers.fetch_sub(1);
+    }
+
+    void Notify()
+    {
+        // Both sequentially consistent: either the sleeper's Wait() sees the new
+        // count, or this sees the sleeper (and it's holding the lock until it's
+        // really asleep, so the notify can't come too early).
+        mCount.fetch_add(1);
+        if (mSleepers.load() != 0)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mCondition.notify_all();
+        }
+    }
+
+private:
+    std::atomic<uint64_t>   mCount;
+    std::atomic<int>        mSleepers;
+    std::mutex              mMutex;
+    std::condition_variable mCondition;
+};
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <math.h>
+#include <type_traits>
+
+/// ---------------------------------------------------------------------------------
+/// The 2D math types every project had its own copy of: Point2D (PointerIntro,
+/// Review04, Review05, Review05B), RGB and RGBA (Review04), and Review04's
+/// Transform2D - now with operators.
+///
+/// Everything is a plain struct of floats with no virtuals and no padding, so it's
+/// exactly the same size and layout as the structs it replaces: a shape's mCenter, or
+/// a Vertex's position, doesn't move by a byte (the static_asserts at the bottom make
+/// sure of it). They're also trivially copyable, so arrays of them can be memcpy'd,
+/// written to files, and handed to SIMD code - see Math2DBatch.h for that.
+///
+/// The operators are constexpr, so things like
+///
+///     constexpr Affine2D kToScreen = Affine2D::Translation(Vec2(400.0f, 300.0f)) * Affine2D::Scale(2.0f, 2.0f);
+///
+/// cost nothing at runtime. (They're written as single return statements, C++11
+/// style, so Visual Studio 2015 is happy with them too. The compound assignments
+/// aren't constexpr for the same reason.)
+/// ---------------------------------------------------------------------------------
+
+struct Vec2
+{
+    float x;
+    float y;
+
+    constexpr Vec2() : x(0.0f), y(0.0f) {}
+    constexpr Vec2(float inX, float inY) : x(inX), y(inY) {}
+
+    Vec2& operator+=(Vec2 other) { x += other.x; y += other.y; return *this; }
+    Vec2& operator-=(Vec2 other) { x -= other.x; y -= other.y; return *this; }
+    Vec2& operator*=(float scale) { x *= scale; y *= scale; return *this; }
+    Vec2& operator/=(float scale) { x /= scale; y /= scale; return *this; }
+};
+
+/// A point and a vector are the same two floats; the two names just say which one you
+/// mean.
+typedef Vec2 Point2D;
+
+constexpr Vec2 operator+(Vec2 a, Vec2 b) { return Vec2(a.x + b.x, a.y + b.y); }
+constexpr Vec2 operator-(Vec2 a, Vec2 b) { return Vec2(a.x - b.x, a.y - b.y); }
+constexpr Vec2 operator-(Vec2 a) { return Vec2(-a.x, -a.y); }
+constexpr Vec2 operator*(Vec2 a, float scale) { return Vec2(a.x * scale, a.y * scale); }
+constexpr Vec2 operator*(float scale, Vec2 a) { return Vec2(a.x * scale, a.y * scale); }
+constexpr Vec2 operator/(Vec2 a, float scale) { return Vec2(a.x / scale, a.y / scale); }
+
+/// Component by component
+constexpr Vec2 operator*(Vec2 a, Vec2 b) { return Vec2(a.x * b.x, a.y * b.y); }
+
+constexpr bool operator==(Vec2 a, Vec2 b) { return a.x == b.x && a.y == b.y; }
+constexpr bool operator!=(Vec2 a, Vec2 b) { return !(a == b); }
+
+constexpr float Dot(Vec2 a, Vec2 b) { return a.x * b.x + a.y * b.y; }
+
+/// The z of the 3D cross product: positive when `b` is anticlockwise from `a` (in a
+/// y-up world; clockwise on screen, where y goes down).
+constexpr float Cross(Vec2 a, Vec2 b) { return a.x * b.y - a.y * b.x; }
+
+constexpr float LengthSquared(Vec2 a) { return Dot(a, a); }
+inline float Length(Vec2 a) { return sqrtf(LengthSquared(a)); }
+
+/// Zero stays zero.
+inline Vec2 Normalize(Vec2 a)
+{
+    float length = Length(a);
+    return length > 0.0f ? a / length : a;
+}
+
+/// a at t = 0, b at t = 1
+constexpr Vec2 Lerp(Vec2 a, Vec2 b, float t) { return Vec2(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t); }
+
+/// ---------------------------------------------------------------------------------
+/// Colors, as floats from 0 to 1
+/// ---------------------------------------------------------------------------------
+struct RGB
+{
+    float r;
+    float g;
+    float b;
+
+    constexpr RGB() : r(0.0f), g(0.0f), b(0.0f) {}
+    constexpr RGB(float inR, float inG, float inB) : r(inR), g(inG), b(inB) {}
+};
+
+constexpr RGB operator+(RGB a, RGB b) { return RGB(a.r + b.r, a.g + b.g, a.b + b.b); }
+constexpr RGB operator-(RGB a, RGB b) { return RGB(a.r - b.r, a.g - b.g, a.b - b.b); }
+constexpr RGB operator*(RGB a, float scale) { return RGB(a.r * scale, a.g * scale, a.b * scale); }
+constexpr RGB operator*(float scale, RGB a) { return a * scale; }
+
+/// Modulate: channel by channel, the way a texture tints a vertex color
+constexpr RGB operator*(RGB a, RGB b) { return RGB(a.r * b.r, a.g * b.g, a.b * b.b); }
+
+constexpr bool operator==(RGB a, RGB b) { return a.r == b.r && a.g == b.g && a.b == b.b; }
+constexpr bool operator!=(RGB a, RGB b) { return !(a == b); }
+
+constexpr RGB Lerp(RGB a, RGB b, float t) { return a + (b - a) * t; }
+
+struct RGBA
+{
+    float r;
+    float g;
+    float b;
+    float a;
+
+    constexpr RGBA() : r(0.0f), g(0.0f), b(0.0f), a(0.0f) {}
+    constexpr RGBA(float inR, float inG, float inB, float inA) : r(inR), g(inG), b(inB), a(inA) {}
+    constexpr RGBA(RGB color, float inA) : r(color.r), g(color.g), b(color.b), a(inA) {}
+
+    constexpr RGB Color() const { return RGB(r, g, b); }
+};
+
+constexpr RGBA operator+(RGBA a, RGBA b) { return RGBA(a.r + b.r, a.g + b.g, a.b + b.b, a.a + b.a); }
+constexpr RGBA operator-(RGBA a, RGBA b) { return RGBA(a.r - b.r, a.g - b.g, a.b - b.b, a.a - b.a); }
+constexpr RGBA operator*(RGBA a, float scale) { return RGBA(a.r * scale, a.g * scale, a.b * scale, a.a * scale); }
+constexpr RGBA operator*(float scale, RGBA a) { return a * scale; }
+constexpr RGBA operator*(RGBA a, RGBA b) { return RGBA(a.r * b.r, a.g * b.g, a.b * b.b, a.a * b.a); }
+
+constexpr bool operator==(RGBA a, RGBA b) { return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a; }
+constexpr bool operator!=(RGBA a, RGBA b) { return !(a == b); }
+
+constexpr RGBA Lerp(RGBA a, RGBA b, float t) { return a + (b - a) * t; }
+
+/// ---------------------------------------------------------------------------------
+/// A 2x3 affine transform: a 2x2 matrix (rotation, scale, shear) plus a translation.
+///
+///     x' = m00 * x + m01 * y + tx
+///     y' = m10 * x + m11 * y + ty
+///
+/// `a * b` is 'b, then a', like matrices: (a * b) * p == a * (b * p).
+/// ---------------------------------------------------------------------------------
+struct Affine2D
+{
+    float m00, m01;
+    float m10, m11;
+    float tx, ty;
+
+    constexpr Affine2D() : m00(1.0f), m01(0.0f), m10(0.0f), m11(1.0f), tx(0.0f), ty(0.0f) {}
+    constexpr Affine2D(float inM00, float inM01, float inM10, float inM11, float inTx, float inTy)
+        : m00(inM00), m01(inM01), m10(inM10), m11(inM11), tx(inTx), ty(inTy) {}
+
+    static constexpr Affine2D Identity() { return Affine2D(); }
+    static constexpr Affine2D Translation(Vec2 offset) { return Affine2D(1.0f, 0.0f, 0.0f, 1.0f, offset.x, offset.y); }
+    static constexpr Affine2D Scale(float sx, float sy) { return Affine2D(sx, 0.0f, 0.0f, sy, 0.0f, 0.0f); }
+
+    /// Anticlockwise in a y-up world (clockwise on screen)
+    static Affine2D Rotation(float radians)
+    {
+        float c = cosf(radians);
+        float s = sinf(radians);
+        return Affine2D(c, -s, s, c, 0.0f, 0.0f);
+    }
+
+    constexpr Vec2 Offset() const { return Vec2(tx, ty); }
+    constexpr float Determinant() const { return m00 * m11 - m01 * m10; }
+
+    /// Transforms a direction: the matrix part only, no translation.
+    constexpr Vec2 TransformVector(Vec2 v) const { return Vec2(m00 * v.x + m01 * v.y, m10 * v.x + m11 * v.y); }
+
+    /// Only meaningful when Determinant() isn't 0.
+    constexpr Affine2D Inverse() const
+    {
+        return Affine2D(m11 / Determinant(), -m01 / Determinant(),
+                        -m10 / Determinant(), m00 / Determinant(),
+                        (m01 * ty - m11 * tx) / Determinant(), (m10 * tx - m00 * ty) / Determinant());
+    }
+};
+
+constexpr Vec2 operator*(const Affine2D& transform, Vec2 point)
+{
+    return Vec2(transform.m00 * point.x + transform.m01 * point.y + transform.tx,
+                transform.m10 * point.x + transform.m11 * point.y + transform.ty);
+}
+
+constexpr Affine2D operator*(const Affine2D& a, const Affine2D& b)
+{
+    return Affine2D(a.m00 * b.m00 + a.m01 * b.m10, a.m00 * b.m01 + a.m01 * b.m11,
+                    a.m10 * b.m00 + a.m11 * b.m10, a.m10 * b.m01 + a.m11 * b.m11,
+                    a.m00 * b.tx + a.m01 * b.ty + a.tx, a.m10 * b.tx + a.m11 * b.ty + a.ty);
+}
+
+/// Layout: the same as the plain structs these replace, and safe to memcpy.
+static_assert(sizeof(Vec2) == 2 * sizeof(float) && alignof(Vec2) == alignof(float), "Vec2 should be two floats");
+static_assert(sizeof(RGB) == 3 * sizeof(float), "RGB should be three floats");
+static_assert(sizeof(RGBA) == 4 * sizeof(float), "RGBA should be four floats");
+static_assert(sizeof(Affine2D) == 6 * sizeof(float), "Affine2D should be six floats");
+static_assert(std::is_standard_layout<Vec2>::value && std::is_trivially_copyable<Vec2>::value, "Vec2 should be a plain struct");
+static_assert(std::is_standard_layout<RGBA>::value && std::is_trivially_copyable<RGBA>::value, "RGBA should be a plain struct");
+static_assert(std::is_standard_layout<Affine2D>::value && std::is_trivially_copyable<Affine2D>::value, "Affine2D should be a plain struct");
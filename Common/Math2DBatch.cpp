@@ -0,0 +1,295 @@
+#include "Math2DBatch.h"
+#include "Math2DBatchKernels.h"
+
+#include <atomic>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MATH2D_SSE2 1
+#else
+#define MATH2D_SSE2 0
+#endif
+
+#if defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define MATH2D_NEON 1
+#else
+#define MATH2D_NEON 0
+#endif
+
+#if MATH2D_X86 && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+typedef void (*TransformAoSKernel)(const Point2D* in, Point2D* out, size_t count, const Affine2D& transform);
+typedef void (*TransformSoAKernel)(const float* inX, const float* inY, float* outX, float* outY, size_t count, const Affine2D& transform);
+
+// The kernels are in Math2DBatchAvx.cpp, which is the only file compiled with AVX
+// switched on; these just turn our types into the plain floats it takes.
+#if MATH2D_X86
+static Math2DKernelTransform KernelTransform(const Affine2D& transform)
+{
+    Math2DKernelTransform kernel = { transform.m00, transform.m01, transform.m10, transform.m11, transform.tx, transform.ty };
+    return kernel;
+}
+
+static void TransformPointsAvx(const Point2D* in, Point2D* out, size_t count, const Affine2D& transform)
+{
+    TransformPointsAvx(reinterpret_cast<const float*>(in), reinterpret_cast<float*>(out), count, KernelTransform(transform));
+}
+
+static void TransformPointsAvx(const float* inX, const float* inY, float* outX, float* outY, size_t count, const Affine2D& transform)
+{
+    TransformPointsAvx(inX, inY, outX, outY, count, KernelTransform(transform));
+}
+#endif
+
+/// ---------------------------------------------------------------------------------
+/// Plain C++: the definition of the right answer.
+/// ---------------------------------------------------------------------------------
+static void TransformPointsScalar(const Point2D* in, Point2D* out, size_t count, const Affine2D& transformIn)
+{
+    const Affine2D transform = transformIn;
+    for (size_t index = 0; index < count; index++)
+    {
+        out[index] = transform * in[index];
+    }
+}
+
+static void TransformPointsScalar(const float* inX, const float* inY, float* outX, float* outY, size_t count, const Affine2D& transformIn)
+{
+    const Affine2D transform = transformIn;
+    for (size_t index = 0; index < count; index++)
+    {
+        Point2D point = transform * Point2D(inX[index], inY[index]);
+        outX[index] = point.x;
+        outY[index] = point.y;
+    }
+}
+
+/// ---------------------------------------------------------------------------------
+/// Four at a time.
+///
+/// With separate x and y arrays, it's the scalar code with four lanes. With Point2Ds,
+/// a register holds two points, [x0 y0 x1 y1]. Swapping each pair gives [y0 x0 y1 x1],
+/// and then
+///
+///     [x0 y0 x1 y1] * [m00 m11 m00 m11] + [y0 x0 y1 x1] * [m01 m10 m01 m10] + [tx ty tx ty]
+///
+/// is both points transformed, with no shuffling back afterwards.
+/// ---------------------------------------------------------------------------------
+#if MATH2D_SSE2
+static void TransformPointsSimd4(const Point2D* in, Point2D* out, size_t count, const Affine2D& transform)
+{
+    const __m128 diagonal = _mm_setr_ps(transform.m00, transform.m11, transform.m00, transform.m11);
+    const __m128 cross = _mm_setr_ps(transform.m01, transform.m10, transform.m01, transform.m10);
+    const __m128 offset = _mm_setr_ps(transform.tx, transform.ty, transform.tx, transform.ty);
+    const float* src = reinterpret_cast<const float*>(in);
+    float* dst = reinterpret_cast<float*>(out);
+
+    size_t index = 0;
+    for (; index + 4 <= count; index += 4)
+    {
+        __m128 a = _mm_loadu_ps(src + index * 2);
+        __m128 b = _mm_loadu_ps(src + index * 2 + 4);
+        __m128 swappedA = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1));
+        __m128 swappedB = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_ps(dst + index * 2, _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, diagonal), _mm_mul_ps(swappedA, cross)), offset));
+        _mm_storeu_ps(dst + index * 2 + 4, _mm_add_ps(_mm_add_ps(_mm_mul_ps(b, diagonal), _mm_mul_ps(swappedB, cross)), offset));
+    }
+    TransformPointsScalar(in + index, out + index, count - index, transform);
+}
+
+static void TransformPointsSimd4(const float* inX, const float* inY, float* outX, float* outY, size_t count, const Affine2D& transform)
+{
+    const __m128 m00 = _mm_set1_ps(transform.m00);
+    const __m128 m01 = _mm_set1_ps(transform.m01);
+    const __m128 m10 = _mm_set1_ps(transform.m10);
+    const __m128 m11 = _mm_set1_ps(transform.m11);
+    const __m128 tx = _mm_set1_ps(transform.tx);
+    const __m128 ty = _mm_set1_ps(transform.ty);
+
+    size_t index = 0;
+    for (; index + 4 <= count; index += 4)
+    {
+        __m128 x = _mm_loadu_ps(inX + index);
+        __m128 y = _mm_loadu_ps(inY + index);
+        _mm_storeu_ps(outX + index, _mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, x), _mm_mul_ps(m01, y)), tx));
+        _mm_storeu_ps(outY + index, _mm_add_ps(_mm_add_ps(_mm_mul_ps(m10, x), _mm_mul_ps(m11, y)), ty));
+    }
+    TransformPointsScalar(inX + index, inY + index, outX + index, outY + index, count - index, transform);
+}
+#elif MATH2D_NEON
+// A fused vfmaq_f32 would round differently from the scalar code, hence the
+// separate multiplies and adds.
+static void TransformPointsSimd4(const Point2D* in, Point2D* out, size_t count, const Affine2D& transform)
+{
+    const float diagonalValues[4] = { transform.m00, transform.m11, transform.m00, transform.m11 };
+    const float crossValues[4] = { transform.m01, transform.m10, transform.m01, transform.m10 };
+    const float offsetValues[4] = { transform.tx, transform.ty, transform.tx, transform.ty };
+    const float32x4_t diagonal = vld1q_f32(diagonalValues);
+    const float32x4_t cross = vld1q_f32(crossValues);
+    const float32x4_t offset = vld1q_f32(offsetValues);
+    const float* src = reinterpret_cast<const float*>(in);
+    float* dst = reinterpret_cast<float*>(out);
+
+    size_t index = 0;
+    for (; index + 4 <= count; index += 4)
+    {
+        float32x4_t a = vld1q_f32(src + index * 2);
+        float32x4_t b = vld1q_f32(src + index * 2 + 4);
+        vst1q_f32(dst + index * 2, vaddq_f32(vaddq_f32(vmulq_f32(a, diagonal), vmulq_f32(vrev64q_f32(a), cross)), offset));
+        vst1q_f32(dst + index * 2 + 4, vaddq_f32(vaddq_f32(vmulq_f32(b, diagonal), vmulq_f32(vrev64q_f32(b), cross)), offset));
+    }
+    TransformPointsScalar(in + index, out + index, count - index, transform);
+}
+
+static void TransformPointsSimd4(const float* inX, const float* inY, float* outX, float* outY, size_t count, const Affine2D& transform)
+{
+    const float32x4_t m00 = vdupq_n_f32(transform.m00);
+    const float32x4_t m01 = vdupq_n_f32(transform.m01);
+    const float32x4_t m10 = vdupq_n_f32(transform.m10);
+    const float32x4_t m11 = vdupq_n_f32(transform.m11);
+    const float32x4_t tx = vdupq_n_f32(transform.tx);
+    const float32x4_t ty = vdupq_n_f32(transform.ty);
+
+    size_t index = 0;
+    for (; index + 4 <= count; index += 4)
+    {
+        float32x4_t x = vld1q_f32(inX + index);
+        float32x4_t y = vld1q_f32(inY + index);
+        vst1q_f32(outX + index, vaddq_f32(vaddq_f32(vmulq_f32(m00, x), vmulq_f32(m01, y)), tx));
+        vst1q_f32(outY + index, vaddq_f32(vaddq_f32(vmulq_f32(m10, x), vmulq_f32(m11, y)), ty));
+    }
+    TransformPointsScalar(inX + index, inY + index, outX + index, outY + index, count - index, transform);
+}
+#endif
+
+/// ---------------------------------------------------------------------------------
+/// Picking the kernels
+/// ---------------------------------------------------------------------------------
+static Math2DKernels DetectMath2DKernels()
+{
+#if MATH2D_X86
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    bool hasSse2 = (info[3] & (1 << 26)) != 0;
+    bool hasOsSave = (info[2] & (1 << 27)) != 0;
+    bool hasAvx = (info[2] & (1 << 28)) != 0;
+
+    // AVX needs the CPU to have it *and* the OS to save the YMM registers for us
+    hasAvx = hasAvx && hasOsSave && (_xgetbv(0) & 6) == 6;
+#else
+    __builtin_cpu_init();
+    bool hasSse2 = __builtin_cpu_supports("sse2") != 0;
+    bool hasAvx = __builtin_cpu_supports("avx") != 0;
+#endif
+
+    if (hasAvx)
+        return Math2DKernels::Avx;
+    if (hasSse2 && MATH2D_SSE2)
+        return Math2DKernels::Simd4;
+#elif MATH2D_NEON
+    return Math2DKernels::Simd4;
+#endif
+    return Math2DKernels::Scalar;
+}
+
+struct Math2DKernelSet
+{
+    Math2DKernels      kernels;
+    TransformAoSKernel transformAoS;
+    TransformSoAKernel transformSoA;
+};
+
+static Math2DKernelSet MakeKernelSet(Math2DKernels kernels)
+{
+    Math2DKernelSet set = { Math2DKernels::Scalar, TransformPointsScalar, TransformPointsScalar };
+#if MATH2D_X86
+    if (kernels == Math2DKernels::Avx)
+    {
+        set.kernels = kernels;
+        set.transformAoS = TransformPointsAvx;
+        set.transformSoA = TransformPointsAvx;
+    }
+#endif
+#if MATH2D_SSE2 || MATH2D_NEON
+    if (kernels == Math2DKernels::Simd4)
+    {
+        set.kernels = kernels;
+        set.transformAoS = TransformPointsSimd4;
+        set.transformSoA = TransformPointsSimd4;
+    }
+#endif
+    return set;
+}
+
+// The function pointers are only ever swapped as a set, so a thread calling
+// TransformPoints() during SetMath2DKernels() gets either all old or all new ones.
+static std::atomic<const Math2DKernelSet*> gKernels(nullptr);
+
+static const Math2DKernelSet& KernelSet(Math2DKernels kernels)
+{
+    static const Math2DKernelSet sets[] =
+    {
+        MakeKernelSet(Math2DKernels::Scalar),
+        MakeKernelSet(Math2DKernels::Simd4),
+        MakeKernelSet(Math2DKernels::Avx)
+    };
+    return sets[(int)kernels];
+}
+
+Math2DKernels SetMath2DKernels(Math2DKernels kernels)
+{
+    Math2DKernels supported = DetectMath2DKernels();
+    if ((int)kernels > (int)supported)
+        kernels = supported;
+
+    // Not every build has every kernel (no Simd4 without SSE2), so ask the set
+    const Math2DKernelSet& set = KernelSet(kernels);
+    gKernels = &set;
+    return set.kernels;
+}
+
+static const Math2DKernelSet& Kernels()
+{
+    const Math2DKernelSet* kernels = gKernels.load();
+    if (kernels == nullptr)
+    {
+        SetMath2DKernels(DetectMath2DKernels());
+        kernels = gKernels.load();
+    }
+    return *kernels;
+}
+
+Math2DKernels ActiveMath2DKernels()
+{
+    return Kernels().kernels;
+}
+
+const char* Math2DKernelsName(Math2DKernels kernels)
+{
+    switch (kernels)
+    {
+    case Math2DKernels::Scalar: return "scalar";
+#if MATH2D_NEON
+    case Math2DKernels::Simd4: return "NEON";
+#else
+    case Math2DKernels::Simd4: return "SSE2";
+#endif
+    case Math2DKernels::Avx: return "AVX";
+    }
+    return "unknown";
+}
+
+void TransformPoints(const Point2D* in, Point2D* out, size_t count, const Affine2D& transform)
+{
+    Kernels().transformAoS(in, out, count, transform);
+}
+
+void TransformPoints(const float* inX, const float* inY, float* outX, float* outY, size_t count, const Affine2D& transform)
+{
+    Kernels().transformSoA(inX, inY, outX, outY, count, transform);
+}
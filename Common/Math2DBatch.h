@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "Math2D.h"
+
+/// ---------------------------------------------------------------------------------
+/// Transforming whole arrays of points at once.
+///
+/// Two shapes of array are supported:
+///  - an array of Point2D (x, y, x, y, ...), as in a Vertex array or a list of
+///    centers,
+///  - separate x and y arrays, as in a ShapeStore pool or a VertexArraySoA.
+///
+/// The work is done 8 points at a time with AVX when the CPU has it, 4 at a time with
+/// SSE2 (every x64 CPU) or NEON (every 64-bit ARM CPU), and one at a time in plain C++
+/// otherwise. Which one is picked once, by asking the CPU, the same way Templates01's
+/// Min/Max do it. Every version gives the same answer as `transform * point` in a loop,
+/// to the last bit - none of them use fused multiply-adds (as long as the compiler
+/// doesn't fuse the plain C++ version's).
+///
+/// `in` and `out` can be the same array, to transform in place; otherwise they
+/// mustn't overlap.
+/// ---------------------------------------------------------------------------------
+
+void TransformPoints(const Point2D* in, Point2D* out, size_t count, const Affine2D& transform);
+void TransformPoints(const float* inX, const float* inY, float* outX, float* outY, size_t count, const Affine2D& transform);
+
+/// Translating or scaling is just a simpler transform. These loops are limited by
+/// how fast memory can feed them, not by the arithmetic, so the two multiplies that
+/// a dedicated version would save don't show up in the timings.
+inline void TranslatePoints(Point2D* points, size_t count, Vec2 offset)
+{
+    TransformPoints(points, points, count, Affine2D::Translation(offset));
+}
+
+inline void ScalePoints(Point2D* points, size_t count, float sx, float sy)
+{
+    TransformPoints(points, points, count, Affine2D::Scale(sx, sy));
+}
+
+/// Which instruction set the batch functions use. Handy for comparing them in
+/// benchmarks; asking for one the CPU doesn't have gets you the best one it does.
+enum class Math2DKernels
+{
+    Scalar,
+    Simd4,      // SSE2 or NEON
+    Avx         // 8 at a time
+};
+
+Math2DKernels SetMath2DKernels(Math2DKernels kernels);
+Math2DKernels ActiveMath2DKernels();
+const char* Math2DKernelsName(Math2DKernels kernels);
@@ -0,0 +1,75 @@
+#include "Math2DBatchKernels.h"
+
+#if MATH2D_X86
+
+#include <immintrin.h>
+
+/// ---------------------------------------------------------------------------------
+/// Eight at a time, with AVX. The same arithmetic as the four-at-a-time versions in
+/// Math2DBatch.cpp, in registers twice as wide. _mm256_permute_ps swaps each pair
+/// within each 128 bit half, which is exactly the [x y] -> [y x] swap we want.
+///
+/// This file is compiled with AVX switched on, so nothing in it may run before
+/// Math2DBatch.cpp has checked the CPU - which is why it has no statics, and why the
+/// leftover points are done with plain arithmetic rather than Math2D.h's operators
+/// (see Math2DBatchKernels.h).
+/// ---------------------------------------------------------------------------------
+void TransformPointsAvx(const float* in, float* out, size_t count, const Math2DKernelTransform& transform)
+{
+    const __m256 diagonal = _mm256_setr_ps(transform.m00, transform.m11, transform.m00, transform.m11,
+                                           transform.m00, transform.m11, transform.m00, transform.m11);
+    const __m256 cross = _mm256_setr_ps(transform.m01, transform.m10, transform.m01, transform.m10,
+                                        transform.m01, transform.m10, transform.m01, transform.m10);
+    const __m256 offset = _mm256_setr_ps(transform.tx, transform.ty, transform.tx, transform.ty,
+                                         transform.tx, transform.ty, transform.tx, transform.ty);
+    const float* src = in;
+    float* dst = out;
+
+    size_t index = 0;
+    for (; index + 8 <= count; index += 8)
+    {
+        __m256 a = _mm256_loadu_ps(src + index * 2);
+        __m256 b = _mm256_loadu_ps(src + index * 2 + 8);
+        __m256 swappedA = _mm256_permute_ps(a, _MM_SHUFFLE(2, 3, 0, 1));
+        __m256 swappedB = _mm256_permute_ps(b, _MM_SHUFFLE(2, 3, 0, 1));
+        _mm256_storeu_ps(dst + index * 2, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a, diagonal), _mm256_mul_ps(swappedA, cross)), offset));
+        _mm256_storeu_ps(dst + index * 2 + 8, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(b, diagonal), _mm256_mul_ps(swappedB, cross)), offset));
+    }
+
+    for (; index < count; index++)
+    {
+        const float x = src[index * 2];
+        const float y = src[index * 2 + 1];
+        dst[index * 2] = transform.m00 * x + transform.m01 * y + transform.tx;
+        dst[index * 2 + 1] = transform.m10 * x + transform.m11 * y + transform.ty;
+    }
+}
+
+void TransformPointsAvx(const float* inX, const float* inY, float* outX, float* outY, size_t count, const Math2DKernelTransform& transform)
+{
+    const __m256 m00 = _mm256_set1_ps(transform.m00);
+    const __m256 m01 = _mm256_set1_ps(transform.m01);
+    const __m256 m10 = _mm256_set1_ps(transform.m10);
+    const __m256 m11 = _mm256_set1_ps(transform.m11);
+    const __m256 tx = _mm256_set1_ps(transform.tx);
+    const __m256 ty = _mm256_set1_ps(transform.ty);
+
+    size_t index = 0;
+    for (; index + 8 <= count; index += 8)
+    {
+        __m256 x = _mm256_loadu_ps(inX + index);
+        __m256 y = _mm256_loadu_ps(inY + index);
+        _mm256_storeu_ps(outX + index, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m00, x), _mm256_mul_ps(m01, y)), tx));
+        _mm256_storeu_ps(outY + index, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m10, x), _mm256_mul_ps(m11, y)), ty));
+    }
+
+    for (; index < count; index++)
+    {
+        const float x = inX[index];
+        const float y = inY[index];
+        outX[index] = transform.m00 * x + transform.m01 * y + transform.tx;
+        outY[index] = transform.m10 * x + transform.m11 * y + transform.ty;
+    }
+}
+
+#endif
@@ -0,0 +1,32 @@
+#pragma once
+
+/// ---------------------------------------------------------------------------------
+/// What Math2DBatch.cpp and Math2DBatchAvx.cpp share. Math2DBatchAvx.cpp is compiled
+/// with AVX switched on, so it includes this and nothing else of ours: plain floats
+/// and declarations only. If it saw Math2D.h, any of its inline functions it used
+/// (Affine2D's operator*, say) could be compiled there with AVX instructions - and
+/// the linker is free to pick that copy for the whole program, which then crashes on
+/// CPUs without AVX.
+/// ---------------------------------------------------------------------------------
+
+#include <stddef.h>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define MATH2D_X86 1
+#else
+#define MATH2D_X86 0
+#endif
+
+/// An Affine2D's six numbers, in the same order.
+struct Math2DKernelTransform
+{
+    float m00, m01;
+    float m10, m11;
+    float tx, ty;
+};
+
+#if MATH2D_X86
+/// `in` and `out` are arrays of x, y pairs: Point2Ds, as floats.
+void TransformPointsAvx(const float* in, float* out, size_t count, const Math2DKernelTransform& transform);
+void TransformPointsAvx(const float* inX, const float* inY, float* outX, float* outY, size_t count, const Math2DKernelTransform& transform);
+#endif
@@ -0,0 +1,143 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int threadCount)
+    : mBody(nullptr)
+    , mQueued(0)
+    , mRemaining(0)
+    , mSteals(0)
+    , mStopping(false)
+{
+    if (threadCount <= 0)
+        threadCount = (int)std::thread::hardware_concurrency();
+    if (threadCount <= 0)
+        threadCount = 1;
+
+    for (int index = 0; index < threadCount; index++)
+    {
+        mQueues.emplace_back(new Queue());
+    }
+
+    // Queue 0 belongs to whoever calls ParallelFor; the rest get a thread each
+    for (int index = 1; index < threadCount; index++)
+    {
+        mThreads.emplace_back(&ThreadPool::WorkerLoop, this, index);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mWakeMutex);
+        mStopping = true;
+    }
+    mWake.notify_all();
+
+    for (std::thread& thread : mThreads)
+    {
+        thread.join();
+    }
+}
+
+void ThreadPool::ParallelFor(int count, const std::function<void(int)>& body)
+{
+    if (count <= 0)
+        return;
+
+    mBody = &body;
+    mRemaining.store(count);
+
+    // Each queue gets a contiguous run of tasks, so neighbouring tiles (say) are
+    // likely to end up on the same thread.
+    const int queueCount = ThreadCount();
+    for (int queue = 0; queue < queueCount; queue++)
+    {
+        int first = (int)((int64_t)count * queue / queueCount);
+        int last = (int)((int64_t)count * (queue + 1) / queueCount);
+
+        std::lock_guard<std::mutex> lock(mQueues[queue]->mutex);
+        for (int task = first; task < last; task++)
+        {
+            mQueues[queue]->tasks.push_back(task);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mWakeMutex);
+        mQueued.fetch_add(count);
+    }
+    mWake.notify_all();
+
+    // Help out until everything's been picked up, then wait for the stragglers
+    int task;
+    while (PopOrSteal(0, task))
+    {
+        Run(task);
+    }
+
+    std::unique_lock<std::mutex> lock(mDoneMutex);
+    mDone.wait(lock, [this] { return mRemaining.load() == 0; });
+    mBody = nullptr;
+}
+
+bool ThreadPool::PopOrSteal(int self, int& task)
+{
+    {
+        Queue& own = *mQueues[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty())
+        {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            mQueued.fetch_sub(1);
+            return true;
+        }
+    }
+
+    const int queueCount = ThreadCount();
+    for (int offset = 1; offset < queueCount; offset++)
+    {
+        Queue& victim = *mQueues[(self + offset) % queueCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty())
+        {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            mQueued.fetch_sub(1);
+            mSteals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::Run(int task)
+{
+    (*mBody)(task);
+
+    if (mRemaining.fetch_sub(1) == 1)
+    {
+        // Taking the lock means ParallelFor is either not yet waiting (and will see
+        // zero when it checks) or already waiting (and gets the notify).
+        std::lock_guard<std::mutex> lock(mDoneMutex);
+        mDone.notify_all();
+    }
+}
+
+void ThreadPool::WorkerLoop(int self)
+{
+    while (true)
+    {
+        int task;
+        if (PopOrSteal(self, task))
+        {
+            Run(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mWakeMutex);
+        mWake.wait(lock, [this] { return mStopping || mQueued.load() > 0; });
+        if (mStopping)
+            return;
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+/// ---------------------------------------------------------------------------------
+/// A small work-stealing thread pool, for splitting a frame into pieces.
+///
+/// ParallelFor(count, body) runs body(0) .. body(count - 1) across the pool, and
+/// returns when they've all finished. The calling thread joins in, so a pool of N
+/// threads starts N - 1 of its own, and ThreadPool(1) runs everything on the caller
+/// (handy as the baseline when measuring how well something scales).
+///
+/// Every thread has its own queue of task indices, and ParallelFor deals each one a
+/// contiguous share. A thread works through its own queue from the back; when that's
+/// empty, it steals from the front of someone else's. So nobody sits idle while
+/// another thread still has a backlog, even when some tasks take much longer than
+/// others - and when they're all about the same, there's almost no stealing at all.
+///
+/// ParallelFor must only be called by one thread at a time, and not from inside a
+/// body.
+/// ---------------------------------------------------------------------------------
+class ThreadPool
+{
+public:
+    /// 0 means one thread per core.
+    explicit ThreadPool(int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// Including the thread that calls ParallelFor.
+    int ThreadCount() const { return (int)mQueues.size(); }
+
+    void ParallelFor(int count, const std::function<void(int)>& body);
+
+    /// Tasks that were run by a thread other than the one they were dealt to.
+    uint64_t Steals() const { return mSteals.load(); }
+
+private:
+    struct Queue
+    {
+        std::mutex      mutex;
+        std::deque<int> tasks;
+    };
+
+    bool PopOrSteal(int self, int& task);
+    void Run(int task);
+    void WorkerLoop(int self);
+
+    std::vector<std::unique_ptr<Queue>> mQueues;   ///< [0] is the calling thread's
+    std::vector<std::thread> mThreads;
+
+    const std::function<void(int)>* mBody;
+    std::atomic<int>      mQueued;      ///< Tasks sitting in a queue
+    std::atomic<int>      mRemaining;   ///< Tasks not finished yet
+    std::atomic<uint64_t> mSteals;
+
+    std::mutex              mWakeMutex;
+    std::condition_variable mWake;      ///< Workers wait here for tasks
+    std::mutex              mDoneMutex;
+    std::condition_variable mDone;      ///< ParallelFor waits here for the last task
+    bool                    mStopping;
+};
@@ -0,0 +1,144 @@
+#pragma once
+
+/// ---------------------------------------------------------------------------------
+/// Min and Max for anything with a `<` (or with a comparator you pass in).
+///
+/// The arguments are taken by reference, so comparing two std::strings doesn't copy
+/// either of them. What comes back depends on what went in:
+///
+///  - Two lvalues of the same type (variables, array elements, ...) give you a const
+///    reference to one of them. Still no copies.
+///  - If either one is a temporary, you get a copy (moved, where it can be). A
+///    reference to a temporary would dangle as soon as the statement ends.
+///
+/// Everything is constexpr, so `Min(3, 1, 2)` works in a static_assert, and noexcept
+/// whenever the comparison (and the copy, if there is one) can't throw.
+///
+/// On a tie you get the second argument, same as `valueA < valueB ? valueA : valueB`.
+/// ---------------------------------------------------------------------------------
+
+#include <type_traits>
+#include <utility>
+
+namespace MinMaxDetail
+{
+    template<typename T>
+    using Decay = typename std::decay<T>::type;
+
+    template<typename... Ts>
+    struct AllSame : std::true_type {};
+
+    template<typename T, typename U, typename... Rest>
+    struct AllSame<T, U, Rest...>
+        : std::integral_constant<bool, std::is_same<Decay<T>, Decay<U>>::value && AllSame<U, Rest...>::value> {};
+
+    template<typename... Ts>
+    struct AllLvalues : std::true_type {};
+
+    template<typename T, typename... Rest>
+    struct AllLvalues<T, Rest...>
+        : std::integral_constant<bool, std::is_lvalue_reference<T>::value && AllLvalues<Rest...>::value> {};
+
+    /// `const T&` when every argument is an lvalue, `T` otherwise.
+    template<typename A, typename... Rest>
+    using Result = typename std::conditional<AllLvalues<A, Rest...>::value, const Decay<A>&, Decay<A>>::type;
+
+    /// Can we build the result from any of the arguments without throwing?
+    template<typename R, typename... Args>
+    struct NothrowResult : std::true_type {};
+
+    template<typename R, typename A, typename... Rest>
+    struct NothrowResult<R, A, Rest...>
+        : std::integral_constant<bool, std::is_nothrow_constructible<R, A&&>::value && NothrowResult<R, Rest...>::value> {};
+
+    template<typename T, typename Compare>
+    struct NothrowCompare
+        : std::integral_constant<bool, noexcept(static_cast<bool>(std::declval<Compare&>()(std::declval<const T&>(), std::declval<const T&>())))> {};
+
+    struct Less
+    {
+        // The return type is spelled out so that types without a `<` drop out of
+        // overload resolution, rather than failing inside Min.
+        template<typename T>
+        constexpr auto operator()(const T& valueA, const T& valueB) const noexcept(noexcept(static_cast<bool>(valueA < valueB)))
+            -> decltype(static_cast<bool>(valueA < valueB))
+        {
+            return valueA < valueB;
+        }
+    };
+
+    /// Can `compare(valueA, valueB)` be called with two Ts?
+    template<typename T, typename Compare, typename = void>
+    struct IsComparator : std::false_type {};
+
+    template<typename T, typename Compare>
+    struct IsComparator<T, Compare, decltype(static_cast<void>(std::declval<Compare&>()(std::declval<const T&>(), std::declval<const T&>())))>
+        : std::true_type {};
+
+    /// Without a comparator, the values need a `<`. That also keeps Spans (and the
+    /// like) away from `Min(a, b, c)`, so they find the array versions in MinMaxSimd.h.
+    template<typename A, typename B>
+    using EnableIfSame = typename std::enable_if<AllSame<A, B>::value && IsComparator<Decay<A>, Less>::value, int>::type;
+
+    /// The comparator overloads take three arguments, same as `Min(a, b, c)` and the
+    /// element-wise array versions in MinMaxSimd.h; the comparator is a third argument
+    /// of a different type that can actually be called with two values.
+    template<typename A, typename B, typename Compare>
+    using EnableIfComparator = typename std::enable_if<AllSame<A, B>::value && !AllSame<A, Compare>::value &&
+                                                       IsComparator<Decay<A>, Compare>::value, int>::type;
+
+    template<typename A, typename B, typename C, typename... Rest>
+    using EnableIfVariadic = typename std::enable_if<AllSame<A, B, C, Rest...>::value && IsComparator<Decay<A>, Less>::value, int>::type;
+}
+
+/// Min(a, b, less): `less(valueA, valueB) ? valueA : valueB`
+template<typename A, typename B, typename Compare, MinMaxDetail::EnableIfComparator<A, B, Compare> = 0>
+constexpr MinMaxDetail::Result<A, B> Min(A&& valueA, B&& valueB, Compare compare)
+    noexcept(MinMaxDetail::NothrowCompare<MinMaxDetail::Decay<A>, Compare>::value &&
+             MinMaxDetail::NothrowResult<MinMaxDetail::Result<A, B>, A, B>::value)
+{
+    return compare(valueA, valueB) ? std::forward<A>(valueA) : std::forward<B>(valueB);
+}
+
+/// Max(a, b, less): `less(valueB, valueA) ? valueA : valueB`, i.e. `valueA > valueB ? ...`
+template<typename A, typename B, typename Compare, MinMaxDetail::EnableIfComparator<A, B, Compare> = 0>
+constexpr MinMaxDetail::Result<A, B> Max(A&& valueA, B&& valueB, Compare compare)
+    noexcept(MinMaxDetail::NothrowCompare<MinMaxDetail::Decay<A>, Compare>::value &&
+             MinMaxDetail::NothrowResult<MinMaxDetail::Result<A, B>, A, B>::value)
+{
+    return compare(valueB, valueA) ? std::forward<A>(valueA) : std::forward<B>(valueB);
+}
+
+template<typename A, typename B, MinMaxDetail::EnableIfSame<A, B> = 0>
+constexpr MinMaxDetail::Result<A, B> Min(A&& valueA, B&& valueB)
+    noexcept(MinMaxDetail::NothrowCompare<MinMaxDetail::Decay<A>, MinMaxDetail::Less>::value &&
+             MinMaxDetail::NothrowResult<MinMaxDetail::Result<A, B>, A, B>::value)
+{
+    return Min(std::forward<A>(valueA), std::forward<B>(valueB), MinMaxDetail::Less());
+}
+
+template<typename A, typename B, MinMaxDetail::EnableIfSame<A, B> = 0>
+constexpr MinMaxDetail::Result<A, B> Max(A&& valueA, B&& valueB)
+    noexcept(MinMaxDetail::NothrowCompare<MinMaxDetail::Decay<A>, MinMaxDetail::Less>::value &&
+             MinMaxDetail::NothrowResult<MinMaxDetail::Result<A, B>, A, B>::value)
+{
+    return Max(std::forward<A>(valueA), std::forward<B>(valueB), MinMaxDetail::Less());
+}
+
+/// Min(a, b, c, ...) is Min(Min(Min(a, b), c), ...), worked out by the compiler -
+/// there's no loop at runtime.
+template<typename A, typename B, typename C, typename... Rest, MinMaxDetail::EnableIfVariadic<A, B, C, Rest...> = 0>
+constexpr MinMaxDetail::Result<A, B, C, Rest...> Min(A&& valueA, B&& valueB, C&& valueC, Rest&&... rest)
+    noexcept(MinMaxDetail::NothrowCompare<MinMaxDetail::Decay<A>, MinMaxDetail::Less>::value &&
+             MinMaxDetail::NothrowResult<MinMaxDetail::Result<A, B, C, Rest...>, A, B, C, Rest...>::value)
+{
+    return Min(Min(std::forward<A>(valueA), std::forward<B>(valueB)), std::forward<C>(valueC), std::forward<Rest>(rest)...);
+}
+
+template<typename A, typename B, typename C, typename... Rest, MinMaxDetail::EnableIfVariadic<A, B, C, Rest...> = 0>
+constexpr MinMaxDetail::Result<A, B, C, Rest...> Max(A&& valueA, B&& valueB, C&& valueC, Rest&&... rest)
+    noexcept(MinMaxDetail::NothrowCompare<MinMaxDetail::Decay<A>, MinMaxDetail::Less>::value &&
+             MinMaxDetail::NothrowResult<MinMaxDetail::Result<A, B, C, Rest...>, A, B, C, Rest...>::value)
+{
+    return Max(Max(std::forward<A>(valueA), std::forward<B>(valueB)), std::forward<C>(valueC), std::forward<Rest>(rest)...);
+}
@@ -0,0 +1,94 @@
+/// The AVX2 kernels. This is the only file compiled with AVX2 turned on (-mavx2, or
+/// /arch:AVX2 on MSVC), and nothing in here runs unless the CPU says it has AVX2.
+/// Keep the standard library out of this file: any of its inline functions that got
+/// compiled here could end up being the copy the rest of the program uses.
+#define MINMAX_KERNEL_FILE
+#include "MinMaxKernels.h"
+
+#if MINMAX_X86
+#include <math.h>
+#include <immintrin.h>
+
+namespace
+{
+    struct Avx2Float
+    {
+        typedef float Scalar;
+        typedef __m256 Vector;
+        static const size_t kWidth = 8;
+        static const bool kHasNaN = true;
+
+        static Scalar Highest() { return HUGE_VALF; }
+        static Scalar Lowest() { return -HUGE_VALF; }
+        static Vector Load(const Scalar* values) { return _mm256_loadu_ps(values); }
+        static void Store(Scalar* out, Vector value) { _mm256_storeu_ps(out, value); }
+        static Vector Splat(Scalar value) { return _mm256_set1_ps(value); }
+        static Vector Min(Vector a, Vector b) { return _mm256_min_ps(a, b); }
+        static Vector Max(Vector a, Vector b) { return _mm256_max_ps(a, b); }
+        static bool HasNaN(Vector value) { return _mm256_movemask_ps(_mm256_cmp_ps(value, value, _CMP_UNORD_Q)) != 0; }
+    };
+
+    struct Avx2Double
+    {
+        typedef double Scalar;
+        typedef __m256d Vector;
+        static const size_t kWidth = 4;
+        static const bool kHasNaN = true;
+
+        static Scalar Highest() { return HUGE_VAL; }
+        static Scalar Lowest() { return -HUGE_VAL; }
+        static Vector Load(const Scalar* values) { return _mm256_loadu_pd(values); }
+        static void Store(Scalar* out, Vector value) { _mm256_storeu_pd(out, value); }
+        static Vector Splat(Scalar value) { return _mm256_set1_pd(value); }
+        static Vector Min(Vector a, Vector b) { return _mm256_min_pd(a, b); }
+        static Vector Max(Vector a, Vector b) { return _mm256_max_pd(a, b); }
+        static bool HasNaN(Vector value) { return _mm256_movemask_pd(_mm256_cmp_pd(value, value, _CMP_UNORD_Q)) != 0; }
+    };
+
+    struct Avx2Int32
+    {
+        typedef int32_t Scalar;
+        typedef __m256i Vector;
+        static const size_t kWidth = 8;
+        static const bool kHasNaN = false;
+
+        static Scalar Highest() { return INT32_MAX; }
+        static Scalar Lowest() { return INT32_MIN; }
+        static Vector Load(const Scalar* values) { return _mm256_loadu_si256((const __m256i*)values); }
+        static void Store(Scalar* out, Vector value) { _mm256_storeu_si256((__m256i*)out, value); }
+        static Vector Splat(Scalar value) { return _mm256_set1_epi32(value); }
+        static Vector Min(Vector a, Vector b) { return _mm256_min_epi32(a, b); }
+        static Vector Max(Vector a, Vector b) { return _mm256_max_epi32(a, b); }
+        static bool HasNaN(Vector) { return false; }
+    };
+
+    struct Avx2UInt8
+    {
+        typedef uint8_t Scalar;
+        typedef __m256i Vector;
+        static const size_t kWidth = 32;
+        static const bool kHasNaN = false;
+
+        static Scalar Highest() { return UINT8_MAX; }
+        static Scalar Lowest() { return 0; }
+        static Vector Load(const Scalar* values) { return _mm256_loadu_si256((const __m256i*)values); }
+        static void Store(Scalar* out, Vector value) { _mm256_storeu_si256((__m256i*)out, value); }
+        static Vector Splat(Scalar value) { return _mm256_set1_epi8((char)value); }
+        static Vector Min(Vector a, Vector b) { return _mm256_min_epu8(a, b); }
+        static Vector Max(Vector a, Vector b) { return _mm256_max_epu8(a, b); }
+        static bool HasNaN(Vector) { return false; }
+    };
+}
+
+const MinMaxKernelTable& MinMaxKernelsAvx2()
+{
+    static const MinMaxKernelTable table =
+    {
+        MakeKernelSet<Avx2Float>(),
+        MakeKernelSet<Avx2Double>(),
+        MakeKernelSet<Avx2Int32>(),
+        MakeKernelSet<Avx2UInt8>()
+    };
+    return table;
+}
+#endif
@@ -0,0 +1,182 @@
+#pragma once
+
+/// ---------------------------------------------------------------------------------
+/// The plumbing behind MinMaxSimd.h. Each instruction set gets its own .cpp file, so
+/// that only MinMaxAvx2.cpp is compiled with AVX2 turned on - otherwise the compiler
+/// would be free to use AVX2 anywhere, and the program would crash on older CPUs.
+///
+/// The kernels are written once, as templates over a 'Lanes' type that wraps the
+/// intrinsics for one instruction set and one element type:
+///
+///     typedef ... Scalar;           // float, double, int32_t, uint8_t
+///     typedef ... Vector;           // __m128, __m256i, ...
+///     static const size_t kWidth;   // Scalars per Vector
+///     static const bool kHasNaN;
+///     static Scalar Highest();      // Min's starting value
+///     static Scalar Lowest();       // Max's starting value
+///     static Vector Load(const Scalar*);
+///     static void Store(Scalar*, Vector);
+///     static Vector Splat(Scalar);
+///     static Vector Min(Vector a, Vector b);   // a < b ? a : b, per lane
+///     static Vector Max(Vector a, Vector b);   // a > b ? a : b, per lane
+///     static bool HasNaN(Vector);
+/// ---------------------------------------------------------------------------------
+
+#include <stddef.h>
+#include <stdint.h>
+
+template<typename T>
+struct MinMaxKernelSet
+{
+    T    (*reduceMin)(const T* values, size_t count);
+    T    (*reduceMax)(const T* values, size_t count);
+    void (*elementMin)(const T* a, const T* b, T* out, size_t count);
+    void (*elementMax)(const T* a, const T* b, T* out, size_t count);
+};
+
+struct MinMaxKernelTable
+{
+    MinMaxKernelSet<float>   f32;
+    MinMaxKernelSet<double>  f64;
+    MinMaxKernelSet<int32_t> i32;
+    MinMaxKernelSet<uint8_t> u8;
+};
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define MINMAX_X86 1
+#else
+#define MINMAX_X86 0
+#endif
+
+#if MINMAX_X86
+const MinMaxKernelTable& MinMaxKernelsSse2();
+const MinMaxKernelTable& MinMaxKernelsAvx2();
+#endif
+
+/// Everything below is only for the instruction set files, and lives in an anonymous
+/// namespace on purpose: each file gets its own private copy, compiled with its own
+/// flags, and the linker can't swap an AVX2 copy in for an SSE2 one.
+#ifdef MINMAX_KERNEL_FILE
+namespace
+{
+    template<typename Lanes, bool IsMin>
+    inline typename Lanes::Scalar Pick(typename Lanes::Scalar valueA, typename Lanes::Scalar valueB)
+    {
+        if (IsMin)
+            return valueA < valueB ? valueA : valueB;
+        return valueA > valueB ? valueA : valueB;
+    }
+
+    template<typename Lanes, bool IsMin>
+    inline typename Lanes::Vector Pick(typename Lanes::Vector valueA, typename Lanes::Vector valueB)
+    {
+        return IsMin ? Lanes::Min(valueA, valueB) : Lanes::Max(valueA, valueB);
+    }
+
+    template<typename Lanes, bool IsMin>
+    void Elementwise(const typename Lanes::Scalar* a, const typename Lanes::Scalar* b,
+                     typename Lanes::Scalar* out, size_t count)
+    {
+        size_t index = 0;
+        for (; index + Lanes::kWidth <= count; index += Lanes::kWidth)
+        {
+            Lanes::Store(out + index, Pick<Lanes, IsMin>(Lanes::Load(a + index), Lanes::Load(b + index)));
+        }
+
+        for (; index < count; index++)
+        {
+            out[index] = Pick<Lanes, IsMin>(a[index], b[index]);
+        }
+    }
+
+    /// The scalar fold `result = Min(result, values[i])` has two quirks we have to copy:
+    ///
+    ///  - A NaN throws away everything before it (the next element replaces it), so
+    ///    the answer only depends on what comes after the *last* NaN. If the last
+    ///    element is a NaN, that's the answer.
+    ///  - On a tie the later element wins, which you can only see with -0.0 and +0.0.
+    ///
+    /// So we walk backwards, stopping at the first NaN we meet, taking the plain
+    /// vector min/max on the way. Then, if the answer is zero, we go and find the last
+    /// zero to get its sign right.
+    template<typename Lanes, bool IsMin>
+    typename Lanes::Scalar Reduce(const typename Lanes::Scalar* values, size_t count)
+    {
+        typedef typename Lanes::Scalar Scalar;
+        typedef typename Lanes::Vector Vector;
+        const size_t width = Lanes::kWidth;
+
+        Scalar best = IsMin ? Lanes::Highest() : Lanes::Lowest();
+        Vector bestLanes = Lanes::Splat(best);
+        size_t start = 0;   // the answer comes from values[start, count)
+
+        const size_t blocksEnd = count - count % width;
+        size_t index = count;
+
+        // The leftovers at the end, one at a time
+        for (; index > blocksEnd; index--)
+        {
+            Scalar value = values[index - 1];
+            if (Lanes::kHasNaN && value != value)
+            {
+                start = index;
+                goto found;
+            }
+            best = Pick<Lanes, IsMin>(best, value);
+        }
+
+        // Then whole vectors
+        for (; index >= width; index -= width)
+        {
+            Vector block = Lanes::Load(values + index - width);
+            if (Lanes::kHasNaN && Lanes::HasNaN(block))
+            {
+                for (size_t inner = index; inner > index - width; inner--)
+                {
+                    Scalar value = values[inner - 1];
+                    if (value != value)
+                    {
+                        start = inner;
+                        goto found;
+                    }
+                    best = Pick<Lanes, IsMin>(best, value);
+                }
+            }
+            bestLanes = Pick<Lanes, IsMin>(bestLanes, block);
+        }
+
+    found:
+        if (start == count)
+            return values[count - 1];
+
+        Scalar lanes[Lanes::kWidth];
+        Lanes::Store(lanes, bestLanes);
+        for (size_t lane = 0; lane < width; lane++)
+        {
+            best = Pick<Lanes, IsMin>(best, lanes[lane]);
+        }
+
+        if (Lanes::kHasNaN && best == 0)
+        {
+            for (index = count; index > start; index--)
+            {
+                if (values[index - 1] == 0)
+                    return values[index - 1];
+            }
+        }
+
+        return best;
+    }
+
+    template<typename Lanes>
+    MinMaxKernelSet<typename Lanes::Scalar> MakeKernelSet()
+    {
+        MinMaxKernelSet<typename Lanes::Scalar> kernels;
+        kernels.reduceMin = Reduce<Lanes, true>;
+        kernels.reduceMax = Reduce<Lanes, false>;
+        kernels.elementMin = Elementwise<Lanes, true>;
+        kernels.elementMax = Elementwise<Lanes, false>;
+        return kernels;
+    }
+}
+#endif
@@ -0,0 +1,221 @@
+#include "MinMaxSimd.h"
+#include "MinMaxKernels.h"
+#include "MinMax.h"
+
+#include <assert.h>
+#include <atomic>
+
+#if MINMAX_X86 && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+/// ---------------------------------------------------------------------------------
+/// The plain C++ versions. These are the definition of 'the right answer'; the SIMD
+/// versions have to match them bit for bit.
+/// ---------------------------------------------------------------------------------
+template<typename T>
+static T ScalarReduceMin(const T* values, size_t count)
+{
+    T result = values[0];
+    for (size_t index = 1; index < count; index++)
+    {
+        result = Min(result, values[index]);
+    }
+    return result;
+}
+
+template<typename T>
+static T ScalarReduceMax(const T* values, size_t count)
+{
+    T result = values[0];
+    for (size_t index = 1; index < count; index++)
+    {
+        result = Max(result, values[index]);
+    }
+    return result;
+}
+
+template<typename T>
+static void ScalarElementMin(const T* a, const T* b, T* out, size_t count)
+{
+    for (size_t index = 0; index < count; index++)
+    {
+        out[index] = Min(a[index], b[index]);
+    }
+}
+
+template<typename T>
+static void ScalarElementMax(const T* a, const T* b, T* out, size_t count)
+{
+    for (size_t index = 0; index < count; index++)
+    {
+        out[index] = Max(a[index], b[index]);
+    }
+}
+
+template<typename T>
+static MinMaxKernelSet<T> ScalarKernelSet()
+{
+    MinMaxKernelSet<T> kernels;
+    kernels.reduceMin = ScalarReduceMin<T>;
+    kernels.reduceMax = ScalarReduceMax<T>;
+    kernels.elementMin = ScalarElementMin<T>;
+    kernels.elementMax = ScalarElementMax<T>;
+    return kernels;
+}
+
+static const MinMaxKernelTable& MinMaxKernelsScalar()
+{
+    static const MinMaxKernelTable table =
+    {
+        ScalarKernelSet<float>(),
+        ScalarKernelSet<double>(),
+        ScalarKernelSet<int32_t>(),
+        ScalarKernelSet<uint8_t>()
+    };
+    return table;
+}
+
+/// ---------------------------------------------------------------------------------
+/// Picking an instruction set
+/// ---------------------------------------------------------------------------------
+SimdLevel DetectSimdLevel()
+{
+#if MINMAX_X86
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int highestLeaf = info[0];
+
+    __cpuid(info, 1);
+    bool hasSse2 = (info[3] & (1 << 26)) != 0;
+    bool hasOsSave = (info[2] & (1 << 27)) != 0;
+    bool hasAvx = (info[2] & (1 << 28)) != 0;
+
+    // AVX2 needs the CPU to have it *and* the OS to save the YMM registers for us
+    bool hasAvx2 = false;
+    if (highestLeaf >= 7 && hasOsSave && hasAvx && (_xgetbv(0) & 6) == 6)
+    {
+        __cpuidex(info, 7, 0);
+        hasAvx2 = (info[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    bool hasSse2 = __builtin_cpu_supports("sse2") != 0;
+    bool hasAvx2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+
+    if (hasAvx2)
+        return SimdLevel::AVX2;
+    if (hasSse2)
+        return SimdLevel::SSE2;
+#endif
+    return SimdLevel::Scalar;
+}
+
+static std::atomic<const MinMaxKernelTable*> gKernels(nullptr);
+static std::atomic<SimdLevel> gActiveLevel(SimdLevel::Scalar);
+
+SimdLevel SetSimdLevel(SimdLevel level)
+{
+    SimdLevel supported = DetectSimdLevel();
+    if ((int)level > (int)supported)
+        level = supported;
+
+    const MinMaxKernelTable* kernels = &MinMaxKernelsScalar();
+#if MINMAX_X86
+    if (level == SimdLevel::SSE2)
+        kernels = &MinMaxKernelsSse2();
+    else if (level == SimdLevel::AVX2)
+        kernels = &MinMaxKernelsAvx2();
+#endif
+
+    gActiveLevel = level;
+    gKernels = kernels;
+    return level;
+}
+
+static const MinMaxKernelTable& Kernels()
+{
+    const MinMaxKernelTable* kernels = gKernels.load(std::memory_order_acquire);
+    if (kernels == nullptr)
+    {
+        SetSimdLevel(DetectSimdLevel());
+        kernels = gKernels.load(std::memory_order_acquire);
+    }
+    return *kernels;
+}
+
+// Do the detection at startup, rather than in the middle of the first call.
+static const MinMaxKernelTable& gStartupKernels = Kernels();
+
+SimdLevel ActiveSimdLevel()
+{
+    Kernels();
+    return gActiveLevel;
+}
+
+const char* SimdLevelName(SimdLevel level)
+{
+    switch (level)
+    {
+    case SimdLevel::SSE2:
+        return "SSE2";
+    case SimdLevel::AVX2:
+        return "AVX2";
+    default:
+        return "Scalar";
+    }
+}
+
+/// ---------------------------------------------------------------------------------
+/// The public functions just forward to whichever table is active
+/// ---------------------------------------------------------------------------------
+template<typename T>
+static T ReduceMin(const MinMaxKernelSet<T>& kernels, Span<const T> values)
+{
+    assert(values.size > 0);
+    return kernels.reduceMin(values.data, values.size);
+}
+
+template<typename T>
+static T ReduceMax(const MinMaxKernelSet<T>& kernels, Span<const T> values)
+{
+    assert(values.size > 0);
+    return kernels.reduceMax(values.data, values.size);
+}
+
+template<typename T>
+static void ElementMin(const MinMaxKernelSet<T>& kernels, Span<const T> a, Span<const T> b, Span<T> out)
+{
+    assert(a.size == b.size && a.size == out.size);
+    kernels.elementMin(a.data, b.data, out.data, out.size);
+}
+
+template<typename T>
+static void ElementMax(const MinMaxKernelSet<T>& kernels, Span<const T> a, Span<const T> b, Span<T> out)
+{
+    assert(a.size == b.size && a.size == out.size);
+    kernels.elementMax(a.data, b.data, out.data, out.size);
+}
+
+float   Min(Span<const float> values)   { return ReduceMin(Kernels().f32, values); }
+double  Min(Span<const double> values)  { return ReduceMin(Kernels().f64, values); }
+int32_t Min(Span<const int32_t> values) { return ReduceMin(Kernels().i32, values); }
+uint8_t Min(Span<const uint8_t> values) { return ReduceMin(Kernels().u8, values); }
+
+float   Max(Span<const float> values)   { return ReduceMax(Kernels().f32, values); }
+double  Max(Span<const double> values)  { return ReduceMax(Kernels().f64, values); }
+int32_t Max(Span<const int32_t> values) { return ReduceMax(Kernels().i32, values); }
+uint8_t Max(Span<const uint8_t> values) { return ReduceMax(Kernels().u8, values); }
+
+void Min(Span<const float> a, Span<const float> b, Span<float> out)         { ElementMin(Kernels().f32, a, b, out); }
+void Min(Span<const double> a, Span<const double> b, Span<double> out)      { ElementMin(Kernels().f64, a, b, out); }
+void Min(Span<const int32_t> a, Span<const int32_t> b, Span<int32_t> out)   { ElementMin(Kernels().i32, a, b, out); }
+void Min(Span<const uint8_t> a, Span<const uint8_t> b, Span<uint8_t> out)   { ElementMin(Kernels().u8, a, b, out); }
+
+void Max(Span<const float> a, Span<const float> b, Span<float> out)         { ElementMax(Kernels().f32, a, b, out); }
+void Max(Span<const double> a, Span<const double> b, Span<double> out)      { ElementMax(Kernels().f64, a, b, out); }
+void Max(Span<const int32_t> a, Span<const int32_t> b, Span<int32_t> out)   { ElementMax(Kernels().i32, a, b, out); }
+void Max(Span<const uint8_t> a, Span<const uint8_t> b, Span<uint8_t> out)   { ElementMax(Kernels().u8, a, b, out); }
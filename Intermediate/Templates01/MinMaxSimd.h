@@ -0,0 +1,95 @@
+#pragma once
+
+/// ---------------------------------------------------------------------------------
+/// Min and Max over whole arrays, for float, double, int32_t and uint8_t.
+///
+///  - Min(values) / Max(values) reduce an array down to one value.
+///  - Min(a, b, out) / Max(a, b, out) work element by element: out[i] = Min(a[i], b[i]).
+///
+/// The work is done with SSE2 or AVX2 when the CPU has them, otherwise with plain
+/// C++. Which one we use is picked once, at startup, by asking the CPU what it
+/// supports.
+///
+/// The results are exactly what you'd get by calling the scalar templates in
+/// MinMax.h in a loop - including NaNs and -0.0/+0.0:
+///
+///     T result = values[0];
+///     for (size_t i = 1; i < count; i++)
+///         result = Min(result, values[i]);   // valueA < valueB ? valueA : valueB
+///
+/// Because `NaN < x` and `x < NaN` are both false, that loop hands back the *second*
+/// argument whenever a NaN is involved. So a NaN 'wins' for one step, and is then
+/// replaced by the next element. Conveniently, that's exactly what the SSE/AVX
+/// min/max instructions do too.
+/// ---------------------------------------------------------------------------------
+
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+#include <vector>
+
+/// A pointer and a count. std::span is C++20; this is all we need of it.
+/// The converting constructors only accept things with the same element type (give
+/// or take a const), so `Min(floats)` can't accidentally pick the double overload.
+template<typename T>
+struct Span
+{
+    T*     data;
+    size_t size;
+
+    Span(T* inData, size_t inSize) : data(inData), size(inSize) {}
+
+    template<size_t N>
+    Span(T (&array)[N]) : data(array), size(N) {}
+
+    template<typename U, typename = typename std::enable_if<std::is_convertible<U (*)[], T (*)[]>::value>::type>
+    Span(std::vector<U>& values) : data(values.data()), size(values.size()) {}
+
+    template<typename U, typename = typename std::enable_if<std::is_convertible<const U (*)[], T (*)[]>::value>::type>
+    Span(const std::vector<U>& values) : data(values.data()), size(values.size()) {}
+
+    // Span<float> -> Span<const float>
+    template<typename U, typename = typename std::enable_if<std::is_convertible<U (*)[], T (*)[]>::value>::type>
+    Span(const Span<U>& other) : data(other.data), size(other.size) {}
+};
+
+/// Reductions. `values` must not be empty.
+float   Min(Span<const float> values);
+double  Min(Span<const double> values);
+int32_t Min(Span<const int32_t> values);
+uint8_t Min(Span<const uint8_t> values);
+
+float   Max(Span<const float> values);
+double  Max(Span<const double> values);
+int32_t Max(Span<const int32_t> values);
+uint8_t Max(Span<const uint8_t> values);
+
+/// Element-wise. All three spans must be the same size.
+void Min(Span<const float> a, Span<const float> b, Span<float> out);
+void Min(Span<const double> a, Span<const double> b, Span<double> out);
+void Min(Span<const int32_t> a, Span<const int32_t> b, Span<int32_t> out);
+void Min(Span<const uint8_t> a, Span<const uint8_t> b, Span<uint8_t> out);
+
+void Max(Span<const float> a, Span<const float> b, Span<float> out);
+void Max(Span<const double> a, Span<const double> b, Span<double> out);
+void Max(Span<const int32_t> a, Span<const int32_t> b, Span<int32_t> out);
+void Max(Span<const uint8_t> a, Span<const uint8_t> b, Span<uint8_t> out);
+
+enum class SimdLevel
+{
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+/// The best level this CPU supports.
+SimdLevel DetectSimdLevel();
+
+/// The level the functions above are currently using.
+SimdLevel ActiveSimdLevel();
+
+/// Switch to a different level (to compare them, say). Asking for more than the CPU
+/// supports gets you the best it does support. Returns the level actually used.
+SimdLevel SetSimdLevel(SimdLevel level);
+
+const char* SimdLevelName(SimdLevel level);
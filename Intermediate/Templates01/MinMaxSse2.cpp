@@ -0,0 +1,99 @@
+/// The SSE2 kernels. Every x86-64 CPU has SSE2, but 32-bit builds need it turned on
+/// (-msse2, or /arch:SSE2 on MSVC which is the default there).
+#define MINMAX_KERNEL_FILE
+#include "MinMaxKernels.h"
+
+#if MINMAX_X86
+#include <math.h>
+#include <emmintrin.h>
+
+namespace
+{
+    struct Sse2Float
+    {
+        typedef float Scalar;
+        typedef __m128 Vector;
+        static const size_t kWidth = 4;
+        static const bool kHasNaN = true;
+
+        static Scalar Highest() { return HUGE_VALF; }
+        static Scalar Lowest() { return -HUGE_VALF; }
+        static Vector Load(const Scalar* values) { return _mm_loadu_ps(values); }
+        static void Store(Scalar* out, Vector value) { _mm_storeu_ps(out, value); }
+        static Vector Splat(Scalar value) { return _mm_set1_ps(value); }
+        // minps returns the second operand for NaNs and ties, just like `a < b ? a : b`
+        static Vector Min(Vector a, Vector b) { return _mm_min_ps(a, b); }
+        static Vector Max(Vector a, Vector b) { return _mm_max_ps(a, b); }
+        static bool HasNaN(Vector value) { return _mm_movemask_ps(_mm_cmpunord_ps(value, value)) != 0; }
+    };
+
+    struct Sse2Double
+    {
+        typedef double Scalar;
+        typedef __m128d Vector;
+        static const size_t kWidth = 2;
+        static const bool kHasNaN = true;
+
+        static Scalar Highest() { return HUGE_VAL; }
+        static Scalar Lowest() { return -HUGE_VAL; }
+        static Vector Load(const Scalar* values) { return _mm_loadu_pd(values); }
+        static void Store(Scalar* out, Vector value) { _mm_storeu_pd(out, value); }
+        static Vector Splat(Scalar value) { return _mm_set1_pd(value); }
+        static Vector Min(Vector a, Vector b) { return _mm_min_pd(a, b); }
+        static Vector Max(Vector a, Vector b) { return _mm_max_pd(a, b); }
+        static bool HasNaN(Vector value) { return _mm_movemask_pd(_mm_cmpunord_pd(value, value)) != 0; }
+    };
+
+    struct Sse2Int32
+    {
+        typedef int32_t Scalar;
+        typedef __m128i Vector;
+        static const size_t kWidth = 4;
+        static const bool kHasNaN = false;
+
+        static Scalar Highest() { return INT32_MAX; }
+        static Scalar Lowest() { return INT32_MIN; }
+        static Vector Load(const Scalar* values) { return _mm_loadu_si128((const __m128i*)values); }
+        static void Store(Scalar* out, Vector value) { _mm_storeu_si128((__m128i*)out, value); }
+        static Vector Splat(Scalar value) { return _mm_set1_epi32(value); }
+        static bool HasNaN(Vector) { return false; }
+
+        // pminsd is SSE4.1, so pick with a mask instead
+        static Vector Select(Vector mask, Vector a, Vector b)
+        {
+            return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+        }
+        static Vector Min(Vector a, Vector b) { return Select(_mm_cmplt_epi32(a, b), a, b); }
+        static Vector Max(Vector a, Vector b) { return Select(_mm_cmpgt_epi32(a, b), a, b); }
+    };
+
+    struct Sse2UInt8
+    {
+        typedef uint8_t Scalar;
+        typedef __m128i Vector;
+        static const size_t kWidth = 16;
+        static const bool kHasNaN = false;
+
+        static Scalar Highest() { return UINT8_MAX; }
+        static Scalar Lowest() { return 0; }
+        static Vector Load(const Scalar* values) { return _mm_loadu_si128((const __m128i*)values); }
+        static void Store(Scalar* out, Vector value) { _mm_storeu_si128((__m128i*)out, value); }
+        static Vector Splat(Scalar value) { return _mm_set1_epi8((char)value); }
+        static Vector Min(Vector a, Vector b) { return _mm_min_epu8(a, b); }
+        static Vector Max(Vector a, Vector b) { return _mm_max_epu8(a, b); }
+        static bool HasNaN(Vector) { return false; }
+    };
+}
+
+const MinMaxKernelTable& MinMaxKernelsSse2()
+{
+    static const MinMaxKernelTable table =
+    {
+        MakeKernelSet<Sse2Float>(),
+        MakeKernelSet<Sse2Double>(),
+        MakeKernelSet<Sse2Int32>(),
+        MakeKernelSet<Sse2UInt8>()
+    };
+    return table;
+}
+#endif
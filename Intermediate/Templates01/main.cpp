@@ -1,23 +1,148 @@
 // Example program
 #include <iostream>
 #include <string>
+#include <vector>
+#include <limits>
+#include <random>
+#include <string.h>
 
+#include "MinMax.h"
+#include "MinMaxSimd.h"
+
+// What the array versions have to match: the two value templates, in a loop
+template<typename T>
+T FoldMin(const std::vector<T>& values)
+{
+    T result = values[0];
+    for (size_t index = 1; index < values.size(); index++)
+        result = Min(result, values[index]);
+    return result;
+}
+
+template<typename T>
+T FoldMax(const std::vector<T>& values)
+{
+    T result = values[0];
+    for (size_t index = 1; index < values.size(); index++)
+        result = Max(result, values[index]);
+    return result;
+}
+
+// Compare the bits, so NaN matches NaN and -0.0 doesn't match +0.0
+template<typename T>
+bool SameBits(const T& valueA, const T& valueB)
+{
+    return memcmp(&valueA, &valueB, sizeof(T)) == 0;
+}
+
+template<typename T>
+bool SameBits(const std::vector<T>& valuesA, const std::vector<T>& valuesB)
+{
+    return memcmp(valuesA.data(), valuesB.data(), valuesA.size() * sizeof(T)) == 0;
+}
+
+// Mostly ordinary numbers, with a sprinkling of the awkward ones for floating point
 template<typename T>
-T Min(T valueA, T valueB)
+T RandomValue(std::mt19937& random)
 {
-    return valueA < valueB ? valueA : valueB;
+    if (std::numeric_limits<T>::is_integer)
+        return (T)random();
+
+    switch (random() % 16)
+    {
+    case 0:  return std::numeric_limits<T>::quiet_NaN();
+    case 1:  return (T)-0.0;
+    case 2:  return (T)0.0;
+    case 3:  return std::numeric_limits<T>::infinity();
+    case 4:  return -std::numeric_limits<T>::infinity();
+    default: return (T)((int)(random() % 2001) - 1000) / (T)8;
+    }
 }
 
+// Runs the array versions against the scalar templates over random arrays, and
+// returns the number of times they disagreed.
 template<typename T>
-T Max(T valueA, T valueB)
+int CheckAgainstScalar(std::mt19937& random, int rounds)
 {
-    return valueA > valueB ? valueA : valueB;
+    int failures = 0;
+
+    for (int round = 0; round < rounds; round++)
+    {
+        size_t count = 1 + random() % 200;
+        std::vector<T> valuesA(count), valuesB(count), out(count), expected(count);
+
+        for (size_t index = 0; index < count; index++)
+        {
+            valuesA[index] = RandomValue<T>(random);
+            valuesB[index] = RandomValue<T>(random);
+        }
+
+        if (!SameBits(Min(Span<const T>(valuesA)), FoldMin(valuesA)))
+            failures++;
+        if (!SameBits(Max(Span<const T>(valuesA)), FoldMax(valuesA)))
+            failures++;
+
+        for (size_t index = 0; index < count; index++)
+            expected[index] = Min(valuesA[index], valuesB[index]);
+        Min(Span<const T>(valuesA), Span<const T>(valuesB), Span<T>(out));
+        if (!SameBits(out, expected))
+            failures++;
+
+        for (size_t index = 0; index < count; index++)
+            expected[index] = Max(valuesA[index], valuesB[index]);
+        Max(Span<const T>(valuesA), Span<const T>(valuesB), Span<T>(out));
+        if (!SameBits(out, expected))
+            failures++;
+    }
+
+    return failures;
 }
 
+// Min and Max are constexpr, so the compiler can work these out for us
+static_assert(Min(3, 1, 2) == 1, "Min of three");
+static_assert(Max(4, 8, 15, 16, 23, 42) == 42, "Max of six");
+static_assert(noexcept(Min(1, 2)), "comparing ints can't throw");
+
 int main()
 {
     std::cout << "Min(8, 10): " << Min(10, 8) << std::endl;
     std::cout << "Min(8.0, 10.0): " << Min(10.0, 8.0) << std::endl;
     std::cout << "Min(8.0f, 10.0f): " << Min(10.0f, 8.0f) << std::endl;
     std::cout << "Min('A', 'a'): " << Min('A', 'a') << std::endl;
-}
\ No newline at end of file
+
+    // Both are variables, so we get a reference to one of them back - no copies
+    std::string apple("apple");
+    std::string banana("banana");
+    std::string cherry("cherry");
+    const std::string& first = Min(apple, banana, cherry);
+    std::cout << "Min(\"apple\", \"banana\", \"cherry\"): " << first << std::endl;
+
+    // With a comparator: the longest name
+    const std::string& longest = Max(apple, banana, [](const std::string& valueA, const std::string& valueB)
+    {
+        return valueA.size() < valueB.size();
+    });
+    std::cout << "Longest of \"apple\" and \"banana\": " << longest << std::endl;
+
+    float values[] = { 4.0f, 2.5f, 9.0f, -1.0f, 7.5f };
+    std::cout << "Min({4, 2.5, 9, -1, 7.5}): " << Min(Span<const float>(values)) << std::endl;
+    std::cout << "Max({4, 2.5, 9, -1, 7.5}): " << Max(Span<const float>(values)) << std::endl;
+
+    // Try every instruction set this CPU has against the scalar templates
+    SimdLevel best = DetectSimdLevel();
+    for (int level = (int)SimdLevel::Scalar; level <= (int)best; level++)
+    {
+        SetSimdLevel((SimdLevel)level);
+
+        std::mt19937 random(1234);
+        const int rounds = 1000;
+        int failures = CheckAgainstScalar<float>(random, rounds)
+                     + CheckAgainstScalar<double>(random, rounds)
+                     + CheckAgainstScalar<int32_t>(random, rounds)
+                     + CheckAgainstScalar<uint8_t>(random, rounds);
+
+        std::cout << SimdLevelName((SimdLevel)level) << ": " << failures << " mismatches in "
+                  << 4 * 4 * rounds << " random checks" << std::endl;
+    }
+    SetSimdLevel(best);
+}
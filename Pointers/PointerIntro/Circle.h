@@ -2,7 +2,7 @@
 
 #include "Shape.h"
 
-class Circle : public VirtualShape
+class Circle : public VirtualShape, public PoolAllocated<Circle>
 {
 public:
     Circle();
@@ -12,5 +12,8 @@ public:
 
     virtual void Draw() override;
 
+    // Defined here so that a non-virtual call (see ShapeDispatch.h) can be inlined
+    virtual float Area() const override { return 3.14159265f * mRadius * mRadius; }
+
     float mRadius;
 };
\ No newline at end of file
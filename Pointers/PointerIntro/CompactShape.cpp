@@ -0,0 +1,94 @@
+#include "CompactShape.h"
+
+#include <stdio.h>
+
+// A quiet NaN: what a height of exactly kCircleTag turns into
+static const uint32_t kQuietNaN = 0x7FC00000u;
+
+CompactShape::CompactShape()
+    : mX(0.0f)
+    , mY(0.0f)
+    , mSize(1.0f)
+    , mTagOrHeight(kCircleTag)
+{
+}
+
+CompactShape::CompactShape(const Circle& circle)
+    : mX(circle.mCenter.x)
+    , mY(circle.mCenter.y)
+    , mSize(circle.mRadius)
+    , mTagOrHeight(kCircleTag)
+{
+}
+
+CompactShape::CompactShape(const Rectangle& rectangle)
+    : mX(rectangle.mCenter.x)
+    , mY(rectangle.mCenter.y)
+    , mSize(rectangle.mWidth)
+{
+    // Copied as bits, so that whatever NaN might be in there comes through untouched
+    memcpy(&mTagOrHeight, &rectangle.mHeight, sizeof(mTagOrHeight));
+    if (mTagOrHeight == kCircleTag)
+        mTagOrHeight = kQuietNaN;
+}
+
+CompactShape CompactShape::MakeCircle(float inX, float inY, float radius)
+{
+    CompactShape shape;
+    shape.mX = inX;
+    shape.mY = inY;
+    shape.mSize = radius;
+    shape.mTagOrHeight = kCircleTag;
+    return shape;
+}
+
+CompactShape CompactShape::MakeRectangle(float inX, float inY, float width, float height)
+{
+    CompactShape shape;
+    shape.mX = inX;
+    shape.mY = inY;
+    shape.mSize = width;
+    memcpy(&shape.mTagOrHeight, &height, sizeof(shape.mTagOrHeight));
+    if (shape.mTagOrHeight == kCircleTag)
+        shape.mTagOrHeight = kQuietNaN;
+    return shape;
+}
+
+Circle CompactShape::ToCircle() const
+{
+    return Circle(mX, mY, mSize);
+}
+
+Rectangle CompactShape::ToRectangle() const
+{
+    Rectangle rectangle(mX, mY, mSize, 0.0f);
+    memcpy(&rectangle.mHeight, &mTagOrHeight, sizeof(rectangle.mHeight));
+    return rectangle;
+}
+
+void CompactShape::Draw() const
+{
+    switch (GetType())
+    {
+    case kCircle:
+        printf("Drawing a circle at (%f,%f), radius %f\n", mX, mY, mSize);
+        break;
+
+    case kRectangle:
+    {
+        float height = Height();
+        printf("Drawing a rectangle at (%f, %f, %f, %f)\n",
+            mX - (mSize / 2.0f), mY - (height / 2.0f),
+            mX + (mSize / 2.0f), mY + (height / 2.0f));
+        break;
+    }
+    }
+}
+
+void DrawShapes(const CompactShape* shapes, size_t count)
+{
+    for (size_t index = 0; index < count; index++)
+    {
+        shapes[index].Draw();
+    }
+}
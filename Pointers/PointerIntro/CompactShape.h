@@ -0,0 +1,94 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "Circle.h"
+#include "Rectangle.h"
+
+/// ---------------------------------------------------------------------------------
+/// A Circle or a Rectangle in 16 bytes, with no vptr.
+///
+/// main.cpp prints how big a Circle and a Rectangle are: 24 bytes each, and 8 of
+/// those are the vptr. Holding them through VirtualShape* adds an 8 byte pointer and
+/// a separate allocation per shape, and std::variant<Circle, Rectangle> (see
+/// ShapeDispatch.h) is 32 bytes. A CompactShape is 16, so four of them fit in a
+/// 64 byte cache line.
+///
+/// A rectangle needs all 16 bytes for its x, y, width and height, so where does the
+/// type go? Into a value a rectangle's height can't sensibly have. A float whose bits
+/// are all ones in the exponent is a NaN ('not a number'), and there are millions of
+/// different NaNs, differing only in the other bits. A circle only needs 12 bytes, so
+/// it fills the last 4 with one particular NaN, kCircleTag. Anything else there is a
+/// rectangle's height.
+///
+/// kCircleTag is a 'signalling' NaN: arithmetic never produces one (it only makes
+/// 'quiet' NaNs), so no real height will ever be that value. Converting from and back
+/// to a Circle or a Rectangle gives back exactly the same bits - except for a
+/// Rectangle whose height is exactly kCircleTag, which you'd have to go out of your way
+/// to make, and whose height comes back as an ordinary quiet NaN.
+///
+/// The height is kept as its bits, not as a float: on 32 bit x86, copying a float
+/// through the old x87 registers can quietly turn a signalling NaN into a quiet one.
+///
+/// Draw() and Area() switch on the type instead of making a virtual call, so the
+/// compiler can inline them into a loop over an array of CompactShapes.
+/// ---------------------------------------------------------------------------------
+class CompactShape
+{
+public:
+    enum Type
+    {
+        kCircle,
+        kRectangle
+    };
+
+    /// The bits of the NaN in a circle's last 4 bytes
+    static const uint32_t kCircleTag = 0x7F81C1E5u;
+
+    CompactShape();
+    explicit CompactShape(const Circle& circle);
+    explicit CompactShape(const Rectangle& rectangle);
+
+    static CompactShape MakeCircle(float inX, float inY, float radius);
+    static CompactShape MakeRectangle(float inX, float inY, float width, float height);
+
+    Type GetType() const { return mTagOrHeight == kCircleTag ? kCircle : kRectangle; }
+    bool IsCircle() const { return mTagOrHeight == kCircleTag; }
+
+    Point2D Center() const { return Point2D(mX, mY); }
+    float Radius() const { return mSize; }      ///< Circles only
+    float Width() const { return mSize; }       ///< Rectangles only
+    float Height() const;                       ///< Rectangles only
+
+    /// Back to the real thing. Only call the one that matches GetType().
+    Circle ToCircle() const;
+    Rectangle ToRectangle() const;
+
+    /// The same output as Circle::Draw() or Rectangle::Draw()
+    void Draw() const;
+
+    float Area() const
+    {
+        return IsCircle() ? 3.14159265f * mSize * mSize : mSize * Height();
+    }
+
+private:
+    float    mX;
+    float    mY;
+    float    mSize;         ///< A circle's radius, or a rectangle's width
+    uint32_t mTagOrHeight;  ///< kCircleTag, or the bits of a rectangle's height
+};
+
+static_assert(sizeof(CompactShape) == 16, "CompactShape should be 16 bytes");
+
+inline float CompactShape::Height() const
+{
+    float height;
+    memcpy(&height, &mTagOrHeight, sizeof(height));
+    return height;
+}
+
+/// Calls Draw() on each of them, in order.
+void DrawShapes(const CompactShape* shapes, size_t count);
@@ -0,0 +1,168 @@
+#include "PoolAllocator.h"
+
+#include <assert.h>
+#include <string.h>
+
+static size_t RoundUp(size_t value, size_t multiple)
+{
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+bool IsPoisoned(const void* memory, size_t size)
+{
+    const unsigned char* bytes = (const unsigned char*)memory;
+    for (size_t index = 0; index < size; index++)
+    {
+        if (bytes[index] != kPoisonByte)
+            return false;
+    }
+    return size > 0;
+}
+
+/// ---------------------------------------------------------------------------------
+/// FixedBlockPool
+/// ---------------------------------------------------------------------------------
+FixedBlockPool::FixedBlockPool(size_t objectSize, size_t blocksPerChunk)
+    : mObjectSize(objectSize)
+    , mBlocksPerChunk(blocksPerChunk > 0 ? blocksPerChunk : 1)
+    , mChunkIndex(0)
+    , mNextBlock(0)
+    , mFreeList(nullptr)
+    , mLiveCount(0)
+{
+    size_t size = objectSize < sizeof(void*) ? sizeof(void*) : objectSize;
+    if (POOL_POISONING)
+        size = RoundUp(size, sizeof(void*)) + sizeof(void*);
+    mBlockSize = RoundUp(size, alignof(std::max_align_t));
+}
+
+FixedBlockPool::~FixedBlockPool()
+{
+    for (char* chunk : mChunks)
+    {
+        delete[] chunk;
+    }
+}
+
+void* FixedBlockPool::Allocate()
+{
+    void* block = nullptr;
+
+    if (mFreeList != nullptr)
+    {
+        block = mFreeList;
+        mFreeList = LinkOf(block);
+    }
+    else
+    {
+        if (mChunkIndex < mChunks.size() && mNextBlock == mBlocksPerChunk)
+        {
+            mChunkIndex++;
+            mNextBlock = 0;
+        }
+
+        if (mChunkIndex == mChunks.size())
+        {
+            mChunks.push_back(new char[mBlockSize * mBlocksPerChunk]);
+        }
+
+        block = mChunks[mChunkIndex] + mNextBlock * mBlockSize;
+        mNextBlock++;
+    }
+
+    mLiveCount++;
+    return block;
+}
+
+void FixedBlockPool::Free(void* block)
+{
+    if (block == nullptr)
+        return;
+
+    assert(mLiveCount > 0);
+
+    if (POOL_POISONING)
+        memset(block, kPoisonByte, mBlockSize);
+
+    LinkOf(block) = mFreeList;
+    mFreeList = block;
+    mLiveCount--;
+}
+
+void FixedBlockPool::Reset()
+{
+    // Poisoning is the only part that touches every block, and that's debug only.
+    if (POOL_POISONING)
+    {
+        for (char* chunk : mChunks)
+        {
+            memset(chunk, kPoisonByte, mBlockSize * mBlocksPerChunk);
+        }
+    }
+
+    mChunkIndex = 0;
+    mNextBlock = 0;
+    mFreeList = nullptr;
+    mLiveCount = 0;
+}
+
+/// ---------------------------------------------------------------------------------
+/// FrameArena
+/// ---------------------------------------------------------------------------------
+FrameArena::FrameArena(size_t chunkSize)
+    : mChunkSize(chunkSize > 0 ? chunkSize : 1)
+    , mChunkIndex(0)
+    , mOffset(0)
+    , mBytesUsed(0)
+{}
+
+FrameArena::~FrameArena()
+{
+    for (Chunk& chunk : mChunks)
+    {
+        delete[] chunk.memory;
+    }
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+    // Try the current chunk, then any chunks left over from before the last Reset()
+    for (; mChunkIndex < mChunks.size(); mChunkIndex++, mOffset = 0)
+    {
+        Chunk& chunk = mChunks[mChunkIndex];
+        size_t start = RoundUp((size_t)chunk.memory + mOffset, alignment) - (size_t)chunk.memory;
+        if (start + size <= chunk.size)
+        {
+            mOffset = start + size;
+            mBytesUsed += size;
+            return chunk.memory + start;
+        }
+    }
+
+    // Nothing fits; anything bigger than a chunk gets a chunk of its own
+    Chunk chunk;
+    chunk.size = size + alignment > mChunkSize ? size + alignment : mChunkSize;
+    chunk.memory = new char[chunk.size];
+    mChunks.push_back(chunk);
+    mChunkIndex = mChunks.size() - 1;
+
+    size_t start = RoundUp((size_t)chunk.memory, alignment) - (size_t)chunk.memory;
+    mOffset = start + size;
+    mBytesUsed += size;
+    return chunk.memory + start;
+}
+
+void FrameArena::Reset()
+{
+    if (POOL_POISONING)
+    {
+        for (Chunk& chunk : mChunks)
+        {
+            memset(chunk.memory, kPoisonByte, chunk.size);
+        }
+    }
+
+    mChunkIndex = 0;
+    mOffset = 0;
+    mBytesUsed = 0;
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+/// ---------------------------------------------------------------------------------
+/// Two alternatives to calling the global new/delete for every single shape.
+///
+/// FixedBlockPool: hands out blocks that are all the same size, carved out of big
+/// chunks. Allocating is popping a free list (or bumping a pointer), freeing is
+/// pushing onto the free list - no malloc, no searching, no fragmentation.
+///
+/// FrameArena: hands out any size at all by bumping a pointer, and can't free
+/// anything individually. Instead you Reset() the whole thing at once, e.g. at the
+/// end of every frame, or when you're done with a scene.
+///
+/// Both Reset() in O(1): they just forget what they've handed out and start again
+/// from the beginning of the memory they already have. Destructors are NOT run, so
+/// only do that to objects that don't need them.
+///
+/// In debug builds, memory that's been freed (or reset) is filled with 0xDD. Read a
+/// pointer out of a deleted object and you get 0xDDDDDDDD..., which is easy to spot
+/// in the debugger - and calling a virtual function through it crashes right there,
+/// instead of quietly working until somebody else reuses the memory.
+///
+/// Neither is thread safe.
+/// ---------------------------------------------------------------------------------
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+#if !defined(POOL_POISONING)
+#if defined(NDEBUG)
+#define POOL_POISONING 0
+#else
+#define POOL_POISONING 1
+#endif
+#endif
+
+const unsigned char kPoisonByte = 0xDD;
+
+/// True if every byte in [memory, memory + size) is kPoisonByte.
+bool IsPoisoned(const void* memory, size_t size);
+
+class FixedBlockPool
+{
+public:
+    FixedBlockPool(size_t objectSize, size_t blocksPerChunk = 256);
+    ~FixedBlockPool();
+
+    FixedBlockPool(const FixedBlockPool&) = delete;
+    FixedBlockPool& operator=(const FixedBlockPool&) = delete;
+
+    void* Allocate();
+    void Free(void* block);
+
+    /// Every block goes back to the pool; the chunks are kept for next time.
+    void Reset();
+
+    size_t ObjectSize() const { return mObjectSize; }
+    size_t BlockSize() const { return mBlockSize; }
+    size_t LiveCount() const { return mLiveCount; }
+    size_t ChunkCount() const { return mChunks.size(); }
+
+private:
+    // The free list is threaded through the freed blocks. The link lives in the
+    // last pointer-sized slot of each block, so it doesn't overwrite the first few
+    // bytes (where a vtable pointer would be). In debug builds the block gets an
+    // extra slot for it, so the whole object can be poisoned.
+    void*& LinkOf(void* block) const { return *(void**)((char*)block + mBlockSize - sizeof(void*)); }
+
+    size_t mObjectSize;
+    size_t mBlockSize;
+    size_t mBlocksPerChunk;
+
+    std::vector<char*> mChunks;
+    size_t mChunkIndex;     // the chunk we're carving new blocks out of
+    size_t mNextBlock;      // the first block in that chunk that's never been used
+    void*  mFreeList;
+    size_t mLiveCount;
+};
+
+class FrameArena
+{
+public:
+    explicit FrameArena(size_t chunkSize = 64 * 1024);
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    /// `arena.New<Circle>(x, y, radius)`: allocate and construct in one go.
+    template<typename T, typename... Args>
+    T* New(Args&&... args)
+    {
+        return ::new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    /// Forget everything that was allocated. Destructors are not run.
+    void Reset();
+
+    size_t BytesUsed() const { return mBytesUsed; }
+    size_t ChunkCount() const { return mChunks.size(); }
+
+private:
+    struct Chunk
+    {
+        char*  memory;
+        size_t size;
+    };
+
+    std::vector<Chunk> mChunks;
+    size_t mChunkSize;
+    size_t mChunkIndex;
+    size_t mOffset;         // into mChunks[mChunkIndex]
+    size_t mBytesUsed;
+};
+
+/// ---------------------------------------------------------------------------------
+/// Derive from PoolAllocated<YourClass> and `new YourClass` comes out of a
+/// FixedBlockPool just for YourClass, instead of the global heap:
+///
+///     class Circle : public VirtualShape, public PoolAllocated<Circle>
+///
+/// `delete` works through a base class pointer too, as long as the destructor is
+/// virtual - the compiler looks up operator delete in the class actually being
+/// deleted. Classes derived from YourClass are a different size, so they quietly go
+/// back to the global heap unless they opt in themselves.
+/// ---------------------------------------------------------------------------------
+template<typename T>
+class PoolAllocated
+{
+public:
+    static void* operator new(size_t size)
+    {
+        if (size != sizeof(T))
+            return ::operator new(size);
+        return Pool().Allocate();
+    }
+
+    static void operator delete(void* memory, size_t size)
+    {
+        if (memory == nullptr)
+            return;
+
+        if (size != sizeof(T))
+            ::operator delete(memory);
+        else
+            Pool().Free(memory);
+    }
+
+    /// Frees every T in one go, without running their destructors.
+    static void ResetPool() { Pool().Reset(); }
+
+    static size_t LiveCount() { return Pool().LiveCount(); }
+
+    /// Debug builds only: has `object` been deleted? (Always false in release.)
+    static bool IsFreed(const T* object) { return POOL_POISONING && IsPoisoned(object, sizeof(T)); }
+
+private:
+    static FixedBlockPool& Pool()
+    {
+        static FixedBlockPool pool(sizeof(T));
+        return pool;
+    }
+};
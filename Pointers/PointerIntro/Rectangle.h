@@ -1,7 +1,7 @@
 #pragma once
 #include "Shape.h"
 
-class Rectangle : public VirtualShape
+class Rectangle : public VirtualShape, public PoolAllocated<Rectangle>
 {
 public:
     Rectangle();
@@ -11,6 +11,8 @@ public:
 
     virtual void Draw() override;
 
+    virtual float Area() const override { return mWidth * mHeight; }
+
     float mWidth;
     float mHeight;
 };
@@ -54,3 +54,8 @@ void VirtualShape::Draw()
 {
     printf("  -> Drawing a shape\n");
 }
+
+float VirtualShape::Area() const
+{
+    return 0.0f;
+}
@@ -1,19 +1,10 @@
 #pragma once
 
-struct Point2D
-{
-    float x;
-    float y;
-
-    Point2D() : x(0.0f), y(0.0f) {}
-    Point2D(float inX, float inY)
-    {
-        x = inX;
-        y = inY;
-    }
-};
+#include "Math2D.h"
+#include "PoolAllocator.h"
 
-class Shape
+// Shapes come out of a pool rather than the global heap; see PoolAllocator.h
+class Shape : public PoolAllocated<Shape>
 {
 public:
     Shape();
@@ -64,4 +55,8 @@ public:
     Point2D mCenter;
 
     virtual void Draw();
+
+    // Something cheap to call, so we can measure the cost of the virtual call
+    // itself (Draw() spends all its time in printf).
+    virtual float Area() const;
 };
\ No newline at end of file
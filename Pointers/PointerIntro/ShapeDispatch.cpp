@@ -0,0 +1,15 @@
+#include "ShapeDispatch.h"
+
+#include <stdio.h>
+
+void StaticCircle::DrawShape()
+{
+    printf("Drawing a circle at (%f,%f), radius %f\n", mCenter.x, mCenter.y, mRadius);
+}
+
+void StaticRectangle::DrawShape()
+{
+    printf("Drawing a rectangle at (%f, %f, %f, %f)\n",
+        mCenter.x - (mWidth / 2.0f), mCenter.y - (mHeight / 2.0f),
+        mCenter.x + (mWidth / 2.0f), mCenter.y + (mHeight / 2.0f));
+}
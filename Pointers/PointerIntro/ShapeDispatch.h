@@ -0,0 +1,108 @@
+#pragma once
+
+/// ---------------------------------------------------------------------------------
+/// Two ways of calling Draw() on a bunch of shapes without a virtual call.
+///
+/// A virtual call has to load the vptr out of the object, load the function address
+/// out of the vtable, then make an indirect call that the compiler can't inline. That's
+/// the price of being able to add new kinds of shapes without touching the code that
+/// draws them. If we *know* that Circle and Rectangle are the only shapes there will
+/// ever be (a 'closed' hierarchy), we can skip all of that.
+///
+/// 1. std::variant<Circle, Rectangle>
+///    Each element holds one or the other, by value, plus a small index saying which.
+///    std::visit switches on that index and calls the right function directly; the
+///    shapes sit next to each other in one std::vector, in whatever order you like.
+///
+/// 2. CRTP (the Curiously Recurring Template Pattern)
+///    StaticShape<Derived> knows, at compile time, what it really is, so
+///    `static_cast<Derived*>(this)->DrawShape()` is a plain (inlinable) call. There's
+///    no common base class to point at, though, so each type lives in its own vector.
+///
+/// std::variant needs C++17, which the VS2015 (v140) project doesn't have, so these
+/// are only built by CMake (see the README at the top of the repo).
+/// ---------------------------------------------------------------------------------
+
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "Circle.h"
+#include "Rectangle.h"
+
+typedef std::variant<Circle, Rectangle> ShapeVariant;
+
+// `concrete.Shape::Draw()` names the function outright, so it isn't a virtual call
+// even though Draw() is virtual.
+inline void Draw(ShapeVariant& shape)
+{
+    std::visit([](auto& concrete)
+    {
+        typedef typename std::decay<decltype(concrete)>::type Concrete;
+        concrete.Concrete::Draw();
+    }, shape);
+}
+
+inline float Area(const ShapeVariant& shape)
+{
+    return std::visit([](const auto& concrete)
+    {
+        typedef typename std::decay<decltype(concrete)>::type Concrete;
+        return concrete.Concrete::Area();
+    }, shape);
+}
+
+template<typename Derived>
+class StaticShape
+{
+public:
+    StaticShape() : mCenter(0.0f, 0.0f) {}
+    StaticShape(float inX, float inY) : mCenter(inX, inY) {}
+
+    void Draw() { static_cast<Derived*>(this)->DrawShape(); }
+    float Area() const { return static_cast<const Derived*>(this)->ShapeArea(); }
+
+    Point2D mCenter;
+};
+
+class StaticCircle : public StaticShape<StaticCircle>
+{
+public:
+    StaticCircle() : mRadius(1.0f) {}
+    StaticCircle(float inX, float inY, float radius) : StaticShape(inX, inY), mRadius(radius) {}
+
+    void DrawShape();
+    float ShapeArea() const { return 3.14159265f * mRadius * mRadius; }
+
+    float mRadius;
+};
+
+class StaticRectangle : public StaticShape<StaticRectangle>
+{
+public:
+    StaticRectangle() : mWidth(1.0f), mHeight(1.0f) {}
+    StaticRectangle(float inX, float inY, float width, float height) : StaticShape(inX, inY), mWidth(width), mHeight(height) {}
+
+    void DrawShape();
+    float ShapeArea() const { return mWidth * mHeight; }
+
+    float mWidth;
+    float mHeight;
+};
+
+/// All the CRTP shapes, one vector per type.
+struct StaticShapeList
+{
+    std::vector<StaticCircle>    circles;
+    std::vector<StaticRectangle> rectangles;
+
+    /// Calls `function(shape)` on every circle, then every rectangle.
+    template<typename Function>
+    void ForEach(Function function)
+    {
+        for (StaticCircle& circle : circles)
+            function(circle);
+        for (StaticRectangle& rectangle : rectangles)
+            function(rectangle);
+    }
+};
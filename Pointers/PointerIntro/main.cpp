@@ -8,12 +8,19 @@
 #include <conio.h>
 #include <memory.h>
 
+#include "AllocationTracker.h"
 #include "Shape.h"
 #include "Circle.h"
 #include "Rectangle.h"
+#include "CompactShape.h"
 
 void main()
 {
+    // Every `new` in here goes through AllocationTracker.cpp. There are only a few of
+    // them, so record where each one came from, and say what's left over at exit.
+    SetAllocationSampleInterval(1);
+    ReportLeaksAtExit();
+
     printf("How big is a Shape? %lu\n", sizeof(Shape));
 
     // A few standard ways of accessing pointers.
@@ -58,6 +65,13 @@ void main()
     // And now delete everything you've allocated
     printf("Deleting prtShapeB\n");
     delete ptrShapeB;
+
+    // Shape comes out of a pool (see PoolAllocator.h), and in debug builds the pool
+    // fills deleted Shapes with 0xDD. So we can tell that ptrShapeC is now pointing at
+    // a Shape that doesn't exist any more.
+    if (Shape::IsFreed(ptrShapeC))
+        printf("ptrShapeC points at a deleted Shape!\n");
+
     memset(ptrShapeB, 0, sizeof(Shape));  // Mimicing someone else re-using the memory that was just freed
 
     ptrShapeC->Draw();
@@ -79,6 +93,9 @@ void main()
     printf("What's the size of a Circle? %lu\n", sizeof(Circle));
     printf("What's the size of a Rectangle? %lu\n", sizeof(Rectangle));
 
+    // Either one, without the vptr: the type is hidden in the last 4 bytes
+    printf("What's the size of a CompactShape? %lu\n", sizeof(CompactShape));
+
     Shape* shapeNoVirtual = new Shape();
 
     shapeNoVirtual->Draw();
@@ -91,6 +108,22 @@ void main()
 
     shapeRectangleVirtual->Draw();
 
+    // The same two shapes, drawn by switching on the type instead of a virtual call
+    CompactShape compactShapes[] =
+    {
+        CompactShape(*static_cast<Circle*>(shapeCircleVirtual)),
+        CompactShape(*static_cast<Rectangle*>(shapeRectangleVirtual)),
+    };
+    DrawShapes(compactShapes, 2);
+
+    // shapeNoVirtual, shapeCircleVirtual and shapeRectangleVirtual are never deleted.
+    // They came out of the pools, though, not straight from the heap, so the tracker
+    // only sees the pools' chunks - and the pools give those back when the program
+    // exits. The pools themselves know how many of their objects are still alive.
+    printf("Shapes never deleted: %u Shape, %u Circle, %u Rectangle\n",
+           (unsigned)Shape::LiveCount(), (unsigned)Circle::LiveCount(), (unsigned)Rectangle::LiveCount());
+    PrintAllocationReport(stdout);
+
     printf("Press any key to continue:");
     _getch();
 }
\ No newline at end of file
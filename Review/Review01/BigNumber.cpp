@@ -0,0 +1,449 @@
+#include "BigNumber.h"
+
+#include <string.h>
+#include <algorithm>
+
+// Below this many limbs, the plain O(n^2) multiply beats Karatsuba.
+static const size_t kKaratsubaThreshold = 32;
+
+// dst[0..dstLength) += src[0..srcLength). dstLength must be >= srcLength, and the
+// result must fit in dstLength limbs.
+static void AddInto(uint32_t* dst, size_t dstLength, const uint32_t* src, size_t srcLength)
+{
+    uint64_t carry = 0;
+    size_t index = 0;
+
+    for (; index < srcLength; index++)
+    {
+        uint64_t sum = (uint64_t)dst[index] + src[index] + carry;
+        dst[index] = (uint32_t)sum;
+        carry = sum >> 32;
+    }
+
+    for (; carry != 0 && index < dstLength; index++)
+    {
+        uint64_t sum = (uint64_t)dst[index] + carry;
+        dst[index] = (uint32_t)sum;
+        carry = sum >> 32;
+    }
+}
+
+// dst[0..dstLength) -= src[0..srcLength). The result must not go negative.
+static void SubtractFrom(uint32_t* dst, size_t dstLength, const uint32_t* src, size_t srcLength)
+{
+    uint64_t borrow = 0;
+    size_t index = 0;
+
+    for (; index < srcLength; index++)
+    {
+        uint64_t difference = (uint64_t)dst[index] - src[index] - borrow;
+        dst[index] = (uint32_t)difference;
+        borrow = (difference >> 32) & 1;
+    }
+
+    for (; borrow != 0 && index < dstLength; index++)
+    {
+        uint64_t difference = (uint64_t)dst[index] - borrow;
+        dst[index] = (uint32_t)difference;
+        borrow = (difference >> 32) & 1;
+    }
+}
+
+static size_t TrimmedLength(const uint32_t* limbs, size_t length)
+{
+    while (length > 0 && limbs[length - 1] == 0)
+        length--;
+
+    return length;
+}
+
+// out[0..aLength + bLength) = a * b. `out` must start zeroed.
+static void MultiplySchoolbook(const uint32_t* a, size_t aLength, const uint32_t* b, size_t bLength, uint32_t* out)
+{
+    for (size_t i = 0; i < aLength; i++)
+    {
+        uint64_t carry = 0;
+        uint64_t digit = a[i];
+
+        for (size_t j = 0; j < bLength; j++)
+        {
+            uint64_t product = digit * b[j] + out[i + j] + carry;
+            out[i + j] = (uint32_t)product;
+            carry = product >> 32;
+        }
+
+        out[i + bLength] = (uint32_t)carry;
+    }
+}
+
+// out[0..aLength + bLength) = a * b. `out` must start zeroed.
+static void MultiplyKaratsuba(const uint32_t* a, size_t aLength, const uint32_t* b, size_t bLength, uint32_t* out)
+{
+    if (aLength < bLength)
+    {
+        std::swap(a, b);
+        std::swap(aLength, bLength);
+    }
+
+    if (bLength < kKaratsubaThreshold)
+    {
+        MultiplySchoolbook(a, aLength, b, bLength, out);
+        return;
+    }
+
+    // Very lopsided: multiply `b` by one `bLength` sized slice of `a` at a time.
+    if (2 * bLength <= aLength)
+    {
+        std::vector<uint32_t> partial;
+
+        for (size_t offset = 0; offset < aLength; offset += bLength)
+        {
+            size_t sliceLength = std::min(bLength, aLength - offset);
+            partial.assign(sliceLength + bLength, 0);
+            MultiplyKaratsuba(a + offset, sliceLength, b, bLength, partial.data());
+            AddInto(out + offset, aLength + bLength - offset, partial.data(), partial.size());
+        }
+        return;
+    }
+
+    // a = a1 * B^half + a0, b = b1 * B^half + b0
+    // a * b = z2 * B^(2 * half) + z1 * B^half + z0, where
+    //  z0 = a0 * b0, z2 = a1 * b1 and z1 = (a0 + a1)(b0 + b1) - z0 - z2
+    size_t half = aLength / 2;
+    const uint32_t* a0 = a;
+    const uint32_t* a1 = a + half;
+    const uint32_t* b0 = b;
+    const uint32_t* b1 = b + half;
+    size_t a1Length = aLength - half;
+    size_t b1Length = bLength - half;
+
+    std::vector<uint32_t> aSum(a1, a1 + a1Length);
+    aSum.push_back(0);
+    AddInto(aSum.data(), aSum.size(), a0, half);
+
+    size_t bSumLength = std::max(half, b1Length) + 1;
+    std::vector<uint32_t> bSum(b0, b0 + half);
+    bSum.resize(bSumLength, 0);
+    AddInto(bSum.data(), bSum.size(), b1, b1Length);
+
+    size_t aSumLength = TrimmedLength(aSum.data(), aSum.size());
+    bSumLength = TrimmedLength(bSum.data(), bSum.size());
+
+    std::vector<uint32_t> z1(aSum.size() + bSum.size(), 0);
+    MultiplyKaratsuba(aSum.data(), aSumLength, bSum.data(), bSumLength, z1.data());
+
+    // z0 and z2 go straight into their final place in `out`; they don't overlap.
+    MultiplyKaratsuba(a0, half, b0, half, out);
+    MultiplyKaratsuba(a1, a1Length, b1, b1Length, out + 2 * half);
+
+    SubtractFrom(z1.data(), z1.size(), out, 2 * half);
+    SubtractFrom(z1.data(), z1.size(), out + 2 * half, a1Length + b1Length);
+
+    AddInto(out + half, aLength + bLength - half, z1.data(), TrimmedLength(z1.data(), z1.size()));
+}
+
+static int CountLeadingZeros(uint32_t value)
+{
+    int count = 0;
+    while ((value & 0x80000000u) == 0)
+    {
+        value <<= 1;
+        count++;
+    }
+    return count;
+}
+
+BigNumber::BigNumber()
+{}
+
+BigNumber::BigNumber(uint64_t value)
+{
+    while (value != 0)
+    {
+        mLimbs.push_back((uint32_t)value);
+        value >>= 32;
+    }
+}
+
+void BigNumber::Trim()
+{
+    mLimbs.resize(TrimmedLength(mLimbs.data(), mLimbs.size()));
+}
+
+int BigNumber::Compare(const BigNumber& other) const
+{
+    if (mLimbs.size() != other.mLimbs.size())
+        return mLimbs.size() < other.mLimbs.size() ? -1 : 1;
+
+    for (size_t index = mLimbs.size(); index > 0; index--)
+    {
+        if (mLimbs[index - 1] != other.mLimbs[index - 1])
+            return mLimbs[index - 1] < other.mLimbs[index - 1] ? -1 : 1;
+    }
+
+    return 0;
+}
+
+BigNumber operator+(const BigNumber& a, const BigNumber& b)
+{
+    const BigNumber& longer = a.mLimbs.size() >= b.mLimbs.size() ? a : b;
+    const BigNumber& shorter = a.mLimbs.size() >= b.mLimbs.size() ? b : a;
+
+    BigNumber result(longer);
+    result.mLimbs.push_back(0);
+    AddInto(result.mLimbs.data(), result.mLimbs.size(), shorter.mLimbs.data(), shorter.mLimbs.size());
+    result.Trim();
+    return result;
+}
+
+BigNumber operator-(const BigNumber& a, const BigNumber& b)
+{
+    BigNumber result(a);
+    SubtractFrom(result.mLimbs.data(), result.mLimbs.size(), b.mLimbs.data(), b.mLimbs.size());
+    result.Trim();
+    return result;
+}
+
+BigNumber operator*(const BigNumber& a, const BigNumber& b)
+{
+    BigNumber result;
+    if (a.IsZero() || b.IsZero())
+        return result;
+
+    result.mLimbs.assign(a.mLimbs.size() + b.mLimbs.size(), 0);
+    MultiplyKaratsuba(a.mLimbs.data(), a.mLimbs.size(), b.mLimbs.data(), b.mLimbs.size(), result.mLimbs.data());
+    result.Trim();
+    return result;
+}
+
+void BigNumber::DivideModulo(const BigNumber& a, const BigNumber& b, BigNumber& quotient, BigNumber& remainder)
+{
+    if (a.Compare(b) < 0)
+    {
+        remainder = a;
+        quotient = BigNumber();
+        return;
+    }
+
+    size_t m = a.mLimbs.size();
+    size_t n = b.mLimbs.size();
+
+    // A single limb divisor is just long division, one limb at a time.
+    if (n == 1)
+    {
+        uint64_t divisor = b.mLimbs[0];
+        uint64_t rest = 0;
+        std::vector<uint32_t> digits(m);
+
+        for (size_t index = m; index > 0; index--)
+        {
+            uint64_t current = (rest << 32) | a.mLimbs[index - 1];
+            digits[index - 1] = (uint32_t)(current / divisor);
+            rest = current % divisor;
+        }
+
+        quotient.mLimbs.swap(digits);
+        quotient.Trim();
+        remainder = BigNumber(rest);
+        return;
+    }
+
+    // Knuth's Algorithm D (TAOCP Vol. 2, 4.3.1). Normalise so the top bit of the
+    // divisor is set, which keeps each estimated quotient digit off by at most 2.
+    int shift = CountLeadingZeros(b.mLimbs[n - 1]);
+
+    std::vector<uint32_t> divisor(n);
+    for (size_t index = n - 1; index > 0; index--)
+    {
+        divisor[index] = (b.mLimbs[index] << shift) | (shift ? b.mLimbs[index - 1] >> (32 - shift) : 0);
+    }
+    divisor[0] = b.mLimbs[0] << shift;
+
+    std::vector<uint32_t> dividend(m + 1);
+    dividend[m] = shift ? a.mLimbs[m - 1] >> (32 - shift) : 0;
+    for (size_t index = m - 1; index > 0; index--)
+    {
+        dividend[index] = (a.mLimbs[index] << shift) | (shift ? a.mLimbs[index - 1] >> (32 - shift) : 0);
+    }
+    dividend[0] = a.mLimbs[0] << shift;
+
+    std::vector<uint32_t> digits(m - n + 1);
+    const uint64_t base = 1ull << 32;
+
+    for (size_t j = m - n + 1; j-- > 0;)
+    {
+        uint64_t top = ((uint64_t)dividend[j + n] << 32) | dividend[j + n - 1];
+        uint64_t estimate = top / divisor[n - 1];
+        uint64_t rest = top % divisor[n - 1];
+
+        while (estimate >= base || estimate * divisor[n - 2] > ((rest << 32) | dividend[j + n - 2]))
+        {
+            estimate--;
+            rest += divisor[n - 1];
+            if (rest >= base)
+                break;
+        }
+
+        // Multiply and subtract.
+        int64_t borrow = 0;
+        int64_t difference;
+        for (size_t index = 0; index < n; index++)
+        {
+            uint64_t product = estimate * divisor[index];
+            difference = (int64_t)dividend[index + j] - borrow - (int64_t)(product & 0xFFFFFFFF);
+            dividend[index + j] = (uint32_t)difference;
+            borrow = (int64_t)(product >> 32) - (difference >> 32);
+        }
+        difference = (int64_t)dividend[j + n] - borrow;
+        dividend[j + n] = (uint32_t)difference;
+
+        // We took away one too many; add it back.
+        if (difference < 0)
+        {
+            estimate--;
+            uint64_t carry = 0;
+            for (size_t index = 0; index < n; index++)
+            {
+                uint64_t sum = (uint64_t)dividend[index + j] + divisor[index] + carry;
+                dividend[index + j] = (uint32_t)sum;
+                carry = sum >> 32;
+            }
+            dividend[j + n] += (uint32_t)carry;
+        }
+
+        digits[j] = (uint32_t)estimate;
+    }
+
+    quotient.mLimbs.swap(digits);
+    quotient.Trim();
+
+    // Undo the normalisation on what's left over.
+    remainder.mLimbs.resize(n);
+    for (size_t index = 0; index < n; index++)
+    {
+        remainder.mLimbs[index] = (dividend[index] >> shift) | (shift ? dividend[index + 1] << (32 - shift) : 0);
+    }
+    remainder.Trim();
+}
+
+// Collects digits into a small buffer so the sink isn't called for every 9 digits.
+struct DecimalWriter
+{
+    BigNumber::DecimalSink sink;
+    void* context;
+    char buffer[4096];
+    size_t used;
+
+    void Put(const char* digits, size_t count)
+    {
+        if (used + count > sizeof(buffer))
+            Flush();
+
+        memcpy(buffer + used, digits, count);
+        used += count;
+    }
+
+    void Flush()
+    {
+        if (used > 0)
+            sink(buffer, used, context);
+        used = 0;
+    }
+};
+
+// Emits `value`, which must be less than powers[level]^2. When `padded` is set the
+// output is zero padded to exactly 9 * 2^(level + 1) digits, since it's the low half
+// of a larger number.
+static void EmitDecimal(const BigNumber& value, int level, bool padded,
+                        const std::vector<BigNumber>& powers, DecimalWriter& writer)
+{
+    if (level < 0)
+    {
+        uint32_t chunk = value.IsZero() ? 0 : value.Limbs()[0];
+        char digits[9];
+        int count = 0;
+
+        do
+        {
+            digits[8 - count] = (char)('0' + chunk % 10);
+            chunk /= 10;
+            count++;
+        } while (chunk != 0 || (padded && count < 9));
+
+        writer.Put(digits + 9 - count, count);
+        return;
+    }
+
+    if (!padded && value.Compare(powers[level]) < 0)
+    {
+        EmitDecimal(value, level - 1, false, powers, writer);
+        return;
+    }
+
+    BigNumber high;
+    BigNumber low;
+    BigNumber::DivideModulo(value, powers[level], high, low);
+
+    EmitDecimal(high, level - 1, padded, powers, writer);
+    EmitDecimal(low, level - 1, true, powers, writer);
+}
+
+void BigNumber::StreamDecimal(DecimalSink sink, void* context) const
+{
+    // powers[k] = 10^(9 * 2^k); keep squaring until we pass the number itself.
+    std::vector<BigNumber> powers;
+    powers.push_back(BigNumber(1000000000));
+    while (powers.back().Compare(*this) <= 0)
+    {
+        powers.push_back(powers.back() * powers.back());
+    }
+
+    DecimalWriter writer;
+    writer.sink = sink;
+    writer.context = context;
+    writer.used = 0;
+
+    EmitDecimal(*this, (int)powers.size() - 2, false, powers, writer);
+    writer.Flush();
+}
+
+static void FileSink(const char* digits, size_t count, void* context)
+{
+    fwrite(digits, 1, count, (FILE*)context);
+}
+
+void BigNumber::WriteDecimal(FILE* file) const
+{
+    StreamDecimal(FileSink, file);
+}
+
+struct BufferSinkContext
+{
+    char* buffer;
+    size_t size;
+    size_t total;
+};
+
+static void BufferSink(const char* digits, size_t count, void* context)
+{
+    BufferSinkContext* target = (BufferSinkContext*)context;
+
+    if (target->size > 0 && target->total < target->size - 1)
+    {
+        size_t room = target->size - 1 - target->total;
+        memcpy(target->buffer + target->total, digits, std::min(room, count));
+    }
+
+    target->total += count;
+}
+
+size_t BigNumber::WriteDecimal(char* buffer, size_t size) const
+{
+    BufferSinkContext context = { buffer, size, 0 };
+    StreamDecimal(BufferSink, &context);
+
+    if (size > 0)
+        buffer[std::min(context.total, size - 1)] = '\0';
+
+    return context.total;
+}
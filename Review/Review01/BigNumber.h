@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+/// An arbitrary precision, unsigned integer. The value is kept as a vector of 32 bit
+/// 'limbs', least significant limb first, with no leading zero limbs (so zero is an
+/// empty vector).
+///
+/// This is only as much of a big number class as we need for large Fibbonaci numbers:
+/// add, subtract, multiply (Karatsuba once the numbers get big), divide, and a way of
+/// getting the decimal digits out.
+class BigNumber
+{
+public:
+    BigNumber();
+    explicit BigNumber(uint64_t value);
+
+    bool IsZero() const { return mLimbs.empty(); }
+    size_t LimbCount() const { return mLimbs.size(); }
+    const std::vector<uint32_t>& Limbs() const { return mLimbs; }
+
+    /// -1, 0 or 1 if this is less than, equal to or greater than `other`.
+    int Compare(const BigNumber& other) const;
+
+    friend BigNumber operator+(const BigNumber& a, const BigNumber& b);
+    /// `a` must be >= `b`; there are no negative numbers here.
+    friend BigNumber operator-(const BigNumber& a, const BigNumber& b);
+    friend BigNumber operator*(const BigNumber& a, const BigNumber& b);
+
+    /// quotient = a / b, remainder = a % b. `b` must not be zero.
+    static void DivideModulo(const BigNumber& a, const BigNumber& b, BigNumber& quotient, BigNumber& remainder);
+
+    /// Receives the decimal digits, most significant first, a chunk at a time.
+    typedef void (*DecimalSink)(const char* digits, size_t count, void* context);
+
+    /// Hand the decimal digits to `sink` as they are produced. The full string is never
+    /// built; the number is split recursively by powers of 10^9 instead, so the most
+    /// significant digits come out first.
+    void StreamDecimal(DecimalSink sink, void* context) const;
+
+    /// Stream the decimal digits straight to `file`.
+    void WriteDecimal(FILE* file) const;
+
+    /// Write the decimal digits into `buffer`, snprintf style: at most `size - 1` digits
+    /// plus a terminating zero. Returns the total number of digits in the number.
+    size_t WriteDecimal(char* buffer, size_t size) const;
+
+private:
+    void Trim();
+
+    std::vector<uint32_t> mLimbs;
+};
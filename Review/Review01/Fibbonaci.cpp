@@ -0,0 +1,236 @@
+#include "Fibbonaci.h"
+#include "BigNumber.h"
+
+#include <thread>
+#include <vector>
+
+static uint64_t FibbonaciRecursive(unsigned int i)
+{
+    if (i <= 1)
+        return i;
+
+    return FibbonaciRecursive(i - 1) + FibbonaciRecursive(i - 2);
+}
+
+static uint64_t FibbonaciIterative(unsigned int i)
+{
+    uint64_t current = 0;
+    uint64_t next = 1;
+
+    for (unsigned int index = 0; index < i; index++)
+    {
+        uint64_t sum = current + next;
+        current = next;
+        next = sum;
+    }
+
+    return current;
+}
+
+// Sets `current` to F(i) and `next` to F(i + 1), modulo 2^64.
+static void FibbonaciFastDoublingPair(unsigned int i, uint64_t& current, uint64_t& next)
+{
+    current = 0;    // F(k)
+    next = 1;       // F(k + 1)
+
+    // Walk the bits of `i` from the top down. Each step doubles k, and a set bit
+    // adds one to it.
+    for (int bit = 31; bit >= 0; bit--)
+    {
+        uint64_t doubled = current * (2 * next - current);      // F(2k)
+        uint64_t doubledNext = current * current + next * next; // F(2k + 1)
+
+        if ((i >> bit) & 1)
+        {
+            current = doubledNext;
+            next = doubled + doubledNext;
+        }
+        else
+        {
+            current = doubled;
+            next = doubledNext;
+        }
+    }
+}
+
+static uint64_t FibbonaciFastDoubling(unsigned int i)
+{
+    uint64_t current;
+    uint64_t next;
+    FibbonaciFastDoublingPair(i, current, next);
+    return current;
+}
+
+uint64_t Fibbonaci64(unsigned int i, FibbonaciStrategy strategy)
+{
+    switch (strategy)
+    {
+        case FibbonaciStrategy::Recursive:
+            return FibbonaciRecursive(i);
+
+        case FibbonaciStrategy::Iterative:
+            return FibbonaciIterative(i);
+
+        case FibbonaciStrategy::LookupTable:
+            if (i <= kMaxFibbonaci64)
+                return FibbonaciLookup(i);
+            return FibbonaciFastDoubling(i);
+
+        case FibbonaciStrategy::FastDoubling:
+        default:
+            return FibbonaciFastDoubling(i);
+    }
+}
+
+// Fills out[0 .. count) with F(first) onwards.
+template<typename T>
+static void FibbonaciFill(unsigned int first, unsigned int count, T* out)
+{
+    uint64_t current;
+    uint64_t next;
+    FibbonaciFastDoublingPair(first, current, next);
+
+    for (unsigned int index = 0; index < count; index++)
+    {
+        out[index] = (T)current;
+
+        uint64_t sum = current + next;
+        current = next;
+        next = sum;
+    }
+}
+
+template<typename T>
+static void FibbonaciRangeImpl(unsigned int first, unsigned int last, T* out)
+{
+    if (last <= first)
+        return;
+
+    unsigned int count = last - first;
+    unsigned int chunkCount = std::thread::hardware_concurrency();
+    if (chunkCount > count / kFibbonaciRangeParallelThreshold)
+        chunkCount = count / kFibbonaciRangeParallelThreshold;
+
+    if (chunkCount <= 1)
+    {
+        FibbonaciFill(first, count, out);
+        return;
+    }
+
+    unsigned int chunkSize = count / chunkCount;
+    std::vector<std::thread> workers;
+    workers.reserve(chunkCount - 1);
+
+    for (unsigned int chunk = 0; chunk < chunkCount - 1; chunk++)
+    {
+        unsigned int offset = chunk * chunkSize;
+        workers.emplace_back(FibbonaciFill<T>, first + offset, chunkSize, out + offset);
+    }
+
+    // The last chunk picks up the remainder, and runs on this thread.
+    unsigned int offset = (chunkCount - 1) * chunkSize;
+    FibbonaciFill(first + offset, count - offset, out + offset);
+
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void FibbonaciRange(unsigned int first, unsigned int last, unsigned int* out)
+{
+    FibbonaciRangeImpl(first, last, out);
+}
+
+void FibbonaciRange(unsigned int first, unsigned int last, uint64_t* out)
+{
+    FibbonaciRangeImpl(first, last, out);
+}
+
+bool Fibbonaci128(unsigned int i, FibbonaciWide& result)
+{
+    if (i > kMaxFibbonaci128)
+        return false;
+
+    if (i <= kMaxFibbonaci64)
+    {
+        result.high = 0;
+        result.low = FibbonaciLookup(i);
+        return true;
+    }
+
+    // Carry on from the end of the table with a 128 bit add. That's at most 93 more
+    // additions, so there's no point in doing anything smarter.
+    FibbonaciWide current = { 0, FibbonaciLookup(kMaxFibbonaci64 - 1) };
+    FibbonaciWide next = { 0, FibbonaciLookup(kMaxFibbonaci64) };
+
+    for (unsigned int index = kMaxFibbonaci64; index < i; index++)
+    {
+        FibbonaciWide sum;
+        sum.low = current.low + next.low;
+        sum.high = current.high + next.high + (sum.low < current.low ? 1 : 0);
+
+        current = next;
+        next = sum;
+    }
+
+    result = next;
+    return true;
+}
+
+bool FibbonaciChecked(unsigned int i, unsigned int& result)
+{
+    if (i > kMaxFibbonaci32)
+        return false;
+
+    result = (unsigned int)FibbonaciLookup(i);
+    return true;
+}
+
+FibbonaciResult FibbonaciWidened(unsigned int i)
+{
+    FibbonaciResult result = { FibbonaciWidth::Overflow, { 0, 0 } };
+
+    if (Fibbonaci128(i, result.value))
+    {
+        if (i <= kMaxFibbonaci32)
+            result.width = FibbonaciWidth::Bits32;
+        else if (i <= kMaxFibbonaci64)
+            result.width = FibbonaciWidth::Bits64;
+        else
+            result.width = FibbonaciWidth::Bits128;
+    }
+
+    return result;
+}
+
+void FibbonaciBig(unsigned int i, BigNumber& result)
+{
+    BigNumber current;      // F(k)
+    BigNumber next(1);      // F(k + 1)
+
+    // Same fast doubling as above, but there's no point in squaring zero 31 times,
+    // so skip the leading zero bits.
+    int bit = 31;
+    while (bit >= 0 && ((i >> bit) & 1) == 0)
+        bit--;
+
+    for (; bit >= 0; bit--)
+    {
+        BigNumber doubled = current * (next + next - current);
+        BigNumber doubledNext = current * current + next * next;
+
+        if ((i >> bit) & 1)
+        {
+            next = doubled + doubledNext;
+            current = doubledNext;
+        }
+        else
+        {
+            current = doubled;
+            next = doubledNext;
+        }
+    }
+
+    result = current;
+}
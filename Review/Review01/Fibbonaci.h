@@ -0,0 +1,104 @@
+#pragma once
+
+#include <stdint.h>
+
+class BigNumber;
+
+/// The different ways we know how to calculate a Fibbonaci number.
+///  - Recursive is the original version from Functions.cpp. It's exponential, so
+///    it's only here for comparison.
+///  - Iterative walks the series once; O(n).
+///  - LookupTable reads from a table that the compiler builds for us (see below).
+///    Indices past the end of the table fall back to FastDoubling.
+///  - FastDoubling uses F(2k) = F(k) * (2F(k+1) - F(k)) and
+///    F(2k+1) = F(k)^2 + F(k+1)^2; O(log n).
+///
+/// All of them wrap around modulo 2^64 the same way the original wrapped around
+/// modulo 2^32, so they always agree with each other.
+enum class FibbonaciStrategy
+{
+    Recursive,
+    Iterative,
+    LookupTable,
+    FastDoubling
+};
+
+/// The largest index whose Fibbonaci number still fits in 32, 64 and 128 bits.
+const unsigned int kMaxFibbonaci32 = 47;
+const unsigned int kMaxFibbonaci64 = 93;
+const unsigned int kMaxFibbonaci128 = 186;
+
+/// Every Fibbonaci number that fits in 64 bits, built at compile time.
+struct FibbonaciTable
+{
+    uint64_t values[kMaxFibbonaci64 + 1];
+
+    constexpr FibbonaciTable() : values()
+    {
+        values[1] = 1;
+        for (unsigned int index = 2; index <= kMaxFibbonaci64; index++)
+        {
+            values[index] = values[index - 1] + values[index - 2];
+        }
+    }
+};
+
+constexpr FibbonaciTable kFibbonaciTable;
+
+/// Compile time lookup. `i` must be <= kMaxFibbonaci64.
+constexpr uint64_t FibbonaciLookup(unsigned int i)
+{
+    return kFibbonaciTable.values[i];
+}
+
+static_assert(FibbonaciLookup(10) == 55, "Fibbonaci table is broken");
+static_assert(FibbonaciLookup(kMaxFibbonaci32) == 2971215073u, "Fibbonaci table is broken");
+static_assert(FibbonaciLookup(kMaxFibbonaci64) == 12200160415121876738ull, "Fibbonaci table is broken");
+
+/// A 128 bit unsigned value, split into two 64 bit halves.
+struct FibbonaciWide
+{
+    uint64_t high;
+    uint64_t low;
+};
+
+/// How many bits we needed to hold the result of FibbonaciWidened.
+enum class FibbonaciWidth
+{
+    Bits32,
+    Bits64,
+    Bits128,
+    Overflow    // Doesn't fit in 128 bits either; `value` is meaningless.
+};
+
+struct FibbonaciResult
+{
+    FibbonaciWidth width;
+    FibbonaciWide  value;
+};
+
+/// F(i) modulo 2^64, calculated with the requested strategy.
+uint64_t Fibbonaci64(unsigned int i, FibbonaciStrategy strategy = FibbonaciStrategy::FastDoubling);
+
+/// Below this many values, FibbonaciRange doesn't bother starting any threads.
+const unsigned int kFibbonaciRangeParallelThreshold = 1 << 16;
+
+/// Fills out[0 .. last - first) with F(first) .. F(last - 1), in one linear pass of
+/// additions. Large ranges are split into one chunk per core; each thread seeds its
+/// chunk with fast doubling, so the chunks don't depend on each other. The unsigned
+/// int version wraps around exactly like Fibbonaci().
+void FibbonaciRange(unsigned int first, unsigned int last, unsigned int* out);
+void FibbonaciRange(unsigned int first, unsigned int last, uint64_t* out);
+
+/// F(i) as a full 128 bit value. Returns false if it doesn't fit (i > kMaxFibbonaci128).
+bool Fibbonaci128(unsigned int i, FibbonaciWide& result);
+
+/// F(i) as an unsigned int. Returns false, and leaves `result` alone, if it would overflow.
+bool FibbonaciChecked(unsigned int i, unsigned int& result);
+
+/// F(i), stored in the smallest width it fits in.
+FibbonaciResult FibbonaciWidened(unsigned int i);
+
+/// F(i) with no upper limit, using fast doubling on arbitrary precision numbers.
+/// F(1,000,000) has a little over 200,000 digits; use BigNumber::WriteDecimal to print it.
+void FibbonaciBig(unsigned int i, BigNumber& result);
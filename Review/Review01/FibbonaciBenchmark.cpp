@@ -0,0 +1,76 @@
+/// ---------------------------------------------------------------------------------
+/// A stand-alone benchmark comparing the original recursive Fibbonaci with the big
+/// number, fast doubling version. It has its own `main`, so it isn't part of the
+/// Review01 project; build it from the command line:
+///
+///     cl /O2 /EHsc FibbonaciBenchmark.cpp Fibbonaci.cpp BigNumber.cpp
+///     clang++ -O2 FibbonaciBenchmark.cpp Fibbonaci.cpp BigNumber.cpp -o FibbonaciBenchmark
+///
+/// The recursive version makes 2F(n+1) - 1 calls, so there's no way to actually run it
+/// for n = 1,000 and up. Instead we time it for n = 32, work out the cost of a single
+/// call, and extrapolate.
+/// ---------------------------------------------------------------------------------
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+
+#include "Fibbonaci.h"
+#include "BigNumber.h"
+
+typedef std::chrono::high_resolution_clock Clock;
+
+static double SecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// We only want to know how many digits there are; throw them away.
+static void CountingSink(const char* digits, size_t count, void* context)
+{
+    (void)digits;
+    *(size_t*)context += count;
+}
+
+int main()
+{
+    const unsigned int calibrationIndex = 32;
+    const unsigned int indices[] = { 1000, 100000, 1000000 };
+
+    // How long does one call of the recursive version take?
+    Clock::time_point start = Clock::now();
+    volatile uint64_t sink = Fibbonaci64(calibrationIndex, FibbonaciStrategy::Recursive);
+    double recursiveSeconds = SecondsSince(start);
+    (void)sink;
+
+    double calls = 2.0 * (double)Fibbonaci64(calibrationIndex + 1, FibbonaciStrategy::Iterative) - 1.0;
+    double secondsPerCall = recursiveSeconds / calls;
+
+    printf("Recursive F(%u): %.3f s, %.2f ns per call\n\n", calibrationIndex, recursiveSeconds, secondsPerCall * 1e9);
+    printf("%10s %12s %12s %12s %24s\n", "n", "digits", "compute (s)", "decimal (s)", "recursive (est. years)");
+
+    // log10 of the golden ratio; F(n) ~ phi^n / sqrt(5)
+    const double log10Phi = log10((1.0 + sqrt(5.0)) / 2.0);
+    const double log10SecondsPerYear = log10(365.25 * 24.0 * 60.0 * 60.0);
+
+    for (unsigned int index : indices)
+    {
+        BigNumber value;
+
+        start = Clock::now();
+        FibbonaciBig(index, value);
+        double computeSeconds = SecondsSince(start);
+
+        size_t digits = 0;
+        start = Clock::now();
+        value.StreamDecimal(CountingSink, &digits);
+        double decimalSeconds = SecondsSince(start);
+
+        // calls ~ 2F(n+1), so log10(time) ~ log10(2) + (n + 1) log10(phi) - log10(sqrt(5)) + log10(time per call)
+        double log10Years = log10(2.0) + (index + 1) * log10Phi - log10(sqrt(5.0))
+                          + log10(secondsPerCall) - log10SecondsPerYear;
+
+        printf("%10u %12zu %12.4f %12.4f %19s1e%.0f\n", index, digits, computeSeconds, decimalSeconds, "~", log10Years);
+    }
+
+    return 0;
+}
@@ -1,7 +1,9 @@
+#include "Fibbonaci.h"
+
 unsigned int Fibbonaci(unsigned int i)
 {
-    if (i <= 1)
-        return i;
-
-    return Fibbonaci(i - 1) + Fibbonaci(i - 2);
-}
\ No newline at end of file
+    // The 64 bit result, truncated, wraps around exactly the same way the original
+    // recursive version did - we just don't pay the exponential cost to get there.
+    // See Fibbonaci.h for the other strategies.
+    return (unsigned int)Fibbonaci64(i, FibbonaciStrategy::FastDoubling);
+}
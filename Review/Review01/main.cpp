@@ -2,18 +2,85 @@
 //
 
 #include <stdio.h>
+#include <string.h>
+#include <vector>
 #include "Functions.h"
+#include "Fibbonaci.h"
 
+const unsigned int kCount = 10;
+
+// With buffered output on, we calculate the whole series with FibbonaciRange and
+// format it ourselves into one big buffer, instead of calling Fibbonaci and printf
+// for every line. Turn it off to see the original version.
+const bool kBufferedOutput = true;
+
+// Writes `value` in decimal to `out`, returning the number of characters written.
+static size_t FormatUnsigned(unsigned int value, char* out)
+{
+    char digits[10];
+    size_t count = 0;
+
+    do
+    {
+        digits[count++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    for (size_t index = 0; index < count; index++)
+    {
+        out[index] = digits[count - 1 - index];
+    }
+
+    return count;
+}
+
+static void PrintBuffered(unsigned int count)
+{
+    std::vector<unsigned int> values(count);
+    FibbonaciRange(0, count, values.data());
+
+    static const char prefix[] = "The Fibbonaci series of ";
+    static const char middle[] = " is ";
+    const size_t longestLine = sizeof(prefix) + sizeof(middle) + 2 * 10 + 1;
+
+    char buffer[16 * 1024];
+    size_t used = 0;
+
+    for (unsigned int index = 0; index < count; index++)
+    {
+        if (used + longestLine > sizeof(buffer))
+        {
+            fwrite(buffer, 1, used, stdout);
+            used = 0;
+        }
+
+        memcpy(buffer + used, prefix, sizeof(prefix) - 1);
+        used += sizeof(prefix) - 1;
+        used += FormatUnsigned(index, buffer + used);
+        memcpy(buffer + used, middle, sizeof(middle) - 1);
+        used += sizeof(middle) - 1;
+        used += FormatUnsigned(values[index], buffer + used);
+        buffer[used++] = '\n';
+    }
+
+    fwrite(buffer, 1, used, stdout);
+}
 
 int main()
 {
-    for (unsigned int index = 0; index < 10; index++)
+    if (kBufferedOutput)
     {
-        printf("The Fibbonaci series of %d is %d\n", index, Fibbonaci(index));
+        PrintBuffered(kCount);
+    }
+    else
+    {
+        for (unsigned int index = 0; index < kCount; index++)
+        {
+            printf("The Fibbonaci series of %d is %d\n", index, Fibbonaci(index));
+        }
     }
 
     printf("press any key to continue");
     scanf("-");
     return 0;
 }
-
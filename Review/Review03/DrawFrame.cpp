@@ -0,0 +1,65 @@
+#include "DrawFrame.h"
+
+#include <allegro5/allegro.h>
+
+#include "PixelSurface.h"
+#include "TiledFrame.h"
+
+// Locks the top left `width` x `height` of the target bitmap (clipped to its size)
+// and wraps the memory in a PixelSurface. Returns the bitmap to unlock, or nullptr
+// if there's nothing to draw to.
+//
+// Asking for ABGR_8888 means the pixels come back in PackPixel()'s layout; if the
+// bitmap is stored some other way, Allegro converts on lock and unlock.
+static ALLEGRO_BITMAP* LockTarget(int width, int height, int flags, PixelSurface& surface)
+{
+    ALLEGRO_BITMAP* target = al_get_target_bitmap();
+    if (target == nullptr)
+        return nullptr;
+
+    if (width > al_get_bitmap_width(target))
+        width = al_get_bitmap_width(target);
+    if (height > al_get_bitmap_height(target))
+        height = al_get_bitmap_height(target);
+
+    ALLEGRO_LOCKED_REGION* region = al_lock_bitmap_region(target, 0, 0, width, height,
+                                                          ALLEGRO_PIXEL_FORMAT_ABGR_8888, flags);
+    if (region == nullptr)
+        return nullptr;
+
+    surface.rows = (uint8_t*)region->data;
+    surface.pitch = region->pitch;
+    surface.width = width;
+    surface.height = height;
+    return target;
+}
+
+void DrawFrame(int width, int height, int pixelCount)
+{
+    // We used to call al_put_pixel() once per pixel here, which is incredibly slow:
+    // every call has to find the target, convert the color and lock the bitmap.
+    // Locking it ourselves means that work happens once per frame instead.
+    //
+    // We only overwrite some of the pixels, so the rest have to be read in: READWRITE.
+    PixelSurface surface;
+    ALLEGRO_BITMAP* target = LockTarget(width, height, ALLEGRO_LOCK_READWRITE, surface);
+    if (target == nullptr)
+        return;
+
+    ScatterPixels(surface, pixelCount);
+
+    al_unlock_bitmap(target);
+}
+
+void PresentFrame(const TiledFrame& frame)
+{
+    // Every locked pixel gets overwritten, so there's no need to read them first
+    PixelSurface surface;
+    ALLEGRO_BITMAP* target = LockTarget(frame.Width(), frame.Height(), ALLEGRO_LOCK_WRITEONLY, surface);
+    if (target == nullptr)
+        return;
+
+    frame.CompositeTo(surface);
+
+    al_unlock_bitmap(target);
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+class TiledFrame;
+
+/// How many pixels DrawFrame scatters each frame. The whole 800x600 window is only
+/// 480,000 pixels, so this covers it a couple of times over.
+const int kPixelsPerFrame = 1000000;
+
+/// Scatters random pixels over the current Allegro target bitmap. The bitmap is locked
+/// once, the pixels are written straight into its memory (see PixelSurface.h), and
+/// then it's unlocked again.
+void DrawFrame(int width, int height, int pixelCount = kPixelsPerFrame);
+
+/// Copies a finished TiledFrame into the current Allegro target bitmap, with a single
+/// lock and unlock.
+void PresentFrame(const TiledFrame& frame);
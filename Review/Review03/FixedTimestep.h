@@ -0,0 +1,62 @@
+#pragma once
+
+/// ---------------------------------------------------------------------------------
+/// The 'fix your timestep' loop: the simulation always moves forward in steps of the
+/// same length, however long each frame takes to draw.
+///
+/// Each frame, tell Advance() how much real time has passed; it returns how many
+/// steps to simulate to catch up (often 0 or 1, sometimes more). Time that doesn't
+/// add up to a whole step is carried over to the next frame. Alpha() is how far we
+/// are into the next step, 0 to 1, so drawing can blend between the previous and
+/// current simulation states instead of stuttering between them:
+///
+///     int steps = timestep.Advance(frameSeconds);
+///     for (int step = 0; step < steps; step++)
+///     {
+///         previous = current;
+///         Simulate(current, timestep.Step());
+///     }
+///     Draw(Lerp(previous, current, timestep.Alpha()));
+///
+/// If a frame is so slow that catching up would take more than `maxSteps` steps, the
+/// rest of the time is dropped (and counted), rather than making the next frame even
+/// slower trying to catch up - the 'spiral of death'.
+/// ---------------------------------------------------------------------------------
+class FixedTimestep
+{
+public:
+    explicit FixedTimestep(double stepSeconds, int maxSteps = 8)
+        : mStep(stepSeconds)
+        , mMaxSteps(maxSteps)
+        , mAccumulator(0.0)
+        , mDroppedSteps(0)
+    {}
+
+    int Advance(double elapsedSeconds)
+    {
+        mAccumulator += elapsedSeconds > 0.0 ? elapsedSeconds : 0.0;
+
+        int steps = (int)(mAccumulator / mStep);
+        if (steps > mMaxSteps)
+        {
+            mDroppedSteps += steps - mMaxSteps;
+            mAccumulator -= (steps - mMaxSteps) * mStep;
+            steps = mMaxSteps;
+        }
+
+        mAccumulator -= steps * mStep;
+        return steps;
+    }
+
+    double Step() const { return mStep; }
+    double Alpha() const { return mAccumulator / mStep; }
+
+    /// Steps that were never simulated because a frame took too long
+    long long DroppedSteps() const { return mDroppedSteps; }
+
+private:
+    double mStep;
+    int mMaxSteps;
+    double mAccumulator;
+    long long mDroppedSteps;
+};
@@ -0,0 +1,127 @@
+#include "FrameStats.h"
+
+#include <algorithm>
+
+FrameStats::FrameStats(double budgetSeconds)
+    : mBudgetMilliseconds(budgetSeconds * 1000.0)
+    , mOverruns(0)
+    , mHistogram(kBuckets, 0)
+{}
+
+void FrameStats::Add(double seconds)
+{
+    double milliseconds = seconds * 1000.0;
+    mMilliseconds.push_back((float)milliseconds);
+
+    if (milliseconds > mBudgetMilliseconds)
+        mOverruns++;
+
+    int bucket = (int)(milliseconds / kBucketMilliseconds);
+    if (bucket < 0)
+        bucket = 0;
+    if (bucket >= kBuckets)
+        bucket = kBuckets - 1;
+    mHistogram[bucket]++;
+}
+
+void FrameStats::Clear()
+{
+    mOverruns = 0;
+    mMilliseconds.clear();
+    std::fill(mHistogram.begin(), mHistogram.end(), 0);
+}
+
+double FrameStats::Mean() const
+{
+    if (mMilliseconds.empty())
+        return 0.0;
+
+    double total = 0.0;
+    for (float milliseconds : mMilliseconds)
+        total += milliseconds;
+    return total / (double)mMilliseconds.size();
+}
+
+double FrameStats::Max() const
+{
+    if (mMilliseconds.empty())
+        return 0.0;
+    return *std::max_element(mMilliseconds.begin(), mMilliseconds.end());
+}
+
+// Nearest rank: the index, in sorted order, of the smallest time with at least
+// `percent` of frames at or under it
+static size_t NearestRank(double percent, size_t count)
+{
+    double rank = percent / 100.0 * (double)count;
+    size_t index = rank <= 1.0 ? 0 : (size_t)(rank + 0.999999) - 1;
+    return index < count ? index : count - 1;
+}
+
+double FrameStats::Percentile(double percent) const
+{
+    if (mMilliseconds.empty())
+        return 0.0;
+
+    // nth_element only sorts as much as it needs to
+    size_t index = NearestRank(percent, mMilliseconds.size());
+    mSorted.assign(mMilliseconds.begin(), mMilliseconds.end());
+    std::nth_element(mSorted.begin(), mSorted.begin() + index, mSorted.end());
+    return mSorted[index];
+}
+
+void FrameStats::Print(FILE* out, const char* label) const
+{
+    // Three percentiles from one sorted copy, rather than a copy each
+    double p50 = 0.0;
+    double p99 = 0.0;
+    double p999 = 0.0;
+    if (!mMilliseconds.empty())
+    {
+        mSorted.assign(mMilliseconds.begin(), mMilliseconds.end());
+        std::sort(mSorted.begin(), mSorted.end());
+        p50 = mSorted[NearestRank(50.0, mSorted.size())];
+        p99 = mSorted[NearestRank(99.0, mSorted.size())];
+        p999 = mSorted[NearestRank(99.9, mSorted.size())];
+    }
+
+    fprintf(out, "%s: %u samples, mean %.2f ms, p50 %.2f, p99 %.2f, p99.9 %.2f, max %.2f, %llu over %.2f ms\n",
+            label, (unsigned)Count(), Mean(), p50, p99, p999, Max(), (unsigned long long)mOverruns, mBudgetMilliseconds);
+}
+
+bool FrameStats::WriteCSV(const char* path) const
+{
+    FILE* file = fopen(path, "w");
+    if (file == nullptr)
+        return false;
+
+    fprintf(file, "frame,milliseconds,over_budget\n");
+    for (size_t frame = 0; frame < mMilliseconds.size(); frame++)
+    {
+        fprintf(file, "%u,%.3f,%d\n", (unsigned)frame, mMilliseconds[frame],
+                mMilliseconds[frame] > mBudgetMilliseconds ? 1 : 0);
+    }
+
+    bool ok = ferror(file) == 0;
+    return fclose(file) == 0 && ok;
+}
+
+bool FrameStats::WriteHistogramCSV(const char* path) const
+{
+    FILE* file = fopen(path, "w");
+    if (file == nullptr)
+        return false;
+
+    fprintf(file, "from_ms,to_ms,frames\n");
+    for (int bucket = 0; bucket < kBuckets; bucket++)
+    {
+        // The last bucket is open ended
+        if (bucket == kBuckets - 1)
+            fprintf(file, "%.1f,,%u\n", bucket * kBucketMilliseconds, mHistogram[bucket]);
+        else
+            fprintf(file, "%.1f,%.1f,%u\n", bucket * kBucketMilliseconds, (bucket + 1) * kBucketMilliseconds, mHistogram[bucket]);
+    }
+
+    bool ok = ferror(file) == 0;
+    return fclose(file) == 0 && ok;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+/// ---------------------------------------------------------------------------------
+/// Frame time statistics.
+///
+/// An average frame time hides exactly the thing players notice: the odd frame that
+/// takes three times as long. FrameStats keeps every frame's time, so it can give
+/// percentiles (p50 is the typical frame, p99 and p99.9 the bad ones), a histogram,
+/// and a count of the frames that went over budget. WriteCSV() dumps the lot, one row
+/// per frame, so the spikes from a long soak test can be found and lined up with
+/// whatever else was going on.
+///
+/// Times go in as seconds and come out as milliseconds.
+/// ---------------------------------------------------------------------------------
+class FrameStats
+{
+public:
+    /// Width of each histogram bucket, and how many there are; the last bucket
+    /// collects everything longer.
+    static constexpr double kBucketMilliseconds = 0.5;
+    static const int kBuckets = 100;
+
+    explicit FrameStats(double budgetSeconds = 1.0 / 60.0);
+
+    void Add(double seconds);
+    void Clear();
+
+    size_t Count() const { return mMilliseconds.size(); }
+    double BudgetMilliseconds() const { return mBudgetMilliseconds; }
+
+    /// Frames that took longer than the budget
+    uint64_t Overruns() const { return mOverruns; }
+
+    double Mean() const;
+    double Max() const;
+
+    /// The time that `percent` percent of frames were at or under (nearest rank), e.g.
+    /// Percentile(99.9). 0 if there are no frames.
+    double Percentile(double percent) const;
+
+    const std::vector<uint32_t>& Histogram() const { return mHistogram; }
+
+    /// One line: count, mean, p50/p99/p99.9, max, and overruns.
+    void Print(FILE* out, const char* label) const;
+
+    /// `frame,milliseconds,over_budget`, one row per frame.
+    bool WriteCSV(const char* path) const;
+
+    /// `from_ms,to_ms,frames`, one row per histogram bucket.
+    bool WriteHistogramCSV(const char* path) const;
+
+private:
+    double mBudgetMilliseconds;
+    uint64_t mOverruns;
+    std::vector<float> mMilliseconds;
+    std::vector<uint32_t> mHistogram;
+    mutable std::vector<float> mSorted;   ///< Scratch space for Percentile()
+};
@@ -0,0 +1,151 @@
+/// ---------------------------------------------------------------------------------
+/// Review03's random pixels without Allegro or a display: scatters them over a
+/// MemorySurface, times it, and writes the last frame out as a PPM. Then it draws the
+/// same frames as tiles on 1, 2, 4 ... up to one thread per core, to show how well
+/// that scales. It has its own `main`, so it's not part of the Review03 project; the
+/// CMake build makes it `Review03Headless`.
+///
+///     Review03Headless                     100 frames, writes Review03.ppm
+///     Review03Headless 500 pixels.ppm      and the frame times to Review03Frames.csv
+///     Review03Headless 500 pixels.ppm times.csv
+///     Review03Headless --help              prints how to use it (any other option is an error)
+/// ---------------------------------------------------------------------------------
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+#include "DrawFrame.h"
+#include "FrameStats.h"
+#include "PixelSurface.h"
+#include "ThreadPool.h"
+#include "TiledFrame.h"
+
+typedef std::chrono::steady_clock Clock;
+
+// Draws `frames` tiled frames with a pool of `threads`; returns the seconds per frame.
+static double TimeTiledFrames(int threads, int frames, uint64_t& steals)
+{
+    ThreadPool pool(threads);
+    TiledFrame frame(800, 600);
+
+    Clock::time_point start = Clock::now();
+    for (int index = 0; index < frames; index++)
+    {
+        frame.Render(pool, kPixelsPerFrame);
+    }
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    steals = pool.Steals();
+    return frames > 0 ? elapsed.count() / frames : 0.0;
+}
+
+static void ReportScaling(int frames)
+{
+    int cores = (int)std::thread::hardware_concurrency();
+    if (cores < 1)
+        cores = 1;
+
+    printf("\nTiled, %d frames each:\n", frames);
+    printf("threads  ms/frame  speedup  steals/frame\n");
+
+    double baseline = 0.0;
+    int threads = 1;
+    while (true)
+    {
+        uint64_t steals = 0;
+        double seconds = TimeTiledFrames(threads, frames, steals);
+        if (threads == 1)
+            baseline = seconds;
+
+        printf("%7d  %8.2f  %6.2fx  %12.1f\n", threads, seconds * 1000.0,
+               seconds > 0.0 ? baseline / seconds : 0.0, frames > 0 ? (double)steals / frames : 0.0);
+
+        if (threads >= cores)
+            break;
+        threads = threads * 2 < cores ? threads * 2 : cores;
+    }
+}
+
+static void PrintUsage(FILE* out)
+{
+    fprintf(out, "Usage: Review03Headless [frames [out.ppm [times.csv]]]\n");
+}
+
+int main(int argc, char* argv[])
+{
+    // Anything that looks like an option is a mistake (or a request for help), not
+    // the name of a file to write
+    for (int arg = 1; arg < argc; arg++)
+    {
+        if (strcmp(argv[arg], "--help") == 0 || strcmp(argv[arg], "-h") == 0)
+        {
+            PrintUsage(stdout);
+            return 0;
+        }
+        if (argv[arg][0] == '-')
+        {
+            fprintf(stderr, "Unknown option %s\n", argv[arg]);
+            PrintUsage(stderr);
+            return 1;
+        }
+    }
+    if (argc > 4)
+    {
+        fprintf(stderr, "Too many arguments\n");
+        PrintUsage(stderr);
+        return 1;
+    }
+
+    int frames = 100;
+    if (argc > 1)
+    {
+        // All of it has to be a number: `Review03Headless out.ppm` isn't 0 frames
+        char* end;
+        long count = strtol(argv[1], &end, 10);
+        if (end == argv[1] || *end != '\0' || count < 1 || count > 1000000)
+        {
+            fprintf(stderr, "The number of frames has to be a whole number from 1 to 1000000, not %s\n", argv[1]);
+            PrintUsage(stderr);
+            return 1;
+        }
+        frames = (int)count;
+    }
+
+    const char* path = argc > 2 ? argv[2] : "Review03.ppm";
+    const char* csvPath = argc > 3 ? argv[3] : "Review03Frames.csv";
+
+    MemorySurface memory(800, 600);
+    PixelSurface surface = memory.Surface();
+    FrameStats frameStats(1.0 / 60.0);
+
+    Clock::time_point start = Clock::now();
+    for (int frame = 0; frame < frames; frame++)
+    {
+        Clock::time_point frameStart = Clock::now();
+        ScatterPixels(surface, kPixelsPerFrame);
+        frameStats.Add(std::chrono::duration<double>(Clock::now() - frameStart).count());
+    }
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    double pixels = (double)frames * kPixelsPerFrame;
+    printf("%d frames of %d pixels in %.3f s: %.1f million pixels/s\n",
+           frames, kPixelsPerFrame, elapsed.count(),
+           elapsed.count() > 0.0 ? pixels / elapsed.count() / 1e6 : 0.0);
+    frameStats.Print(stdout, "frame");
+
+    if (!memory.WritePPM(path))
+    {
+        fprintf(stderr, "Couldn't write %s\n", path);
+        return 1;
+    }
+
+    printf("Wrote %s (%dx%d)\n", path, memory.Width(), memory.Height());
+
+    if (frameStats.WriteCSV(csvPath))
+        printf("Wrote %s\n", csvPath);
+
+    ReportScaling(frames);
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include "PixelSurface.h"
+
+#include "Random.h"
+
+#include <stdio.h>
+
+void ScatterPixels(const PixelSurface& surface, int count)
+{
+    if (surface.width <= 0 || surface.height <= 0)
+        return;
+
+    // The positions and colors are made a chunk at a time with the batch generator,
+    // then written out; the chunk is small enough to stay in L1.
+    const int kChunk = 1024;
+    uint32_t xs[kChunk];
+    uint32_t ys[kChunk];
+    uint32_t colors[kChunk];
+    RandomBatch& random = ThreadRandomBatch();
+
+    for (int first = 0; first < count; first += kChunk)
+    {
+        int size = count - first < kChunk ? count - first : kChunk;
+        random.FillBounded(xs, (size_t)size, (uint32_t)surface.width);
+        random.FillBounded(ys, (size_t)size, (uint32_t)surface.height);
+        random.Fill(colors, (size_t)size);
+
+        for (int index = 0; index < size; index++)
+        {
+            PixelRow(surface, (int)ys[index])[xs[index]] = colors[index] | 0xFF000000u;
+        }
+    }
+}
+
+MemorySurface::MemorySurface(int width, int height)
+    : mWidth(width > 0 ? width : 0)
+    , mHeight(height > 0 ? height : 0)
+    , mPixels((size_t)mWidth * (size_t)mHeight, PackPixel(0, 0, 0))
+{}
+
+PixelSurface MemorySurface::Surface()
+{
+    PixelSurface surface;
+    surface.rows = (uint8_t*)mPixels.data();
+    surface.pitch = mWidth * (int)sizeof(uint32_t);
+    surface.width = mWidth;
+    surface.height = mHeight;
+    return surface;
+}
+
+void MemorySurface::Clear(uint32_t color)
+{
+    for (uint32_t& pixel : mPixels)
+    {
+        pixel = color;
+    }
+}
+
+bool MemorySurface::WritePPM(const char* path) const
+{
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr)
+        return false;
+
+    fprintf(file, "P6\n%d %d\n255\n", mWidth, mHeight);
+
+    std::vector<uint8_t> row((size_t)mWidth * 3);
+    for (int y = 0; y < mHeight; y++)
+    {
+        const uint32_t* pixel = mPixels.data() + (size_t)y * mWidth;
+        for (int x = 0; x < mWidth; x++)
+        {
+            row[x * 3 + 0] = (uint8_t)pixel[x];
+            row[x * 3 + 1] = (uint8_t)(pixel[x] >> 8);
+            row[x * 3 + 2] = (uint8_t)(pixel[x] >> 16);
+        }
+        fwrite(row.data(), 1, row.size(), file);
+    }
+
+    bool ok = ferror(file) == 0;
+    return fclose(file) == 0 && ok;
+}
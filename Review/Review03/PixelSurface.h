@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/// ---------------------------------------------------------------------------------
+/// A block of 32-bit pixels we can write straight into.
+///
+/// `al_put_pixel` is one function call per pixel, and Allegro has to look up the
+/// target bitmap, check its format, convert the color and (for a video bitmap) lock
+/// and unlock it every time. Writing a million pixels that way is hopeless.
+///
+/// Instead, DrawFrame locks the bitmap once, wraps the memory Allegro hands back in
+/// a PixelSurface, and writes packed pixels into it. A MemorySurface is the same thing
+/// over a std::vector, for when there's no Allegro (or no display) at all.
+///
+/// Rows don't have to be `width * 4` bytes apart, or even in top-down order: `pitch`
+/// is the distance in bytes from one row to the next, and a locked Allegro bitmap can
+/// have a negative pitch (row 0 at the highest address). Always go through PixelRow().
+/// ---------------------------------------------------------------------------------
+struct PixelSurface
+{
+    uint8_t* rows;    ///< The first byte of row 0
+    int      pitch;   ///< Bytes from the start of one row to the start of the next
+    int      width;
+    int      height;
+};
+
+/// A pixel packed into a 32-bit value, red in the low byte and alpha in the high
+/// byte. That's ALLEGRO_PIXEL_FORMAT_ABGR_8888, which is what DrawFrame asks for when
+/// it locks the bitmap.
+inline uint32_t PackPixel(uint8_t red, uint8_t green, uint8_t blue, uint8_t alpha = 255)
+{
+    return (uint32_t)red | ((uint32_t)green << 8) | ((uint32_t)blue << 16) | ((uint32_t)alpha << 24);
+}
+
+inline uint32_t* PixelRow(const PixelSurface& surface, int y)
+{
+    return (uint32_t*)(surface.rows + (ptrdiff_t)y * surface.pitch);
+}
+
+/// Writes `count` pixels of random colors to random places on the surface.
+void ScatterPixels(const PixelSurface& surface, int count);
+
+/// A PixelSurface that owns its pixels, top-down with no padding.
+class MemorySurface
+{
+public:
+    MemorySurface(int width, int height);
+
+    int Width() const { return mWidth; }
+    int Height() const { return mHeight; }
+    const std::vector<uint32_t>& Pixels() const { return mPixels; }
+
+    /// The surface to draw into; it stays valid as long as this MemorySurface does.
+    PixelSurface Surface();
+
+    void Clear(uint32_t color);
+
+    /// Writes a binary PPM (RGB, alpha dropped). Returns false if the file couldn't be
+    /// written.
+    bool WritePPM(const char* path) const;
+
+private:
+    int mWidth;
+    int mHeight;
+    std::vector<uint32_t> mPixels;
+};
@@ -0,0 +1,223 @@
+#include "Random.h"
+
+#include <atomic>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RANDOM_SSE2 1
+#else
+#define RANDOM_SSE2 0
+#endif
+
+void Xoshiro256pp::Jump()
+{
+    static const uint64_t kJump[4] = { 0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull,
+                                       0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull };
+
+    uint64_t jumped[4] = { 0, 0, 0, 0 };
+    for (uint64_t word : kJump)
+    {
+        for (int bit = 0; bit < 64; bit++)
+        {
+            if (word & (1ull << bit))
+            {
+                for (int index = 0; index < 4; index++)
+                    jumped[index] ^= mState[index];
+            }
+            Next();
+        }
+    }
+    memcpy(mState, jumped, sizeof(mState));
+}
+
+/// ---------------------------------------------------------------------------------
+/// RandomBatch
+/// ---------------------------------------------------------------------------------
+void RandomBatch::Seed(uint64_t seed)
+{
+    Xoshiro256pp generator(seed);
+    for (int lane = 0; lane < kLanes; lane++)
+    {
+        for (int word = 0; word < 4; word++)
+            mState[word][lane] = generator.State()[word];
+        generator.Jump();
+    }
+}
+
+#if RANDOM_SSE2
+
+static inline __m128i RotateLeft(__m128i value, int bits)
+{
+    return _mm_or_si128(_mm_slli_epi64(value, bits), _mm_srli_epi64(value, 64 - bits));
+}
+
+// One xoshiro256++ step for two lanes at once, exactly as Xoshiro256pp::Next().
+static inline __m128i Step(__m128i& s0, __m128i& s1, __m128i& s2, __m128i& s3)
+{
+    __m128i result = _mm_add_epi64(RotateLeft(_mm_add_epi64(s0, s3), 23), s0);
+    __m128i shifted = _mm_slli_epi64(s1, 17);
+
+    s2 = _mm_xor_si128(s2, s0);
+    s3 = _mm_xor_si128(s3, s1);
+    s1 = _mm_xor_si128(s1, s2);
+    s0 = _mm_xor_si128(s0, s3);
+    s2 = _mm_xor_si128(s2, shifted);
+    s3 = RotateLeft(s3, 45);
+
+    return result;
+}
+
+void RandomBatch::FillBlocks(uint32_t* out, size_t blocks)
+{
+    // Lanes 0-1 in the 'a' registers, lanes 2-3 in the 'b' ones; all of it stays in
+    // registers for the whole loop.
+    __m128i a0 = _mm_load_si128((const __m128i*)&mState[0][0]);
+    __m128i a1 = _mm_load_si128((const __m128i*)&mState[1][0]);
+    __m128i a2 = _mm_load_si128((const __m128i*)&mState[2][0]);
+    __m128i a3 = _mm_load_si128((const __m128i*)&mState[3][0]);
+    __m128i b0 = _mm_load_si128((const __m128i*)&mState[0][2]);
+    __m128i b1 = _mm_load_si128((const __m128i*)&mState[1][2]);
+    __m128i b2 = _mm_load_si128((const __m128i*)&mState[2][2]);
+    __m128i b3 = _mm_load_si128((const __m128i*)&mState[3][2]);
+
+    for (size_t block = 0; block < blocks; block++)
+    {
+        _mm_storeu_si128((__m128i*)(out + block * 8), Step(a0, a1, a2, a3));
+        _mm_storeu_si128((__m128i*)(out + block * 8 + 4), Step(b0, b1, b2, b3));
+    }
+
+    _mm_store_si128((__m128i*)&mState[0][0], a0);
+    _mm_store_si128((__m128i*)&mState[1][0], a1);
+    _mm_store_si128((__m128i*)&mState[2][0], a2);
+    _mm_store_si128((__m128i*)&mState[3][0], a3);
+    _mm_store_si128((__m128i*)&mState[0][2], b0);
+    _mm_store_si128((__m128i*)&mState[1][2], b1);
+    _mm_store_si128((__m128i*)&mState[2][2], b2);
+    _mm_store_si128((__m128i*)&mState[3][2], b3);
+}
+
+#else
+
+static inline uint64_t RotateLeft(uint64_t value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+void RandomBatch::FillBlocks(uint32_t* out, size_t blocks)
+{
+    for (size_t block = 0; block < blocks; block++)
+    {
+        for (int lane = 0; lane < kLanes; lane++)
+        {
+            uint64_t& s0 = mState[0][lane];
+            uint64_t& s1 = mState[1][lane];
+            uint64_t& s2 = mState[2][lane];
+            uint64_t& s3 = mState[3][lane];
+
+            uint64_t result = RotateLeft(s0 + s3, 23) + s0;
+            uint64_t shifted = s1 << 17;
+            s2 ^= s0;
+            s3 ^= s1;
+            s1 ^= s2;
+            s0 ^= s3;
+            s2 ^= shifted;
+            s3 = RotateLeft(s3, 45);
+
+            // Same order as the SSE2 store: low half first
+            out[block * 8 + lane * 2] = (uint32_t)result;
+            out[block * 8 + lane * 2 + 1] = (uint32_t)(result >> 32);
+        }
+    }
+}
+
+#endif
+
+void RandomBatch::Fill(uint32_t* out, size_t count)
+{
+    const size_t kBlock = kLanes * 2;
+    size_t blocks = count / kBlock;
+    FillBlocks(out, blocks);
+
+    size_t remaining = count - blocks * kBlock;
+    if (remaining > 0)
+    {
+        uint32_t last[kBlock];
+        FillBlocks(last, 1);
+        memcpy(out + blocks * kBlock, last, remaining * sizeof(uint32_t));
+    }
+}
+
+void RandomBatch::FillBounded(uint32_t* out, size_t count, uint32_t range)
+{
+    Fill(out, count);
+
+    // Bounded()'s multiply over the whole array; it's very rare for any value to need
+    // redrawing, so that's left to a scalar generator (seeded from this batch).
+    const uint32_t threshold = (0u - range) % range;
+    Xoshiro256pp* redraw = nullptr;
+    Xoshiro256pp redrawGenerator(0);
+
+    for (size_t index = 0; index < count; index++)
+    {
+        uint64_t product = (uint64_t)out[index] * range;
+        while ((uint32_t)product < threshold)
+        {
+            if (redraw == nullptr)
+            {
+                uint32_t seed[2];
+                Fill(seed, 2);
+                redrawGenerator.Seed(((uint64_t)seed[0] << 32) | seed[1]);
+                redraw = &redrawGenerator;
+            }
+            product = (uint64_t)redraw->Next32() * range;
+        }
+        out[index] = (uint32_t)(product >> 32);
+    }
+}
+
+/// ---------------------------------------------------------------------------------
+/// Per thread generators
+/// ---------------------------------------------------------------------------------
+
+// Each thread takes the next seed from here the first time it asks for a generator.
+static std::atomic<uint64_t> gNextThreadSeed(0x9E3779B97F4A7C15ull);
+
+struct ThreadGenerators
+{
+    ThreadGenerators()
+    {
+        uint64_t seed = gNextThreadSeed.fetch_add(0x9E3779B97F4A7C15ull);
+        Seed(SplitMix64(seed));
+    }
+
+    void Seed(uint64_t seed)
+    {
+        scalar.Seed(seed);
+        batch.Seed(seed ^ 0xD1B54A32D192ED03ull);
+    }
+
+    Xoshiro256pp scalar;
+    RandomBatch batch;
+};
+
+static ThreadGenerators& Generators()
+{
+    static thread_local ThreadGenerators generators;
+    return generators;
+}
+
+Xoshiro256pp& ThreadRandom()
+{
+    return Generators().scalar;
+}
+
+RandomBatch& ThreadRandomBatch()
+{
+    return Generators().batch;
+}
+
+void SeedThreadRandom(uint64_t seed)
+{
+    Generators().Seed(seed);
+}
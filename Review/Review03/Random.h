@@ -0,0 +1,181 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// ---------------------------------------------------------------------------------
+/// Random numbers, without rand().
+///
+/// rand() is a function call per number, a lot of C libraries take a lock inside it,
+/// RAND_MAX can be as small as 32767, and its low bits are poor. On top of that,
+/// `rand() % width` is biased: unless width divides RAND_MAX + 1 evenly, the low
+/// values come up more often than the high ones.
+///
+/// What's here instead:
+///  - two small engines, xoshiro256++ and PCG32, both far better than rand() and
+///    cheap enough to inline,
+///  - Bounded(), Lemire's "nearly divisionless" way of getting an unbiased number in
+///    [0, range): one multiply, and a divide only in the rare case it might need to
+///    reject a value,
+///  - RandomBatch, four xoshiro256++ generators run side by side with SSE2, for
+///    filling whole arrays at once,
+///  - ThreadRandom()/ThreadRandomBatch(), a generator per thread, so no locks and no
+///    sharing.
+/// ---------------------------------------------------------------------------------
+
+/// SplitMix64: turns one 64-bit seed into a stream of well mixed 64-bit values. Used
+/// to fill the bigger engines' state from a single seed.
+inline uint64_t SplitMix64(uint64_t& state)
+{
+    uint64_t value = (state += 0x9E3779B97F4A7C15ull);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+/// xoshiro256++ (Blackman and Vigna): 256 bits of state, a period of 2^256 - 1, and
+/// a handful of adds, shifts and xors per 64-bit number.
+class Xoshiro256pp
+{
+public:
+    explicit Xoshiro256pp(uint64_t seed = 0x853C49E6748FEA9Bull) { Seed(seed); }
+
+    void Seed(uint64_t seed)
+    {
+        for (uint64_t& word : mState)
+            word = SplitMix64(seed);
+    }
+
+    uint64_t Next()
+    {
+        uint64_t result = RotateLeft(mState[0] + mState[3], 23) + mState[0];
+        uint64_t shifted = mState[1] << 17;
+
+        mState[2] ^= mState[0];
+        mState[3] ^= mState[1];
+        mState[1] ^= mState[2];
+        mState[0] ^= mState[3];
+        mState[2] ^= shifted;
+        mState[3] = RotateLeft(mState[3], 45);
+
+        return result;
+    }
+
+    /// The top half of Next(); the high bits are the best ones.
+    uint32_t Next32() { return (uint32_t)(Next() >> 32); }
+
+    /// Skips ahead 2^128 numbers, as if Next() had been called that many times. Start
+    /// from one seed and Jump() between each copy to get generators whose sequences
+    /// can't overlap.
+    void Jump();
+
+    const uint64_t* State() const { return mState; }
+
+private:
+    static uint64_t RotateLeft(uint64_t value, int bits) { return (value << bits) | (value >> (64 - bits)); }
+
+    uint64_t mState[4];
+};
+
+/// PCG32 (O'Neill), the XSH-RR variant: a 64-bit LCG with a permuted output. Half the
+/// state of xoshiro256++, and `stream` picks one of 2^63 independent sequences.
+class Pcg32
+{
+public:
+    explicit Pcg32(uint64_t seed = 0x853C49E6748FEA9Bull, uint64_t stream = 0xDA3E39CB94B95BDBull)
+    {
+        Seed(seed, stream);
+    }
+
+    void Seed(uint64_t seed, uint64_t stream)
+    {
+        mState = 0;
+        mIncrement = (stream << 1) | 1;
+        Next32();
+        mState += seed;
+        Next32();
+    }
+
+    uint32_t Next32()
+    {
+        uint64_t previous = mState;
+        mState = previous * 6364136223846793005ull + mIncrement;
+        uint32_t xorShifted = (uint32_t)(((previous >> 18) ^ previous) >> 27);
+        uint32_t rotation = (uint32_t)(previous >> 59);
+        return (xorShifted >> rotation) | (xorShifted << ((0u - rotation) & 31));
+    }
+
+    uint64_t Next()
+    {
+        uint64_t high = Next32();
+        return (high << 32) | Next32();
+    }
+
+private:
+    uint64_t mState;
+    uint64_t mIncrement;
+};
+
+/// An unbiased number in [0, range), from any engine with a Next32(). `range` must
+/// not be 0.
+///
+/// Multiplying a random 32-bit number by `range` gives a 64-bit product whose top half
+/// is in [0, range). That alone is very slightly biased, the same way `%` is; the
+/// bottom half tells us when we've landed in the few values that cause it, so those
+/// (and only those) are thrown away and redrawn.
+template<typename Engine>
+inline uint32_t Bounded(Engine& engine, uint32_t range)
+{
+    uint64_t product = (uint64_t)engine.Next32() * range;
+    uint32_t low = (uint32_t)product;
+    if (low < range)
+    {
+        uint32_t threshold = (0u - range) % range;
+        while (low < threshold)
+        {
+            product = (uint64_t)engine.Next32() * range;
+            low = (uint32_t)product;
+        }
+    }
+    return (uint32_t)(product >> 32);
+}
+
+/// ---------------------------------------------------------------------------------
+/// Four xoshiro256++ generators, a 2^128 Jump() apart, stepped together. The state is
+/// kept lane by lane (all four s[0]s together, and so on), so with SSE2 one step of
+/// two generators is a few instructions on a pair of registers. Each step gives four
+/// 64-bit numbers, which come out as eight 32-bit ones.
+///
+/// Builds without SSE2 run the same steps one lane at a time, and produce exactly the
+/// same numbers.
+/// ---------------------------------------------------------------------------------
+class RandomBatch
+{
+public:
+    static const int kLanes = 4;
+
+    explicit RandomBatch(uint64_t seed = 0x853C49E6748FEA9Bull) { Seed(seed); }
+
+    void Seed(uint64_t seed);
+
+    /// `count` random 32-bit numbers. The generators step eight numbers at a time; if
+    /// `count` isn't a multiple of eight, the rest of the last step is thrown away.
+    void Fill(uint32_t* out, size_t count);
+
+    /// `count` unbiased numbers in [0, range), using Bounded()'s multiply and reject.
+    /// `range` must not be 0.
+    void FillBounded(uint32_t* out, size_t count, uint32_t range);
+
+private:
+    void FillBlocks(uint32_t* out, size_t blocks);
+
+    alignas(16) uint64_t mState[4][kLanes];   ///< mState[word][lane]
+};
+
+/// This thread's generators. Each thread's are seeded differently the first time it
+/// asks, so threads never share (or lock) anything.
+Xoshiro256pp& ThreadRandom();
+RandomBatch& ThreadRandomBatch();
+
+/// Reseeds the calling thread's generators, to get a repeatable sequence.
+void SeedThreadRandom(uint64_t seed);
@@ -1,20 +1,170 @@
 // Review03.cpp : Defines the entry point for the application.
 //
 
+#include <atomic>
+#include <chrono>
 #include <stdio.h>
+#include <stdlib.h>
+#include <thread>
 #include <allegro5/allegro.h>
 #include <allegro5/allegro_primitives.h>
 #include <allegro5/allegro_font.h>
 
-const int maxiterations = 50;
+#include "DrawFrame.h"
+#include "FixedTimestep.h"
+#include "FrameStats.h"
+#include "LockFreeQueue.h"
+#include "ThreadPool.h"
+#include "TiledFrame.h"
 
-void DrawFrame(int width, int height);
+typedef std::chrono::steady_clock Clock;
+
+// The simulation runs at a fixed 120 steps a second; frames are drawn at (up to) 60.
+const double kSimulationStep = 1.0 / 120.0;
+const double kFrameBudget = 1.0 / 60.0;
+
+// Set by the event thread when the window is closed
+std::atomic<bool> gQuit(false);
+
+// Times are in seconds since gStart
+Clock::time_point gStart;
+
+static double SecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Something to simulate: a square bouncing around the window
+struct Square
+{
+    float x, y;
+    float speedX, speedY;
+};
+
+static void Simulate(Square& square, float seconds)
+{
+    square.x += square.speedX * seconds;
+    square.y += square.speedY * seconds;
+
+    // Bounce off the edges of the window (the square is 40x40)
+    if ((square.x < 0.0f && square.speedX < 0.0f) || (square.x > 760.0f && square.speedX > 0.0f))
+        square.speedX = -square.speedX;
+    if ((square.y < 0.0f && square.speedY < 0.0f) || (square.y > 560.0f && square.speedY > 0.0f))
+        square.speedY = -square.speedY;
+}
+
+static Square Lerp(const Square& from, const Square& to, float alpha)
+{
+    Square square = to;
+    square.x = from.x + (to.x - from.x) * alpha;
+    square.y = from.y + (to.y - from.y) * alpha;
+    return square;
+}
+
+// What the simulation and event threads tell the render thread. Neither of them
+// waits for it (or for each other): they push into a lock-free queue, and the render
+// thread empties it at the start of every frame.
+struct Message
+{
+    enum Type
+    {
+        kState,         // `square` is the simulation's state at `time`, after a step
+        kKeyPress,      // A key went down at `time`
+    };
+
+    Type   type;
+    double time;
+    Square square;
+};
+
+// A couple of seconds of steps: plenty, unless the render thread stops altogether
+const size_t kMessageQueueSize = 256;
+
+static void PushMessage(MpscQueue<Message>& messages, const Message& message)
+{
+    // Full means the render thread has fallen a long way behind. Rather than lose the
+    // message, give it a chance to catch up - sleeping, so as not to take a core it
+    // could be using. Each try counts as a stall in the queue's stats.
+    while (!messages.TryPush(message) && !gQuit.load())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+// The simulation has a thread of its own, so a slow frame doesn't hold it up - it
+// just keeps stepping, and the render thread draws wherever it's got to.
+static void SimulationLoop(MpscQueue<Message>* messages, long long* droppedSteps)
+{
+    FixedTimestep timestep(kSimulationStep);
+    Message message;
+    message.type = Message::kState;
+    message.time = 0.0;
+    message.square = { 100.0f, 100.0f, 240.0f, 170.0f };
+    PushMessage(*messages, message);
+
+    Clock::time_point lastStep = Clock::now();
+    while (!gQuit.load())
+    {
+        Clock::time_point stepStart = Clock::now();
+        double elapsed = std::chrono::duration<double>(stepStart - lastStep).count();
+        lastStep = stepStart;
+
+        int steps = timestep.Advance(elapsed);
+        double now = SecondsSince(gStart);
+        for (int step = 0; step < steps; step++)
+        {
+            Simulate(message.square, (float)timestep.Step());
+            message.time = now - (steps - 1 - step) * timestep.Step();
+            PushMessage(*messages, message);
+        }
+
+        std::this_thread::sleep_until(stepStart + std::chrono::duration_cast<Clock::duration>(
+                                                      std::chrono::duration<double>(kSimulationStep)));
+    }
+
+    *droppedSteps = timestep.DroppedSteps();
+}
+
+// Events are handled on their own thread, so closing the window (or, later, any other
+// input) gets noticed straight away, however long a frame takes to draw. Allegro's
+// event queues are safe to wait on from another thread; the drawing itself stays on
+// the thread that created the display.
+static void EventLoop(ALLEGRO_EVENT_QUEUE* eventQueue, MpscQueue<Message>* messages)
+{
+    while (!gQuit.load())
+    {
+        ALLEGRO_EVENT event;
+        ALLEGRO_TIMEOUT timeout;
+        al_init_timeout(&timeout, 0.1);
+
+        bool get_event = al_wait_for_event_until(eventQueue, &event, &timeout);
+
+        if (get_event && (event.type == ALLEGRO_EVENT_DISPLAY_CLOSE))
+        {
+            gQuit.store(true);
+        }
+
+        if (get_event && event.type == ALLEGRO_EVENT_KEY_DOWN)
+        {
+            Message message;
+            message.type = Message::kKeyPress;
+            message.time = SecondsSince(gStart);
+            message.square = Square();
+            PushMessage(*messages, message);
+        }
+    }
+}
 
 int main(int argc, char* argv[])
 {
+    // Review03 [threads] [frames.csv]: 0 threads (the default) means one per core
+    int threads = argc > 1 ? atoi(argv[1]) : 0;
+    const char* csvPath = argc > 2 ? argv[2] : "Review03Frames.csv";
+
     al_init();
     al_init_font_addon();
     al_init_primitives_addon();
+    al_install_keyboard();
 
     ALLEGRO_DISPLAY* display = al_create_display(800, 600);
     ALLEGRO_FONT* font = al_create_builtin_font();
@@ -22,6 +172,7 @@ int main(int argc, char* argv[])
 
     eventQueue = al_create_event_queue();
     al_register_event_source(eventQueue, al_get_display_event_source(display));
+    al_register_event_source(eventQueue, al_get_keyboard_event_source());
 
     al_clear_to_color(al_map_rgb(0, 0, 0));
 
@@ -31,36 +182,120 @@ int main(int argc, char* argv[])
                 ALLEGRO_ALIGN_CENTER,
                 "Welcome to Review03");
 
-    while (true)
-    {
-        ALLEGRO_EVENT event;
-        ALLEGRO_TIMEOUT timeout;
-        al_init_timeout(&timeout, 0.06);
+    al_flip_display();
 
-        bool get_event = al_wait_for_event_until(eventQueue, &event, &timeout);
+    gStart = Clock::now();
+    MpscQueue<Message> messages(kMessageQueueSize);
+    long long droppedSteps = 0;
+    std::thread eventThread(EventLoop, eventQueue, &messages);
+    std::thread simulationThread(SimulationLoop, &messages, &droppedSteps);
 
-        if (get_event && (event.type == ALLEGRO_EVENT_DISPLAY_CLOSE))
+    // The frame is drawn in 64x64 tiles, spread over the pool, then copied to the
+    // backbuffer in one go. See TiledFrame.h.
+    ThreadPool pool(threads);
+    TiledFrame frame(800, 600);
+
+    // The last two states the simulation sent. The square is drawn one step in the
+    // past, so that there's (nearly always) a state either side of it to blend.
+    Message previous;
+    Message current;
+    bool haveState = false;
+
+    // When the oldest key press that hasn't been on screen yet happened; negative
+    // when there isn't one. Only the first press counts until it's been drawn; later
+    // ones would only make the latency look shorter than it was.
+    double pendingInput = -1.0;
+
+    // How long each frame's work took (not counting the wait for the next one), and
+    // how long a key press took to reach the screen. The running report only looks
+    // at the last kReportFrames frames, so printing it costs the same an hour in as
+    // it did at the start.
+    //
+    // frameStats keeps every frame of the session, on purpose: the CSV is for finding
+    // the spikes in a long soak test. It's 4 bytes a frame, under 1 MB an hour at 60
+    // frames a second.
+    const size_t kReportFrames = 300;
+    char recentLabel[32];
+    snprintf(recentLabel, sizeof(recentLabel), "last %u frames", (unsigned)kReportFrames);
+    FrameStats frameStats(kFrameBudget);
+    FrameStats recentStats(kFrameBudget);
+    FrameStats inputStats(kFrameBudget);
+
+    while (!gQuit.load())
+    {
+        Clock::time_point frameStart = Clock::now();
+
+        Message message;
+        while (messages.TryPop(message))
         {
-            break;
+            if (message.type == Message::kState)
+            {
+                previous = haveState ? current : message;
+                current = message;
+                haveState = true;
+            }
+            else if (pendingInput < 0.0)
+            {
+                pendingInput = message.time;
+            }
         }
 
-        DrawFrame(800, 600);
+        frame.Render(pool, kPixelsPerFrame);
+        PresentFrame(frame);
+
+        if (haveState)
+        {
+            double drawTime = SecondsSince(gStart) - kSimulationStep;
+            double span = current.time - previous.time;
+            double alpha = span > 0.0 ? (drawTime - previous.time) / span : 1.0;
+            alpha = alpha < 0.0 ? 0.0 : (alpha > 1.0 ? 1.0 : alpha);
+
+            Square drawn = Lerp(previous.square, current.square, (float)alpha);
+            al_draw_filled_rectangle(drawn.x, drawn.y, drawn.x + 40.0f, drawn.y + 40.0f, al_map_rgb(255, 255, 255));
+        }
 
         al_flip_display();
+
+        if (pendingInput >= 0.0)
+        {
+            inputStats.Add(SecondsSince(gStart) - pendingInput);
+            pendingInput = -1.0;
+        }
+
+        // Before the frame's time is taken, so that the frame it's printed in pays for it
+        if (recentStats.Count() == kReportFrames)
+        {
+            recentStats.Print(stdout, recentLabel);
+            recentStats.Clear();
+        }
+
+        double frameSeconds = SecondsSince(frameStart);
+        frameStats.Add(frameSeconds);
+        recentStats.Add(frameSeconds);
+
+        // Frame pacing: don't start the next frame before this one's slot is up
+        std::this_thread::sleep_until(frameStart + std::chrono::duration_cast<Clock::duration>(
+                                                       std::chrono::duration<double>(kFrameBudget)));
     }
 
+    eventThread.join();
+    simulationThread.join();
+
+    // If the queue was ever close to full, or pushes found it full, it wants to be
+    // bigger (or the render thread faster)
+    QueueStats queueStats = messages.Stats();
+    printf("%d threads, %lld simulation steps dropped\n", pool.ThreadCount(), droppedSteps);
+    printf("%llu messages, at most %u of %u waiting, %llu pushes found the queue full\n",
+           (unsigned long long)queueStats.pushed, (unsigned)queueStats.maxDepth, (unsigned)messages.Capacity(),
+           (unsigned long long)queueStats.fullStalls);
+    frameStats.Print(stdout, "frame");
+    inputStats.Print(stdout, "input latency");
+    if (frameStats.WriteCSV(csvPath))
+        printf("Wrote %s\n", csvPath);
+
+    al_destroy_event_queue(eventQueue);
     al_destroy_font(font);
     al_destroy_display(display);
 
     return 0;
 }
-
-void DrawFrame(int width, int height)
-{
-    // Drawing individual pixels in this manner is incredibly slow. This is only for illustration
-    // on the C syntax.
-    for (int index = 0; index < maxiterations; index++)
-    {
-        al_put_pixel(rand() % width, rand() % height, al_map_rgb(rand()%255, rand()%255, rand()%255));
-    }
-}
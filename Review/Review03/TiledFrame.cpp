@@ -0,0 +1,54 @@
+#include "TiledFrame.h"
+
+#include <string.h>
+
+#include "ThreadPool.h"
+
+TiledFrame::TiledFrame(int width, int height, int tileSize)
+    : mFrame(width, height)
+    , mTileSize(tileSize > 0 ? tileSize : 64)
+{
+    mTilesAcross = (mFrame.Width() + mTileSize - 1) / mTileSize;
+    mTilesDown = (mFrame.Height() + mTileSize - 1) / mTileSize;
+}
+
+PixelSurface TiledFrame::Tile(int tile)
+{
+    PixelSurface frame = mFrame.Surface();
+    int left = (tile % mTilesAcross) * mTileSize;
+    int top = (tile / mTilesAcross) * mTileSize;
+
+    // Same pitch as the whole frame: the tile's rows are just shorter
+    PixelSurface surface;
+    surface.rows = (uint8_t*)(PixelRow(frame, top) + left);
+    surface.pitch = frame.pitch;
+    surface.width = frame.width - left < mTileSize ? frame.width - left : mTileSize;
+    surface.height = frame.height - top < mTileSize ? frame.height - top : mTileSize;
+    return surface;
+}
+
+void TiledFrame::Render(ThreadPool& pool, int pixelCount)
+{
+    const int64_t frameArea = (int64_t)Width() * Height();
+    if (frameArea == 0)
+        return;
+
+    pool.ParallelFor(TileCount(), [this, pixelCount, frameArea](int tile)
+    {
+        PixelSurface surface = Tile(tile);
+        int64_t area = (int64_t)surface.width * surface.height;
+        ScatterPixels(surface, (int)(pixelCount * area / frameArea));
+    });
+}
+
+void TiledFrame::CompositeTo(const PixelSurface& target) const
+{
+    int width = target.width < Width() ? target.width : Width();
+    int height = target.height < Height() ? target.height : Height();
+    const uint32_t* source = mFrame.Pixels().data();
+
+    for (int y = 0; y < height; y++)
+    {
+        memcpy(PixelRow(target, y), source + (size_t)y * Width(), (size_t)width * sizeof(uint32_t));
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "PixelSurface.h"
+
+class ThreadPool;
+
+/// ---------------------------------------------------------------------------------
+/// A frame that's drawn in tiles, in parallel.
+///
+/// The frame lives in its own MemorySurface, cut into `tileSize` squares (smaller at
+/// the right and bottom edges). Render() hands the tiles to a ThreadPool; each tile
+/// gets its share of the frame's random pixels, drawn only inside it, so no two
+/// threads ever write the same memory. CompositeTo() then copies the finished frame
+/// into the real target - a locked Allegro bitmap, say - one row at a time.
+///
+/// Every thread draws its random numbers from its own ThreadRandomBatch(), so there's
+/// nothing shared to fight over.
+/// ---------------------------------------------------------------------------------
+class TiledFrame
+{
+public:
+    TiledFrame(int width, int height, int tileSize = 64);
+
+    int Width() const { return mFrame.Width(); }
+    int Height() const { return mFrame.Height(); }
+    int TileCount() const { return mTilesAcross * mTilesDown; }
+
+    /// Scatters `pixelCount` pixels over the frame, spread across the tiles by area.
+    void Render(ThreadPool& pool, int pixelCount);
+
+    /// Copies the frame into `target`, clipped to whichever is smaller.
+    void CompositeTo(const PixelSurface& target) const;
+
+    const MemorySurface& Frame() const { return mFrame; }
+
+private:
+    /// A view of one tile of mFrame
+    PixelSurface Tile(int tile);
+
+    MemorySurface mFrame;
+    int mTileSize;
+    int mTilesAcross;
+    int mTilesDown;
+};
@@ -0,0 +1,226 @@
+#include "VertexLayouts.h"
+
+/// ---------------------------------------------------------------------------------
+/// VertexArraySoA
+/// ---------------------------------------------------------------------------------
+void VertexArraySoA::Resize(size_t count)
+{
+    x.resize(count);
+    y.resize(count);
+    r.resize(count);
+    g.resize(count);
+    b.resize(count);
+    u.resize(count);
+    v.resize(count);
+}
+
+Vertex VertexArraySoA::Get(size_t index) const
+{
+    Vertex vertex;
+    vertex.position.x = x[index];
+    vertex.position.y = y[index];
+    vertex.color.r = r[index];
+    vertex.color.g = g[index];
+    vertex.color.b = b[index];
+    vertex.texCoord.u = u[index];
+    vertex.texCoord.v = v[index];
+    return vertex;
+}
+
+void VertexArraySoA::Set(size_t index, const Vertex& vertex)
+{
+    x[index] = vertex.position.x;
+    y[index] = vertex.position.y;
+    r[index] = vertex.color.r;
+    g[index] = vertex.color.g;
+    b[index] = vertex.color.b;
+    u[index] = vertex.texCoord.u;
+    v[index] = vertex.texCoord.v;
+}
+
+/// ---------------------------------------------------------------------------------
+/// VertexArrayAoSoA
+/// ---------------------------------------------------------------------------------
+void VertexArrayAoSoA::Resize(size_t count)
+{
+    mBlocks.resize((count + VertexBlock8::kCount - 1) / VertexBlock8::kCount, VertexBlock8());
+    mCount = count;
+
+    // New blocks are zero already, but shrinking leaves the old vertices in the lanes
+    // past the end
+    if (mBlocks.empty())
+        return;
+
+    VertexBlock8& last = mBlocks.back();
+    for (size_t lane = count - (mBlocks.size() - 1) * VertexBlock8::kCount; lane < VertexBlock8::kCount; lane++)
+    {
+        last.x[lane] = last.y[lane] = 0.0f;
+        last.r[lane] = last.g[lane] = last.b[lane] = 0.0f;
+        last.u[lane] = last.v[lane] = 0.0f;
+    }
+}
+
+Vertex VertexArrayAoSoA::Get(size_t index) const
+{
+    const VertexBlock8& block = mBlocks[index / VertexBlock8::kCount];
+    size_t lane = index % VertexBlock8::kCount;
+
+    Vertex vertex;
+    vertex.position.x = block.x[lane];
+    vertex.position.y = block.y[lane];
+    vertex.color.r = block.r[lane];
+    vertex.color.g = block.g[lane];
+    vertex.color.b = block.b[lane];
+    vertex.texCoord.u = block.u[lane];
+    vertex.texCoord.v = block.v[lane];
+    return vertex;
+}
+
+void VertexArrayAoSoA::Set(size_t index, const Vertex& vertex)
+{
+    VertexBlock8& block = mBlocks[index / VertexBlock8::kCount];
+    size_t lane = index % VertexBlock8::kCount;
+
+    block.x[lane] = vertex.position.x;
+    block.y[lane] = vertex.position.y;
+    block.r[lane] = vertex.color.r;
+    block.g[lane] = vertex.color.g;
+    block.b[lane] = vertex.color.b;
+    block.u[lane] = vertex.texCoord.u;
+    block.v[lane] = vertex.texCoord.v;
+}
+
+/// ---------------------------------------------------------------------------------
+/// Transform and cull
+///
+/// The same arithmetic for every layout; only where the positions are changes. The
+/// visibility test is written with `&` rather than `&&`, so there are no branches and
+/// the compiler is free to vectorize the SoA and AoSoA loops. Each loop works from
+/// local copies of the transform and bounds: as far as the compiler knows, writing
+/// through a float* could change them, which would stop it keeping them in
+/// registers.
+/// ---------------------------------------------------------------------------------
+static inline size_t TransformPoint(float& x, float& y, const Transform2D& transform, const CullRect& bounds)
+{
+    float newX = transform.m00 * x + transform.m01 * y + transform.tx;
+    float newY = transform.m10 * x + transform.m11 * y + transform.ty;
+    x = newX;
+    y = newY;
+    return (size_t)((newX >= bounds.left) & (newX < bounds.right) & (newY >= bounds.top) & (newY < bounds.bottom));
+}
+
+size_t TransformAndCull(VertexArrayAoS& vertices, const Transform2D& transformIn, const CullRect& boundsIn)
+{
+    const Transform2D transform = transformIn;
+    const CullRect bounds = boundsIn;
+    Vertex* vertex = vertices.Data();
+    const size_t count = vertices.Size();
+    size_t visible = 0;
+
+    for (size_t index = 0; index < count; index++)
+    {
+        visible += TransformPoint(vertex[index].position.x, vertex[index].position.y, transform, bounds);
+    }
+    return visible;
+}
+
+size_t TransformAndCull(VertexArraySoA& vertices, const Transform2D& transformIn, const CullRect& boundsIn)
+{
+    const Transform2D transform = transformIn;
+    const CullRect bounds = boundsIn;
+    float* x = vertices.x.data();
+    float* y = vertices.y.data();
+    const size_t count = vertices.Size();
+    size_t visible = 0;
+
+    for (size_t index = 0; index < count; index++)
+    {
+        visible += TransformPoint(x[index], y[index], transform, bounds);
+    }
+    return visible;
+}
+
+size_t TransformAndCull(VertexArrayAoSoA& vertices, const Transform2D& transformIn, const CullRect& boundsIn)
+{
+    const Transform2D transform = transformIn;
+    const CullRect bounds = boundsIn;
+    VertexBlock8* blocks = vertices.Blocks();
+    const size_t blockCount = vertices.BlockCount();
+    size_t visible = 0;
+
+    for (size_t index = 0; index < blockCount; index++)
+    {
+        VertexBlock8& block = blocks[index];
+        for (int lane = 0; lane < VertexBlock8::kCount; lane++)
+        {
+            visible += TransformPoint(block.x[lane], block.y[lane], transform, bounds);
+        }
+    }
+
+    // The padding in the last block doesn't count, even if (0, 0) ends up on screen;
+    // and it goes back to (0, 0), as Resize() left it
+    size_t padding = blockCount * VertexBlock8::kCount - vertices.Size();
+    if (padding > 0)
+    {
+        VertexBlock8& last = blocks[blockCount - 1];
+        for (int lane = VertexBlock8::kCount - (int)padding; lane < VertexBlock8::kCount; lane++)
+        {
+            visible -= (size_t)((last.x[lane] >= bounds.left) & (last.x[lane] < bounds.right) &
+                                (last.y[lane] >= bounds.top) & (last.y[lane] < bounds.bottom));
+            last.x[lane] = 0.0f;
+            last.y[lane] = 0.0f;
+        }
+    }
+    return visible;
+}
+
+size_t TransformAndCull(CompactVertexArray& vertices, const Transform2D& transformIn, const CullRect& boundsIn)
+{
+    const Transform2D transform = transformIn;
+    const CullRect bounds = boundsIn;
+    CompactVertex* vertex = vertices.Data();
+    const size_t count = vertices.Size();
+    size_t visible = 0;
+
+    for (size_t index = 0; index < count; index++)
+    {
+        visible += TransformPoint(vertex[index].position.x, vertex[index].position.y, transform, bounds);
+    }
+    return visible;
+}
+
+size_t TransformAndCull(VisibleVertex01* vertices, size_t count, const Transform2D& transformIn, const CullRect& boundsIn)
+{
+    const Transform2D transform = transformIn;
+    const CullRect bounds = boundsIn;
+    size_t visible = 0;
+
+    for (size_t index = 0; index < count; index++)
+    {
+        size_t inside = TransformPoint(vertices[index].position.x, vertices[index].position.y, transform, bounds);
+        vertices[index].visible = inside != 0;
+        visible += inside;
+    }
+    return visible;
+}
+
+size_t TransformAndCull(VisibleVertex02* vertices, size_t count, const Transform2D& transformIn, const CullRect& boundsIn)
+{
+    const Transform2D transform = transformIn;
+    const CullRect bounds = boundsIn;
+    size_t visible = 0;
+
+    // No references into a packed struct: its floats aren't aligned, and a float& is
+    // allowed to assume they are. Copy out, transform, copy back.
+    for (size_t index = 0; index < count; index++)
+    {
+        float x = vertices[index].position.x;
+        float y = vertices[index].position.y;
+        size_t inside = TransformPoint(x, y, transform, bounds);
+        vertices[index].position.x = x;
+        vertices[index].position.y = y;
+        vertices[index].visible = inside != 0;
+        visible += inside;
+    }
+    return visible;
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+
+#include "VertexTypes.h"
+
+/// ---------------------------------------------------------------------------------
+/// Three ways of laying out lots of vertices in memory.
+///
+/// AoS, 'array of structures': a plain array of Vertex. Everything about one vertex
+/// is together, which is what you want when you use all of it at once. But a loop
+/// that only moves positions still drags the colors and UVs through the cache: 28
+/// bytes read for every 8 used.
+///
+/// SoA, 'structure of arrays': one array per field, all the x's, then all the y's,
+/// and so on. A position-only loop reads just the two arrays it needs, and reads
+/// them in a straight line, 8 (or 16) floats at a time with SIMD.
+///
+/// AoSoA, 'array of structures of arrays': SoA in blocks of 8 vertices. A block has
+/// each field's 8 values side by side, just right for one AVX register (or two SSE
+/// ones), and the fields of those 8 vertices are close together in memory. Handy
+/// when a loop needs most of the fields.
+///
+/// All of them have the same Size()/Resize()/Get()/Set(), so ConvertLayout() can turn
+/// any one into any other, and so can CompactVertexArray, the AoS of CompactVertex.
+/// ---------------------------------------------------------------------------------
+
+class VertexArrayAoS
+{
+public:
+    size_t Size() const { return mVertices.size(); }
+    void Resize(size_t count) { mVertices.resize(count); }
+
+    Vertex Get(size_t index) const { return mVertices[index]; }
+    void Set(size_t index, const Vertex& vertex) { mVertices[index] = vertex; }
+
+    Vertex* Data() { return mVertices.data(); }
+    const Vertex* Data() const { return mVertices.data(); }
+
+private:
+    std::vector<Vertex> mVertices;
+};
+
+class VertexArraySoA
+{
+public:
+    size_t Size() const { return x.size(); }
+    void Resize(size_t count);
+
+    Vertex Get(size_t index) const;
+    void Set(size_t index, const Vertex& vertex);
+
+    std::vector<float> x, y;
+    std::vector<float> r, g, b;
+    std::vector<float> u, v;
+};
+
+/// Eight vertices, field by field. 224 bytes; the alignment lets SIMD code use aligned
+/// loads (a std::vector of these only honours it from C++17 on).
+struct alignas(32) VertexBlock8
+{
+    static const int kCount = 8;
+
+    float x[kCount], y[kCount];
+    float r[kCount], g[kCount], b[kCount];
+    float u[kCount], v[kCount];
+};
+
+static_assert(sizeof(VertexBlock8) == 7 * 8 * sizeof(float), "VertexBlock8 should have no padding");
+static_assert(sizeof(VertexBlock8) % 32 == 0, "VertexBlocks should stay 32 byte aligned in an array");
+
+class VertexArrayAoSoA
+{
+public:
+    VertexArrayAoSoA() : mCount(0) {}
+
+    size_t Size() const { return mCount; }
+
+    /// The last block's unused slots are zero, and TransformAndCull() puts them back to
+    /// zero after it's moved them. Anything else that writes whole blocks through
+    /// Blocks() should do the same.
+    void Resize(size_t count);
+
+    Vertex Get(size_t index) const;
+    void Set(size_t index, const Vertex& vertex);
+
+    size_t BlockCount() const { return mBlocks.size(); }
+    VertexBlock8* Blocks() { return mBlocks.data(); }
+    const VertexBlock8* Blocks() const { return mBlocks.data(); }
+
+private:
+    std::vector<VertexBlock8> mBlocks;
+    size_t mCount;
+};
+
+/// AoS of CompactVertex: Set() compresses and Get() expands.
+class CompactVertexArray
+{
+public:
+    size_t Size() const { return mVertices.size(); }
+    void Resize(size_t count) { mVertices.resize(count); }
+
+    Vertex Get(size_t index) const { return Expand(mVertices[index]); }
+    void Set(size_t index, const Vertex& vertex) { mVertices[index] = Compress(vertex); }
+
+    CompactVertex* Data() { return mVertices.data(); }
+
+private:
+    std::vector<CompactVertex> mVertices;
+};
+
+/// Copies any of the layouts above into any other.
+template<typename To, typename From>
+To ConvertLayout(const From& from)
+{
+    To to;
+    to.Resize(from.Size());
+    for (size_t index = 0; index < from.Size(); index++)
+    {
+        to.Set(index, from.Get(index));
+    }
+    return to;
+}
+
+/// ---------------------------------------------------------------------------------
+/// Transform and cull: the position-only loop the layouts are here for.
+///
+/// Every vertex's position goes through `transform` (in place), and the return value
+/// is how many of them land inside `bounds`. The VisibleVertex versions also set each
+/// vertex's `visible` flag.
+/// ---------------------------------------------------------------------------------
+/// x' = m00 * x + m01 * y + tx, y' = m10 * x + m11 * y + ty (see Math2D.h)
+typedef Affine2D Transform2D;
+
+struct CullRect
+{
+    float left, top, right, bottom;
+};
+
+size_t TransformAndCull(VertexArrayAoS& vertices, const Transform2D& transform, const CullRect& bounds);
+size_t TransformAndCull(VertexArraySoA& vertices, const Transform2D& transform, const CullRect& bounds);
+size_t TransformAndCull(VertexArrayAoSoA& vertices, const Transform2D& transform, const CullRect& bounds);
+size_t TransformAndCull(CompactVertexArray& vertices, const Transform2D& transform, const CullRect& bounds);
+size_t TransformAndCull(VisibleVertex01* vertices, size_t count, const Transform2D& transform, const CullRect& bounds);
+size_t TransformAndCull(VisibleVertex02* vertices, size_t count, const Transform2D& transform, const CullRect& bounds);
@@ -0,0 +1,104 @@
+#include "VertexTypes.h"
+
+#include <string.h>
+
+uint16_t FloatToHalf(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000;
+    uint32_t exponent = (bits >> 23) & 0xFF;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    // Infinity stays infinity; NaN keeps a mantissa bit so it stays NaN
+    if (exponent == 0xFF)
+        return (uint16_t)(sign | 0x7C00 | (mantissa != 0 ? 0x200 : 0));
+
+    int halfExponent = (int)exponent - 127 + 15;
+    if (halfExponent >= 31)
+        return (uint16_t)(sign | 0x7C00);
+
+    if (halfExponent <= 0)
+    {
+        // A half denormal (or zero): shift the mantissa, with its implicit 1, down
+        // into the 10 bits, rounding to nearest even on the bits that fall off.
+        if (halfExponent < -10)
+            return (uint16_t)sign;
+
+        mantissa |= 0x800000;
+        int shift = 14 - halfExponent;
+        uint32_t half = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half & 1)))
+            half++;
+        return (uint16_t)(sign | half);
+    }
+
+    // Rounding can carry into the exponent, which is exactly right (up to infinity)
+    uint32_t half = ((uint32_t)halfExponent << 10) | (mantissa >> 13);
+    uint32_t remainder = mantissa & 0x1FFF;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+        half++;
+    return (uint16_t)(sign | half);
+}
+
+float HalfToFloat(uint16_t half)
+{
+    uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1F;
+    uint32_t mantissa = half & 0x3FF;
+    uint32_t bits;
+
+    if (exponent == 0)
+    {
+        // Zero or a denormal: mantissa * 2^-24, which a float holds exactly
+        float value = (float)mantissa * (1.0f / 16777216.0f);
+        return sign != 0 ? -value : value;
+    }
+
+    if (exponent == 31)
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    else
+        bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+uint8_t FloatToUnorm8(float value)
+{
+    // Written so that NaN ends up as 0
+    if (!(value > 0.0f))
+        return 0;
+    if (value >= 1.0f)
+        return 255;
+    return (uint8_t)(value * 255.0f + 0.5f);
+}
+
+CompactVertex Compress(const Vertex& vertex)
+{
+    CompactVertex compact;
+    compact.position = vertex.position;
+    compact.color.r = FloatToUnorm8(vertex.color.r);
+    compact.color.g = FloatToUnorm8(vertex.color.g);
+    compact.color.b = FloatToUnorm8(vertex.color.b);
+    compact.color.a = 255;
+    compact.texCoord.u = FloatToHalf(vertex.texCoord.u);
+    compact.texCoord.v = FloatToHalf(vertex.texCoord.v);
+    return compact;
+}
+
+Vertex Expand(const CompactVertex& compact)
+{
+    Vertex vertex;
+    vertex.position = compact.position;
+    vertex.color.r = Unorm8ToFloat(compact.color.r);
+    vertex.color.g = Unorm8ToFloat(compact.color.g);
+    vertex.color.b = Unorm8ToFloat(compact.color.b);
+    vertex.texCoord.u = HalfToFloat(compact.texCoord.u);
+    vertex.texCoord.v = HalfToFloat(compact.texCoord.v);
+    return vertex;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "CacheLine.h"
+#include "Math2D.h"
+
+/// ---------------------------------------------------------------------------------
+/// The vertex structs from example02, in a header of their own so the layouts in
+/// VertexLayouts.h (and the benchmarks) can use them too. Point2D, RGB and RGBA are
+/// the shared ones from Common/Math2D.h: two, three and four floats, with operators.
+///
+/// The comments add up what you'd *expect* each struct to be; the static_asserts
+/// below say what the compiler actually does with them. If a change to a struct
+/// changes its size or alignment, the build breaks here instead of quietly using
+/// more memory (or, worse, a file format or vertex buffer not matching anymore).
+/// ---------------------------------------------------------------------------------
+
+struct UV
+{
+    float u;    // 4 bytes
+    float v;    // 4 bytes
+};              // 8 bytes total
+
+
+struct Vertex
+{
+    Point2D position;   // 8 bytes
+    RGB     color;      // 12  bytes
+    UV      texCoord;   // 8 bytes
+};                      // 28 bytes total
+
+struct VisibleVertex01
+{
+    bool    visible;    // 1 byte
+    Point2D position;   // 8 bytes
+    RGB     color;      // 12 bytes
+    UV      texCoord;   // 8 bytes
+};                      // 29 bytes total
+
+#pragma pack(push)
+#pragma pack(1)
+struct VisibleVertex02
+{
+    bool    visible;    // 1 byte
+    Point2D position;   // 8 bytes
+    RGB     color;      // 12 bytes
+    UV      texCoord;   // 8 bytes
+};                      // 29 bytes total
+#pragma pack(pop)
+
+static_assert(sizeof(Point2D) == 8, "Point2D should be two floats");
+static_assert(sizeof(RGB) == 12, "RGB should be three floats");
+static_assert(sizeof(RGBA) == 16, "RGBA should be four floats");
+static_assert(sizeof(UV) == 8, "UV should be two floats");
+
+static_assert(sizeof(Vertex) == 28 && alignof(Vertex) == 4, "Vertex should be 7 floats, with no padding");
+
+// Not 29: `position` has to start on a 4 byte boundary, so the compiler puts 3 bytes
+// of padding after `visible`.
+static_assert(sizeof(VisibleVertex01) == 32, "VisibleVertex01 should be padded to 32 bytes");
+static_assert(offsetof(VisibleVertex01, position) == 4, "VisibleVertex01::position should follow 3 bytes of padding");
+
+// Packed: really 29 bytes, but every float in it is now misaligned, and most of the
+// vertices in an array straddle two cache lines.
+static_assert(sizeof(VisibleVertex02) == 29 && alignof(VisibleVertex02) == 1, "VisibleVertex02 should be packed");
+static_assert(offsetof(VisibleVertex02, position) == 1, "VisibleVertex02::position should follow `visible` directly");
+
+/// ---------------------------------------------------------------------------------
+/// A compressed vertex. Colors rarely need more than 8 bits a channel, and texture
+/// coordinates are fine as 16-bit 'half' floats, so:
+///  - the color is four normalized bytes (0 means 0.0, 255 means 1.0), and gains an
+///    alpha channel on the way,
+///  - the UV is two halfs,
+///  - the position stays as full floats.
+///
+/// That's 16 bytes instead of 28, four to a cache line.
+/// ---------------------------------------------------------------------------------
+struct PackedColor
+{
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+    uint8_t a;
+};
+
+struct HalfUV
+{
+    uint16_t u;
+    uint16_t v;
+};
+
+struct CompactVertex
+{
+    Point2D     position;   // 8 bytes
+    PackedColor color;      // 4 bytes
+    HalfUV      texCoord;   // 4 bytes
+};                          // 16 bytes total
+
+static_assert(sizeof(PackedColor) == 4 && sizeof(HalfUV) == 4, "PackedColor and HalfUV should be 4 bytes each");
+static_assert(sizeof(CompactVertex) == 16 && alignof(CompactVertex) == 4, "CompactVertex should be 16 bytes");
+static_assert(kCacheLineSize % sizeof(CompactVertex) == 0, "CompactVertices shouldn't straddle cache lines");
+
+/// IEEE 754 half precision (1 sign bit, 5 exponent bits, 10 mantissa bits). Rounds to
+/// nearest even; too big becomes infinity, too small becomes zero (via the half
+/// denormals), and NaN stays NaN.
+uint16_t FloatToHalf(float value);
+float HalfToFloat(uint16_t half);
+
+/// Clamps to [0, 1] first.
+uint8_t FloatToUnorm8(float value);
+inline float Unorm8ToFloat(uint8_t value) { return (float)value * (1.0f / 255.0f); }
+
+/// Colors and UVs lose precision on the way in; a compressed vertex's alpha is 1.
+CompactVertex Compress(const Vertex& vertex);
+Vertex Expand(const CompactVertex& vertex);
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/// ---------------------------------------------------------------------------------
+/// The pieces VisibilityStream.cpp shares with VisibilityStreamSsse3.cpp, which is
+/// compiled with SSSE3 switched on and only ever called once the CPU has said it has
+/// it.
+/// ---------------------------------------------------------------------------------
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define VISIBILITY_X86 1
+#else
+#define VISIBILITY_X86 0
+#endif
+
+inline int PopCount64(uint64_t bits)
+{
+#if defined(__GNUC__)
+    return __builtin_popcountll(bits);
+#else
+    // MSVC's __popcnt64 is the POPCNT instruction, which older CPUs don't have
+    bits = bits - ((bits >> 1) & 0x5555555555555555ull);
+    bits = (bits & 0x3333333333333333ull) + ((bits >> 2) & 0x3333333333333333ull);
+    bits = (bits + (bits >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (int)((bits * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+/// `bits` must not be 0.
+inline int CountTrailingZeros64(uint64_t bits)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(bits);
+#elif defined(_M_X64) || defined(_M_ARM64)
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return (int)index;
+#else
+    unsigned long index;
+    if (_BitScanForward(&index, (unsigned long)bits))
+        return (int)index;
+    _BitScanForward(&index, (unsigned long)(bits >> 32));
+    return (int)index + 32;
+#endif
+}
+
+/// Copies the values whose bits are set in `word` to `dst`, one set bit at a time:
+/// the loop runs once per visible value, not once per value. Returns how many.
+inline size_t CompactWordScalar(const float* src, uint64_t word, float* dst)
+{
+    size_t written = 0;
+    while (word != 0)
+    {
+        dst[written++] = src[CountTrailingZeros64(word)];
+        word &= word - 1;
+    }
+    return written;
+}
+
+/// Compacts `src` (which holds `count` values) through words [firstWord, lastWord) of
+/// a bitset into `dst`, which has room for exactly `dstCount` values - never more, as
+/// the next chunk's output may start right after it. Returns how many were written.
+typedef size_t (*CompactFloatsKernel)(const float* src, size_t count, const uint64_t* words,
+                                      size_t firstWord, size_t lastWord, float* dst, size_t dstCount);
+
+#if VISIBILITY_X86
+size_t CompactFloatsSsse3(const float* src, size_t count, const uint64_t* words,
+                          size_t firstWord, size_t lastWord, float* dst, size_t dstCount);
+#endif
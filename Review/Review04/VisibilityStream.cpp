@@ -0,0 +1,216 @@
+#include "VisibilityStream.h"
+#include "VisibilityKernels.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISIBILITY_SSE2 1
+#else
+#define VISIBILITY_SSE2 0
+#endif
+
+/// ---------------------------------------------------------------------------------
+/// VisibilityBitset
+/// ---------------------------------------------------------------------------------
+void VisibilityBitset::Resize(size_t count)
+{
+    mWords.assign((count + 63) / 64, 0);
+    mCount = count;
+}
+
+size_t VisibilityBitset::CountVisible() const
+{
+    size_t visible = 0;
+    for (uint64_t word : mWords)
+    {
+        visible += (size_t)PopCount64(word);
+    }
+    return visible;
+}
+
+/// ---------------------------------------------------------------------------------
+/// Culling: one word of bits at a time. With SSE2, four vertices are compared at
+/// once and _mm_movemask_ps turns the four results into four bits; without it, each
+/// comparison's 0 or 1 is shifted into place. Either way, no branches.
+/// ---------------------------------------------------------------------------------
+static inline uint64_t CullScalar(const float* x, const float* y, size_t count, const CullRect& bounds)
+{
+    uint64_t word = 0;
+    for (size_t index = 0; index < count; index++)
+    {
+        uint64_t inside = (uint64_t)((x[index] >= bounds.left) & (x[index] < bounds.right) &
+                                     (y[index] >= bounds.top) & (y[index] < bounds.bottom));
+        word |= inside << index;
+    }
+    return word;
+}
+
+size_t Cull(VisibleVertexStream& stream, const CullRect& boundsIn)
+{
+    const CullRect bounds = boundsIn;
+    const float* x = stream.vertices.x.data();
+    const float* y = stream.vertices.y.data();
+    const size_t count = stream.Size();
+    uint64_t* words = stream.visible.Words();
+    size_t visible = 0;
+
+#if VISIBILITY_SSE2
+    const __m128 left = _mm_set1_ps(bounds.left);
+    const __m128 right = _mm_set1_ps(bounds.right);
+    const __m128 top = _mm_set1_ps(bounds.top);
+    const __m128 bottom = _mm_set1_ps(bounds.bottom);
+#endif
+
+    for (size_t index = 0; index < stream.visible.WordCount(); index++)
+    {
+        size_t first = index * 64;
+        uint64_t word;
+
+#if VISIBILITY_SSE2
+        if (first + 64 <= count)
+        {
+            word = 0;
+            for (int group = 0; group < 16; group++)
+            {
+                __m128 px = _mm_loadu_ps(x + first + group * 4);
+                __m128 py = _mm_loadu_ps(y + first + group * 4);
+                __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(px, left), _mm_cmplt_ps(px, right)),
+                                           _mm_and_ps(_mm_cmpge_ps(py, top), _mm_cmplt_ps(py, bottom)));
+                word |= (uint64_t)_mm_movemask_ps(inside) << (group * 4);
+            }
+        }
+        else
+#endif
+        {
+            word = CullScalar(x + first, y + first, std::min(count - first, (size_t)64), bounds);
+        }
+
+        words[index] = word;
+        visible += (size_t)PopCount64(word);
+    }
+    return visible;
+}
+
+/// ---------------------------------------------------------------------------------
+/// Compaction. The SoA version compacts each of the seven arrays in turn through the
+/// same bits; the kernel that does it is picked once, from what the CPU can do.
+/// ---------------------------------------------------------------------------------
+static size_t CompactFloatsScalar(const float* src, size_t count, const uint64_t* words,
+                                  size_t firstWord, size_t lastWord, float* dst, size_t dstCount)
+{
+    (void)count;
+    (void)dstCount;
+
+    size_t written = 0;
+    for (size_t index = firstWord; index < lastWord; index++)
+    {
+        written += CompactWordScalar(src + index * 64, words[index], dst + written);
+    }
+    return written;
+}
+
+#if VISIBILITY_X86
+static bool HasSsse3()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3") != 0;
+#endif
+}
+#endif
+
+static CompactFloatsKernel CompactFloats()
+{
+#if VISIBILITY_X86
+    static const CompactFloatsKernel kernel = HasSsse3() ? CompactFloatsSsse3 : CompactFloatsScalar;
+    return kernel;
+#else
+    return CompactFloatsScalar;
+#endif
+}
+
+static void CompactWords(const VisibleVertexStream& stream, size_t firstWord, size_t lastWord,
+                         VertexArraySoA& out, size_t outFirst, size_t outCount)
+{
+    CompactFloatsKernel compact = CompactFloats();
+    const uint64_t* words = stream.visible.Words();
+    const VertexArraySoA& in = stream.vertices;
+    const size_t count = stream.Size();
+
+    compact(in.x.data(), count, words, firstWord, lastWord, out.x.data() + outFirst, outCount);
+    compact(in.y.data(), count, words, firstWord, lastWord, out.y.data() + outFirst, outCount);
+    compact(in.r.data(), count, words, firstWord, lastWord, out.r.data() + outFirst, outCount);
+    compact(in.g.data(), count, words, firstWord, lastWord, out.g.data() + outFirst, outCount);
+    compact(in.b.data(), count, words, firstWord, lastWord, out.b.data() + outFirst, outCount);
+    compact(in.u.data(), count, words, firstWord, lastWord, out.u.data() + outFirst, outCount);
+    compact(in.v.data(), count, words, firstWord, lastWord, out.v.data() + outFirst, outCount);
+}
+
+size_t Compact(const VisibleVertexStream& stream, VertexArraySoA& out)
+{
+    size_t visible = stream.visible.CountVisible();
+    out.Resize(visible);
+    CompactWords(stream, 0, stream.visible.WordCount(), out, 0, visible);
+    return visible;
+}
+
+size_t Compact(const VertexArrayAoS& vertices, const VisibilityBitset& visible, VertexArrayAoS& out)
+{
+    out.Resize(visible.CountVisible());
+
+    const Vertex* in = vertices.Data();
+    const uint64_t* words = visible.Words();
+    Vertex* dst = out.Data();
+    size_t written = 0;
+
+    for (size_t index = 0; index < visible.WordCount(); index++)
+    {
+        uint64_t word = words[index];
+        while (word != 0)
+        {
+            dst[written++] = in[index * 64 + CountTrailingZeros64(word)];
+            word &= word - 1;
+        }
+    }
+    return written;
+}
+
+/// ---------------------------------------------------------------------------------
+/// Parallel compaction
+/// ---------------------------------------------------------------------------------
+CompactionPlan PlanCompaction(const VisibilityBitset& visible, int chunkCount)
+{
+    const size_t wordCount = visible.WordCount();
+    const uint64_t* words = visible.Words();
+    const size_t chunks = (size_t)std::max(chunkCount, 1);
+
+    CompactionPlan plan;
+    plan.wordsPerChunk = std::max((wordCount + chunks - 1) / chunks, (size_t)1);
+    plan.total = 0;
+
+    for (size_t first = 0; first < wordCount; first += plan.wordsPerChunk)
+    {
+        size_t last = std::min(first + plan.wordsPerChunk, wordCount);
+        plan.offsets.push_back(plan.total);
+        for (size_t index = first; index < last; index++)
+        {
+            plan.total += (size_t)PopCount64(words[index]);
+        }
+    }
+    return plan;
+}
+
+void CompactChunk(const CompactionPlan& plan, int chunk, const VisibleVertexStream& stream, VertexArraySoA& out)
+{
+    size_t firstWord = (size_t)chunk * plan.wordsPerChunk;
+    size_t lastWord = std::min(firstWord + plan.wordsPerChunk, stream.visible.WordCount());
+    size_t outFirst = plan.offsets[chunk];
+    size_t outLast = chunk + 1 < plan.ChunkCount() ? plan.offsets[chunk + 1] : plan.total;
+
+    CompactWords(stream, firstWord, lastWord, out, outFirst, outLast - outFirst);
+}
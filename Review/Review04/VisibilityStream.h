@@ -0,0 +1,99 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "VertexLayouts.h"
+
+/// ---------------------------------------------------------------------------------
+/// Visibility as a bitset, instead of a `bool visible` in every vertex.
+///
+/// VisibleVertex01 spends 4 bytes per vertex on one bit of information (the bool and
+/// its 3 bytes of padding), and using it means testing it: a branch per vertex, which
+/// the CPU mispredicts whenever visible and hidden vertices are mixed up.
+///
+/// Here, the vertices are plain SoA, and visibility is a separate array of bits, 64 to
+/// a word. Culling builds the words four comparisons at a time, with no branches.
+/// Compaction - copying only the visible vertices into a contiguous buffer - works a
+/// word at a time: empty words are skipped outright, full ones are copied outright,
+/// and the rest go through a SIMD kernel that packs four floats at a time.
+///
+/// Compaction can also run in parallel: PlanCompaction() splits the bitset into
+/// chunks, popcounts each, and prefix-sums the counts, so every chunk knows where its
+/// output starts before anyone has copied anything.
+/// ---------------------------------------------------------------------------------
+class VisibilityBitset
+{
+public:
+    VisibilityBitset() : mCount(0) {}
+
+    size_t Size() const { return mCount; }
+
+    /// Everything starts out hidden.
+    void Resize(size_t count);
+
+    bool Test(size_t index) const { return (mWords[index / 64] >> (index % 64)) & 1; }
+    void Set(size_t index, bool visible)
+    {
+        uint64_t bit = 1ull << (index % 64);
+        mWords[index / 64] = visible ? (mWords[index / 64] | bit) : (mWords[index / 64] & ~bit);
+    }
+
+    /// Popcount of the whole set
+    size_t CountVisible() const;
+
+    size_t WordCount() const { return mWords.size(); }
+    uint64_t* Words() { return mWords.data(); }
+    const uint64_t* Words() const { return mWords.data(); }
+
+private:
+    std::vector<uint64_t> mWords;   ///< Bits past Size() are always 0
+    size_t mCount;
+};
+
+struct VisibleVertexStream
+{
+    VertexArraySoA   vertices;
+    VisibilityBitset visible;
+
+    size_t Size() const { return vertices.Size(); }
+    void Resize(size_t count)
+    {
+        vertices.Resize(count);
+        visible.Resize(count);
+    }
+};
+
+/// Sets each vertex's bit to whether it's inside `bounds`; returns how many are.
+size_t Cull(VisibleVertexStream& stream, const CullRect& bounds);
+
+/// The visible vertices, in order, with nothing in between. Returns the count.
+size_t Compact(const VisibleVertexStream& stream, VertexArraySoA& out);
+
+/// The same for an AoS array with its own bitset.
+size_t Compact(const VertexArrayAoS& vertices, const VisibilityBitset& visible, VertexArrayAoS& out);
+
+/// ---------------------------------------------------------------------------------
+/// Parallel compaction
+///
+///     CompactionPlan plan = PlanCompaction(stream.visible, pool.ThreadCount() * 4);
+///     out.Resize(plan.total);
+///     pool.ParallelFor(plan.ChunkCount(), [&](int chunk) { CompactChunk(plan, chunk, stream, out); });
+///
+/// Each chunk only writes to its own part of `out`, so the chunks can run in any
+/// order on any thread.
+/// ---------------------------------------------------------------------------------
+struct CompactionPlan
+{
+    size_t wordsPerChunk;
+    std::vector<size_t> offsets;    ///< Where each chunk's output starts (an exclusive prefix sum)
+    size_t total;                   ///< Visible vertices altogether
+
+    int ChunkCount() const { return (int)offsets.size(); }
+};
+
+CompactionPlan PlanCompaction(const VisibilityBitset& visible, int chunkCount);
+
+/// `out` must already hold plan.total vertices.
+void CompactChunk(const CompactionPlan& plan, int chunk, const VisibleVertexStream& stream, VertexArraySoA& out);
@@ -0,0 +1,89 @@
+#include "VisibilityKernels.h"
+
+#if VISIBILITY_X86
+
+#include <string.h>
+#include <tmmintrin.h>
+
+/// ---------------------------------------------------------------------------------
+/// Compaction four floats at a time.
+///
+/// Four visibility bits make a number from 0 to 15, and for each of those there's a
+/// byte shuffle that moves the visible lanes to the front of a register: for 0101,
+/// lanes 0 and 2 go to lanes 0 and 1. One _mm_shuffle_epi8 does it, and then the
+/// whole register is stored - the lanes past the visible ones are junk, but the next
+/// store starts on top of them. So there's no branch per vertex, just a table lookup
+/// and an add.
+///
+/// The one catch is the end of the output: a 16 byte store there could write past
+/// it, into the next chunk's output (maybe while another thread is writing that). So
+/// a word whose stores might reach that far goes out one value at a time.
+/// ---------------------------------------------------------------------------------
+
+// Plain bytes rather than __m128i, so nothing runs at startup: this file is compiled
+// for SSSE3, and startup code would run whether the CPU has it or not.
+static const uint8_t Z = 0x80;  // Shuffles in a zero
+alignas(16) static const uint8_t kShuffles[16][16] =
+{
+    {  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z },  // 0000
+    {  0,  1,  2,  3,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z },  // 0001
+    {  4,  5,  6,  7,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z },  // 0010
+    {  0,  1,  2,  3,  4,  5,  6,  7,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z },  // 0011
+    {  8,  9, 10, 11,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z },  // 0100
+    {  0,  1,  2,  3,  8,  9, 10, 11,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z },  // 0101
+    {  4,  5,  6,  7,  8,  9, 10, 11,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z },  // 0110
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11,  Z,  Z,  Z,  Z },  // 0111
+    { 12, 13, 14, 15,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z },  // 1000
+    {  0,  1,  2,  3, 12, 13, 14, 15,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z },  // 1001
+    {  4,  5,  6,  7, 12, 13, 14, 15,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z },  // 1010
+    {  0,  1,  2,  3,  4,  5,  6,  7, 12, 13, 14, 15,  Z,  Z,  Z,  Z },  // 1011
+    {  8,  9, 10, 11, 12, 13, 14, 15,  Z,  Z,  Z,  Z,  Z,  Z,  Z,  Z },  // 1100
+    {  0,  1,  2,  3,  8,  9, 10, 11, 12, 13, 14, 15,  Z,  Z,  Z,  Z },  // 1101
+    {  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15,  Z,  Z,  Z,  Z },  // 1110
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },  // 1111
+};
+
+static const int kVisibleCount[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+
+size_t CompactFloatsSsse3(const float* src, size_t count, const uint64_t* words,
+                          size_t firstWord, size_t lastWord, float* dst, size_t dstCount)
+{
+    size_t written = 0;
+
+    for (size_t index = firstWord; index < lastWord; index++)
+    {
+        uint64_t word = words[index];
+        const float* block = src + index * 64;
+
+        if (word == 0)
+            continue;
+
+        // Bits past the end are never set, so a full word is 64 real values
+        if (word == ~0ull)
+        {
+            memcpy(dst + written, block, 64 * sizeof(float));
+            written += 64;
+            continue;
+        }
+
+        // Only whole words get the 16 byte loads (the last one can be short), and the
+        // last store can reach up to 4 values past this word's output
+        if (index * 64 + 64 > count || written + PopCount64(word) + 4 > dstCount)
+        {
+            written += CompactWordScalar(block, word, dst + written);
+            continue;
+        }
+
+        for (int group = 0; group < 16; group++)
+        {
+            int bits = (int)(word >> (group * 4)) & 15;
+            __m128i values = _mm_castps_si128(_mm_loadu_ps(block + group * 4));
+            __m128i mask = _mm_load_si128((const __m128i*)kShuffles[bits]);
+            _mm_storeu_ps(dst + written, _mm_castsi128_ps(_mm_shuffle_epi8(values, mask)));
+            written += kVisibleCount[bits];
+        }
+    }
+    return written;
+}
+
+#endif
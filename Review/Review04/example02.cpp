@@ -1,59 +1,10 @@
 
 #include <allegro5/allegro_font.h>
 
-struct Point2D
-{
-    float x;    // 4 bytes
-    float y;    // 4 bytes
-};              // 8 bytes total
-
-struct RGB
-{
-    float r;    // 4 bytes
-    float g;    // 4 bytes
-    float b;    // 4 bytes
-};              // 12 bytes total
-
-struct RGBA
-{
-    float r;    // 4 bytes
-    float g;    // 4 bytes
-    float b;    // 4 bytes
-    float a;    // 4 bytes
-};              // 16 bytes total
-
-struct UV
-{
-    float u;    // 4 bytes
-    float v;    // 4 bytes
-};              // 8 bytes total
-
-
-struct Vertex
-{
-    Point2D position;   // 8 bytes
-    RGB     color;      // 12  bytes
-    UV      texCoord;   // 8 bytes
-};                      // 28 bytes total
-
-struct VisibleVertex01
-{
-    bool    visible;    // 1 byte
-    Point2D position;   // 8 bytes
-    RGB     color;      // 12 bytes
-    UV      texCoord;   // 8 bytes
-};                      // 29 bytes total
-
-#pragma pack(push)
-#pragma pack(1)
-struct VisibleVertex02
-{
-    bool    visible;    // 1 byte
-    Point2D position;   // 8 bytes
-    RGB     color;      // 12 bytes
-    UV      texCoord;   // 8 bytes
-};                      // 29 bytes total
-#pragma pack(pop)
+// The structs themselves are in VertexTypes.h, along with static_asserts that pin
+// down the sizes printed here.
+#include "VertexTypes.h"
+#include "VertexLayouts.h"
 
 extern ALLEGRO_FONT* gFont;
 
@@ -83,6 +34,10 @@ void Example02()
     textPos.y += 15;
     al_draw_textf(gFont, al_map_rgb(255, 255, 255), textPos.x, textPos.y, ALLEGRO_ALIGN_LEFT, "Size of VisibleVertex02: %02d bytes", sizeof(VisibleVertex02));
     textPos.y += 15;
+    al_draw_textf(gFont, al_map_rgb(255, 255, 255), textPos.x, textPos.y, ALLEGRO_ALIGN_LEFT, "Size of CompactVertex:   %02d bytes", sizeof(CompactVertex));
+    textPos.y += 15;
+    al_draw_textf(gFont, al_map_rgb(255, 255, 255), textPos.x, textPos.y, ALLEGRO_ALIGN_LEFT, "Size of VertexBlock8:    %02d bytes", sizeof(VertexBlock8));
+    textPos.y += 15;
 
 
     al_flip_display();
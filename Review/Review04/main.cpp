@@ -14,7 +14,7 @@ enum Executables
     endoflist
 };
 
-void main()
+int main()
 {
     al_init();
     al_init_font_addon();
@@ -0,0 +1,48 @@
+#include "AllegroBackend.h"
+
+#include <allegro5/allegro.h>
+#include <allegro5/allegro_primitives.h>
+
+static ALLEGRO_COLOR ToAllegro(RenderColor color)
+{
+    return al_map_rgba(color.r, color.g, color.b, color.a);
+}
+
+void AllegroBackend::Clear(RenderColor color)
+{
+    al_clear_to_color(ToAllegro(color));
+}
+
+void AllegroBackend::DrawCircle(float centerX, float centerY, float radius, RenderColor color, float thickness)
+{
+    al_draw_circle(centerX, centerY, radius, ToAllegro(color), thickness);
+    mDrawCalls++;
+}
+
+void AllegroBackend::FillCircle(float centerX, float centerY, float radius, RenderColor color)
+{
+    al_draw_filled_circle(centerX, centerY, radius, ToAllegro(color));
+    mDrawCalls++;
+}
+
+void AllegroBackend::DrawRectangle(float left, float top, float right, float bottom, RenderColor color, float thickness)
+{
+    al_draw_rectangle(left, top, right, bottom, ToAllegro(color), thickness);
+    mDrawCalls++;
+}
+
+void AllegroBackend::FillRectangle(float left, float top, float right, float bottom, RenderColor color)
+{
+    al_draw_filled_rectangle(left, top, right, bottom, ToAllegro(color));
+    mDrawCalls++;
+}
+
+void AllegroBackend::SetClip(int left, int top, int right, int bottom)
+{
+    al_set_clipping_rectangle(left, top, right - left, bottom - top);
+}
+
+void AllegroBackend::ResetClip()
+{
+    al_reset_clipping_rectangle();
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "RenderBackend.h"
+
+/// Draws with the Allegro primitives addon, onto whatever Allegro's current target
+/// bitmap is (the display's backbuffer, normally). al_init_primitives_addon() has to
+/// have been called first.
+///
+/// Every shape is its own al_draw_* call; see ShapeBatcher for the batched version.
+class AllegroBackend : public RenderBackend
+{
+public:
+    AllegroBackend() : mDrawCalls(0) {}
+
+    virtual void Clear(RenderColor color) override;
+
+    virtual void DrawCircle(float centerX, float centerY, float radius, RenderColor color, float thickness) override;
+    virtual void FillCircle(float centerX, float centerY, float radius, RenderColor color) override;
+
+    virtual void DrawRectangle(float left, float top, float right, float bottom, RenderColor color, float thickness) override;
+    virtual void FillRectangle(float left, float top, float right, float bottom, RenderColor color) override;
+
+    virtual void SetClip(int left, int top, int right, int bottom) override;
+    virtual void ResetClip() override;
+
+    /// al_draw_* calls made since the last ResetDrawCalls(), one per shape.
+    unsigned DrawCalls() const { return mDrawCalls; }
+    void ResetDrawCalls() { mDrawCalls = 0; }
+
+private:
+    unsigned mDrawCalls;
+};
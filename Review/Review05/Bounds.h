@@ -0,0 +1,66 @@
+#pragma once
+
+#include <float.h>
+
+#include "Math2D.h"
+
+/// ---------------------------------------------------------------------------------
+/// An axis aligned bounding box: the smallest rectangle, with sides parallel to the
+/// axes, that a shape fits in. Two boxes overlapping doesn't mean the shapes do, but
+/// two boxes *not* overlapping means the shapes don't either - and that's a handful
+/// of comparisons, which is what makes culling and picking cheap.
+///
+/// Edges count as inside, so a box with min == max is a point, and still overlaps
+/// anything it touches.
+/// ---------------------------------------------------------------------------------
+struct AABB
+{
+    Vec2 min;
+    Vec2 max;
+
+    constexpr AABB() : min(FLT_MAX, FLT_MAX), max(-FLT_MAX, -FLT_MAX) {}
+    constexpr AABB(Vec2 inMin, Vec2 inMax) : min(inMin), max(inMax) {}
+
+    /// The default AABB is empty: it contains nothing, and Union() with it gives back
+    /// the other box.
+    constexpr bool IsEmpty() const { return min.x > max.x || min.y > max.y; }
+
+    constexpr Vec2 Center() const { return Vec2((min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f); }
+    constexpr Vec2 Size() const { return Vec2(max.x - min.x, max.y - min.y); }
+
+    /// Width plus height: in 2D, what the surface area is in 3D. A BVH built with the
+    /// surface area heuristic (see SpatialIndex.h) uses it to guess how often a query
+    /// will have to look inside a box.
+    constexpr float HalfPerimeter() const { return (max.x - min.x) + (max.y - min.y); }
+};
+
+constexpr bool Overlaps(const AABB& a, const AABB& b)
+{
+    return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y;
+}
+
+constexpr bool Contains(const AABB& box, Vec2 point)
+{
+    return point.x >= box.min.x && point.x <= box.max.x && point.y >= box.min.y && point.y <= box.max.y;
+}
+
+inline AABB Union(const AABB& a, const AABB& b)
+{
+    return AABB(Vec2(a.min.x < b.min.x ? a.min.x : b.min.x, a.min.y < b.min.y ? a.min.y : b.min.y),
+                Vec2(a.max.x > b.max.x ? a.max.x : b.max.x, a.max.y > b.max.y ? a.max.y : b.max.y));
+}
+
+inline AABB Union(const AABB& box, Vec2 point)
+{
+    return Union(box, AABB(point, point));
+}
+
+constexpr AABB CircleBounds(float x, float y, float radius)
+{
+    return AABB(Vec2(x - radius, y - radius), Vec2(x + radius, y + radius));
+}
+
+constexpr AABB RectangleBounds(float x, float y, float width, float height)
+{
+    return AABB(Vec2(x - width * 0.5f, y - height * 0.5f), Vec2(x + width * 0.5f, y + height * 0.5f));
+}
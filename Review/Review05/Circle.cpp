@@ -1,6 +1,6 @@
 #include "Circle.h"
 
-#include <allegro5/allegro_primitives.h>
+#include "RenderBackend.h"
 
 Circle::Circle() : mRadius(1.0f) {}
 Circle::Circle(float inX, float inY, float radius) : VirtualShape(inX, inY), mRadius(radius) {}
@@ -9,5 +9,10 @@ Circle::~Circle() {}
 
 void Circle::Draw()
 {
-    al_draw_circle(mCenter.x, mCenter.y, mRadius, al_map_rgb(255, 255, 255), 1.0f);
+    GetRenderBackend().DrawCircle(mCenter.x, mCenter.y, mRadius, kShapeColor, kShapeThickness);
+}
+
+AABB Circle::Bounds() const
+{
+    return CircleBounds(mCenter.x, mCenter.y, mRadius);
 }
@@ -11,6 +11,7 @@ public:
     virtual ~Circle();
 
     virtual void Draw() override;
+    virtual AABB Bounds() const override;
 
     float mRadius;
 };
\ No newline at end of file
@@ -0,0 +1,131 @@
+#include "DirtyRegions.h"
+
+DirtyRegions::DirtyRegions(int width, int height, int tileSize)
+    : mWidth(width > 0 ? width : 0)
+    , mHeight(height > 0 ? height : 0)
+    , mTileSize(tileSize > 0 ? tileSize : kDefaultTileSize)
+    , mColumns((mWidth + mTileSize - 1) / mTileSize)
+    , mRows((mHeight + mTileSize - 1) / mTileSize)
+    , mTiles((size_t)mColumns * (size_t)mRows, 0)
+    , mDirtyTiles(0)
+    , mDirtyPixels(0)
+{
+}
+
+void DirtyRegions::Add(const AABB& bounds)
+{
+    float left = bounds.min.x - kPadding;
+    float top = bounds.min.y - kPadding;
+    float right = bounds.max.x + kPadding;
+    float bottom = bounds.max.y + kPadding;
+
+    // Written so that NaNs (and empty boxes) fail, too
+    if (!(right >= 0.0f && bottom >= 0.0f && left < (float)mWidth && top < (float)mHeight && left <= right && top <= bottom))
+        return;
+
+    int firstColumn = left > 0.0f ? (int)(left / (float)mTileSize) : 0;
+    int firstRow = top > 0.0f ? (int)(top / (float)mTileSize) : 0;
+    int lastColumn = right < (float)mWidth ? (int)(right / (float)mTileSize) : mColumns - 1;
+    int lastRow = bottom < (float)mHeight ? (int)(bottom / (float)mTileSize) : mRows - 1;
+
+    for (int row = firstRow; row <= lastRow; row++)
+    {
+        uint8_t* tile = &mTiles[(size_t)row * mColumns + firstColumn];
+        for (int column = firstColumn; column <= lastColumn; column++, tile++)
+        {
+            mDirtyTiles += *tile ^ 1;
+            *tile = 1;
+        }
+    }
+}
+
+void DirtyRegions::AddAll()
+{
+    std::fill(mTiles.begin(), mTiles.end(), (uint8_t)1);
+    mDirtyTiles = mTiles.size();
+}
+
+void DirtyRegions::Clear()
+{
+    std::fill(mTiles.begin(), mTiles.end(), (uint8_t)0);
+    mDirtyTiles = 0;
+}
+
+const std::vector<DirtyRect>& DirtyRegions::Merge()
+{
+    mRectangles.clear();
+    mOpen.clear();
+    mDirtyPixels = 0;
+
+    if (mDirtyTiles == 0)
+        return mRectangles;
+
+    if (mDirtyTiles * 100 > mTiles.size() * kFullRedrawPercent)
+    {
+        DirtyRect screen = { 0, 0, mWidth, mHeight };
+        mRectangles.push_back(screen);
+        mDirtyPixels = (uint64_t)mWidth * (uint64_t)mHeight;
+        return mRectangles;
+    }
+
+    // Rectangles are in tiles until the end. mOpen is sorted by column, like the runs
+    // are found, so matching a run to the rectangle above it is a walk along both.
+    for (int row = 0; row < mRows; row++)
+    {
+        const uint8_t* tiles = &mTiles[(size_t)row * mColumns];
+        size_t open = 0;
+        mNextOpen.clear();
+
+        for (int column = 0; column < mColumns; )
+        {
+            if (tiles[column] == 0)
+            {
+                column++;
+                continue;
+            }
+
+            int first = column;
+            while (column < mColumns && tiles[column] != 0)
+            {
+                column++;
+            }
+
+            while (open < mOpen.size() && mRectangles[mOpen[open]].left < first)
+            {
+                open++;
+            }
+
+            if (open < mOpen.size() && mRectangles[mOpen[open]].left == first && mRectangles[mOpen[open]].right == column)
+            {
+                mRectangles[mOpen[open]].bottom = row + 1;
+                mNextOpen.push_back(mOpen[open]);
+                open++;
+            }
+            else
+            {
+                DirtyRect rect = { first, row, column, row + 1 };
+                mNextOpen.push_back(mRectangles.size());
+                mRectangles.push_back(rect);
+            }
+        }
+
+        mOpen.swap(mNextOpen);
+    }
+
+    for (DirtyRect& rect : mRectangles)
+    {
+        rect.left *= mTileSize;
+        rect.top *= mTileSize;
+        rect.right = std::min(rect.right * mTileSize, mWidth);
+        rect.bottom = std::min(rect.bottom * mTileSize, mHeight);
+        mDirtyPixels += (uint64_t)rect.Width() * (uint64_t)rect.Height();
+    }
+
+    return mRectangles;
+}
+
+double DirtyRegions::DirtyPercent() const
+{
+    uint64_t screen = (uint64_t)mWidth * (uint64_t)mHeight;
+    return screen > 0 ? 100.0 * (double)mDirtyPixels / (double)screen : 0.0;
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+
+#include "Bounds.h"
+#include "RenderBackend.h"
+#include "ShapeStore.h"
+
+/// ---------------------------------------------------------------------------------
+/// Redrawing only the parts of the screen that changed.
+///
+/// Clearing the screen and drawing every shape again each frame costs the same
+/// whether one shape moved or all of them did. When only a handful change, most of
+/// that work paints exactly the pixels that were already there.
+///
+/// DirtyRegions cuts the screen into square tiles and remembers which ones something
+/// changed in. A shape that moves dirties the tiles under where it was (to rub it
+/// out) and the tiles under where it is now. Hand a DirtyRegions to a ShapeStore with
+/// TrackChanges(), and the store's SetCenter(), SetRadius() and SetSize() do that for
+/// you.
+///
+/// At the end of the frame, Merge() joins neighbouring dirty tiles into as few
+/// rectangles as it can, and RedrawDirty() redraws just those: for each one, it clips
+/// the backend to it, clears it, and draws the shapes that overlap it, in the usual
+/// order. What ends up on screen is exactly what a full redraw would give - provided
+/// the backend still holds the last frame. A SoftwareBackend always does; with
+/// Allegro, draw into a bitmap of your own (not the backbuffer, which al_flip_display
+/// leaves undefined) and copy that to the screen.
+///
+/// Tiles rather than the exact changed rectangles, so that the bookkeeping stays the
+/// same size however many shapes change: a tile is dirty or it isn't.
+/// ---------------------------------------------------------------------------------
+
+/// A rectangle of whole pixels: columns [left, right) of rows [top, bottom).
+struct DirtyRect
+{
+    int left;
+    int top;
+    int right;
+    int bottom;
+
+    int Width() const { return right - left; }
+    int Height() const { return bottom - top; }
+};
+
+class DirtyRegions
+{
+public:
+    static const int kDefaultTileSize = 32;
+
+    /// Each rectangle costs a query of the index, and the shapes across its edges get
+    /// drawn again for each one they touch. Past this much of the screen, one
+    /// rectangle covering all of it is quicker.
+    static const int kFullRedrawPercent = 25;
+
+    /// How far around a shape's bounds its pixels can reach: half the outline, plus
+    /// the rounding in the rasterizers.
+    static constexpr float kPadding = 2.0f;
+
+    DirtyRegions(int width, int height, int tileSize = kDefaultTileSize);
+
+    int Width() const { return mWidth; }
+    int Height() const { return mHeight; }
+    int TileSize() const { return mTileSize; }
+
+    /// Something inside `bounds` (padded by kPadding) changed. Anything off the
+    /// screen is ignored.
+    void Add(const AABB& bounds);
+
+    /// The whole screen: after a Clear(), or for the first frame.
+    void AddAll();
+
+    /// Start a new frame with nothing dirty.
+    void Clear();
+
+    bool IsEmpty() const { return mDirtyTiles == 0; }
+    size_t DirtyTileCount() const { return mDirtyTiles; }
+
+    /// The dirty tiles as rectangles, clipped to the screen. Each row of tiles is cut
+    /// into runs of dirty ones, and a run exactly under one from the row above makes
+    /// that rectangle taller instead of starting a new one. If more than
+    /// kFullRedrawPercent of the tiles are dirty, it's the whole screen instead.
+    const std::vector<DirtyRect>& Merge();
+
+    /// The pixels in the last Merge()'s rectangles, and that as a percentage of the
+    /// whole screen.
+    uint64_t DirtyPixels() const { return mDirtyPixels; }
+    double DirtyPercent() const;
+
+private:
+    int mWidth;
+    int mHeight;
+    int mTileSize;
+    int mColumns;
+    int mRows;
+
+    std::vector<uint8_t>   mTiles;          ///< mColumns * mRows, 1 if dirty
+    size_t                 mDirtyTiles;
+    std::vector<DirtyRect> mRectangles;     ///< From the last Merge()
+    std::vector<size_t>    mOpen;           ///< mRectangles that reach the row above
+    std::vector<size_t>    mNextOpen;
+    uint64_t               mDirtyPixels;
+};
+
+/// Redraws the dirty parts of the screen: each of regions.Merge()'s rectangles is
+/// cleared to `background`, and the shapes that `index` says overlap it are drawn,
+/// clipped to it (if it's the whole screen, every shape is). Returns how many shapes
+/// were drawn (a shape across two rectangles counts twice). `visible` is scratch
+/// space, as for DrawVisible().
+///
+/// The index has to be up to date: a UniformGrid that's had Update() called for each
+/// shape that moved, say.
+template<typename Index>
+size_t RedrawDirty(const ShapeStore& store, const Index& index, DirtyRegions& regions, RenderColor background,
+                   std::vector<ShapeId>& visible)
+{
+    RenderBackend& backend = GetRenderBackend();
+    const Vec2 padding(DirtyRegions::kPadding, DirtyRegions::kPadding);
+
+    size_t drawn = 0;
+    for (const DirtyRect& rect : regions.Merge())
+    {
+        backend.SetClip(rect.left, rect.top, rect.right, rect.bottom);
+        backend.Clear(background);
+
+        // The whole screen: asking the index would cost more than it saves
+        if (rect.Width() == regions.Width() && rect.Height() == regions.Height())
+        {
+            store.Draw();
+            drawn += store.Count();
+            continue;
+        }
+
+        AABB region(Vec2((float)rect.left, (float)rect.top) - padding, Vec2((float)rect.right, (float)rect.bottom) + padding);
+        visible.clear();
+        index.Query(region, visible);
+        std::sort(visible.begin(), visible.end());
+        store.Draw(visible.data(), visible.size());
+        drawn += visible.size();
+    }
+    backend.ResetClip();
+
+    return drawn;
+}
@@ -0,0 +1,226 @@
+/// ---------------------------------------------------------------------------------
+/// The Review05 scene without Allegro or a display: draws it with the
+/// SoftwareBackend and writes the picture to a file. It has its own `main`, so it's
+/// not part of the Review05 project; the CMake build makes it `Review05Headless`.
+///
+///     Review05Headless                 writes Review05.png
+///     Review05Headless scene.ppm       writes a PPM instead (or a .png, by name)
+///     Review05Headless out.png in.r05  draws the shapes in a scene file instead
+///     Review05Headless --save out.r05  saves the ten shapes as a scene file
+///     Review05Headless --help          prints how to use it (any other option is an error)
+/// ---------------------------------------------------------------------------------
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include "AllocationTracker.h"
+#include "DirtyRegions.h"
+#include "RenderQueue.h"
+#include "SceneFile.h"
+#include "ShapeStore.h"
+#include "Scene.h"
+#include "SoftwareBackend.h"
+#include "SpatialIndex.h"
+
+static bool EndsWith(const char* text, const char* suffix)
+{
+    size_t textLength = strlen(text);
+    size_t suffixLength = strlen(suffix);
+    return textLength >= suffixLength && strcmp(text + textLength - suffixLength, suffix) == 0;
+}
+
+static void PrintUsage(FILE* out)
+{
+    fprintf(out, "Usage: Review05Headless [out.png | out.ppm] [in.r05]\n"
+                 "       Review05Headless --save [out.r05]\n");
+}
+
+int main(int argc, char* argv[])
+{
+    ReportLeaksAtExit();
+
+    // Anything else that looks like an option is a mistake (or a request for help),
+    // not the name of a file to write
+    bool saving = argc > 1 && strcmp(argv[1], "--save") == 0;
+    for (int arg = saving ? 2 : 1; arg < argc; arg++)
+    {
+        if (strcmp(argv[arg], "--help") == 0 || strcmp(argv[arg], "-h") == 0)
+        {
+            PrintUsage(stdout);
+            return 0;
+        }
+        if (argv[arg][0] == '-')
+        {
+            fprintf(stderr, "Unknown option %s\n", argv[arg]);
+            PrintUsage(stderr);
+            return 1;
+        }
+    }
+    if (argc > 3)
+    {
+        fprintf(stderr, "Too many arguments\n");
+        PrintUsage(stderr);
+        return 1;
+    }
+
+    const char* path = argc > 1 ? argv[1] : "Review05.png";
+
+    ShapeStore shapes;
+    BuildScene(shapes);
+
+    if (strcmp(path, "--save") == 0)
+    {
+        const char* scenePath = argc > 2 ? argv[2] : "Review05.r05";
+        if (!WriteScene(scenePath, shapes))
+        {
+            fprintf(stderr, "Couldn't write %s\n", scenePath);
+            return 1;
+        }
+
+        printf("Saved %u shapes to %s\n", (unsigned)shapes.Count(), scenePath);
+        return 0;
+    }
+
+    SoftwareBackend backend(800, 600);
+    SetRenderBackend(&backend);
+
+    // A scene file is drawn straight out of the mapping, without copying it into a
+    // ShapeStore first - so there's no index to cull or pick with, either.
+    if (argc > 2)
+    {
+        MappedScene scene;
+        SceneFileStatus status = scene.Open(argv[2]);
+        if (status != SceneFileStatus::Ok)
+        {
+            fprintf(stderr, "Couldn't open %s: %s\n", argv[2], SceneFileStatusName(status));
+            return 1;
+        }
+
+        backend.Clear(MakeRenderColor(0, 0, 0));
+        scene.Draw();
+        SetRenderBackend(nullptr);
+
+        printf("Drew %u shapes from %s\n", (unsigned)scene.Count(), argv[2]);
+    }
+    else
+    {
+        // Ten shapes all on screen don't need culling, but this is how a bigger scene
+        // would draw: only what the index says overlaps the screen.
+        BoundingVolumeHierarchy index;
+        index.Build(shapes);
+
+        std::vector<ShapeId> visible;
+        backend.Clear(MakeRenderColor(0, 0, 0));
+        size_t drawn = DrawVisible(shapes, index, AABB(Vec2(0.0f, 0.0f), Vec2(800.0f, 600.0f)), visible);
+
+        SetRenderBackend(nullptr);
+
+        ShapeId picked;
+        std::vector<ShapeId> scratch;
+        Vec2 point(100.0f, 150.0f);
+        if (PickShape(shapes, index, point, picked, scratch))
+        {
+            printf("Drew %u of %u shapes; the one at (%g, %g) is %s %u\n", (unsigned)drawn, (unsigned)shapes.Count(),
+                   point.x, point.y, IsRectangleId(picked) ? "rectangle" : "circle", (unsigned)ShapeIndex(picked));
+        }
+        else
+        {
+            printf("Drew %u of %u shapes; there's nothing at (%g, %g)\n", (unsigned)drawn, (unsigned)shapes.Count(),
+                   point.x, point.y);
+        }
+
+        // Two more frames, redrawing only what changed: circle 4 moves right, then
+        // back again (so the picture that's written is the same). A UniformGrid rather
+        // than the BVH, since it can follow shapes that move.
+        UniformGrid grid(AABB(Vec2(0.0f, 0.0f), Vec2(800.0f, 600.0f)), 64.0f);
+        for (size_t circle = 0; circle < shapes.Circles().Count(); circle++)
+        {
+            grid.Insert(CircleId(circle), shapes.Bounds(CircleId(circle)));
+        }
+        for (size_t rectangle = 0; rectangle < shapes.Rectangles().Count(); rectangle++)
+        {
+            grid.Insert(RectangleId(rectangle), shapes.Bounds(RectangleId(rectangle)));
+        }
+
+        DirtyRegions dirty(backend.Width(), backend.Height());
+        shapes.TrackChanges(&dirty);
+        SetRenderBackend(&backend);
+
+        const ShapeId moving = CircleId(4);
+        const Vec2 center(shapes.Circles().x[4], shapes.Circles().y[4]);
+        double percent[2];
+        for (int frame = 0; frame < 2; frame++)
+        {
+            shapes.SetCenter(moving, frame == 0 ? center + Vec2(40.0f, 0.0f) : center);
+            grid.Update(moving, shapes.Bounds(moving));
+
+            RedrawDirty(shapes, grid, dirty, MakeRenderColor(0, 0, 0), visible);
+            percent[frame] = dirty.DirtyPercent();
+            dirty.Clear();
+        }
+
+        SetRenderBackend(nullptr);
+        shapes.TrackChanges(nullptr);
+        printf("Moved circle 4 and back, redrawing %.1f%% and %.1f%% of the pixels\n", percent[0], percent[1]);
+
+        // The same picture again, a few times over, from two 'simulation' threads -
+        // one drawing the circles, the other the rectangles - through a RenderQueue to
+        // a render thread. It draws the circles' part of each frame first, so the
+        // last frame should match the one above exactly.
+        const int kQueuedFrames = 3;
+        RenderQueue queue(2);
+        RenderThread renderThread(queue, backend.Width(), backend.Height());
+
+        std::thread circleThread([&]()
+        {
+            QueuedBackend output(queue, 0);
+            SetRenderBackend(&output);
+            for (int frame = 0; frame < kQueuedFrames; frame++)
+            {
+                output.Clear(MakeRenderColor(0, 0, 0));
+                shapes.DrawCircles();
+                output.EndFrame();
+            }
+            SetRenderBackend(nullptr);
+        });
+        std::thread rectangleThread([&]()
+        {
+            QueuedBackend output(queue, 1);
+            SetRenderBackend(&output);
+            for (int frame = 0; frame < kQueuedFrames; frame++)
+            {
+                shapes.DrawRectangles();
+                output.EndFrame();
+            }
+            SetRenderBackend(nullptr);
+        });
+        circleThread.join();
+        rectangleThread.join();
+
+        while (renderThread.FramesDrawn() < (uint64_t)kQueuedFrames)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        const SoftwareBackend* queued = renderThread.AcquireFrame();
+        bool same = queued != nullptr &&
+                    memcmp(queued->Pixels(), backend.Pixels(), (size_t)backend.Width() * backend.Height() * 4) == 0;
+
+        QueueStats stats = queue.Stats();
+        printf("Queued %d frames from 2 threads: %u commands, at most %u waiting, %llu stalls; the last one %s\n",
+               kQueuedFrames, (unsigned)stats.pushed, (unsigned)stats.maxDepth, (unsigned long long)stats.fullStalls,
+               same ? "matches" : "DOESN'T match");
+    }
+
+    bool written = EndsWith(path, ".ppm") ? backend.WritePPM(path) : backend.WritePNG(path);
+    if (!written)
+    {
+        fprintf(stderr, "Couldn't write %s\n", path);
+        return 1;
+    }
+
+    printf("Wrote %s (%dx%d)\n", path, backend.Width(), backend.Height());
+    return 0;
+}
@@ -1,5 +1,5 @@
 #include "Rectangle.h"
-#include <allegro5/allegro_primitives.h>
+#include "RenderBackend.h"
 
 
 Rectangle::Rectangle() : VirtualShape() {}
@@ -10,9 +10,14 @@ Rectangle::~Rectangle() {}
 
 void Rectangle::Draw()
 {
-    al_draw_rectangle(
+    GetRenderBackend().DrawRectangle(
         mCenter.x - (mWidth / 2.0f), mCenter.y - (mHeight / 2.0f),
         mCenter.x + (mWidth / 2.0f), mCenter.y + (mHeight / 2.0f),
-        al_map_rgb(255, 255, 255),
-        1.0f);
+        kShapeColor,
+        kShapeThickness);
+}
+
+AABB Rectangle::Bounds() const
+{
+    return RectangleBounds(mCenter.x, mCenter.y, mWidth, mHeight);
 }
@@ -10,6 +10,7 @@ public:
     virtual ~Rectangle();
 
     virtual void Draw() override;
+    virtual AABB Bounds() const override;
 
     float mWidth;
     float mHeight;
@@ -0,0 +1,29 @@
+#include "RenderBackend.h"
+
+namespace
+{
+    class NullRenderBackend : public RenderBackend
+    {
+    public:
+        virtual void Clear(RenderColor) override {}
+        virtual void DrawCircle(float, float, float, RenderColor, float) override {}
+        virtual void FillCircle(float, float, float, RenderColor) override {}
+        virtual void DrawRectangle(float, float, float, float, RenderColor, float) override {}
+        virtual void FillRectangle(float, float, float, float, RenderColor) override {}
+        virtual void SetClip(int, int, int, int) override {}
+        virtual void ResetClip() override {}
+    };
+
+    NullRenderBackend gNullBackend;
+    thread_local RenderBackend* gBackend = &gNullBackend;
+}
+
+void SetRenderBackend(RenderBackend* backend)
+{
+    gBackend = backend != nullptr ? backend : &gNullBackend;
+}
+
+RenderBackend& GetRenderBackend()
+{
+    return *gBackend;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdint.h>
+
+/// ---------------------------------------------------------------------------------
+/// Everything the shapes need in order to draw themselves, without saying *what*
+/// they're drawing onto. Circle::Draw and Rectangle::Draw call the current backend,
+/// so the same scene can go to an Allegro display (AllegroBackend) or into a plain
+/// block of memory (SoftwareBackend) on a machine with no display at all.
+///
+/// Coordinates are in pixels, and match Allegro's: (0, 0) is the top left corner of
+/// the top left pixel, so that pixel's center is at (0.5, 0.5). Outlines are centered
+/// on the edge of the shape; a thickness of 0 or less means 'one pixel wide'.
+/// ---------------------------------------------------------------------------------
+
+struct RenderColor
+{
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+    uint8_t a;
+};
+
+inline RenderColor MakeRenderColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255)
+{
+    RenderColor color = { r, g, b, a };
+    return color;
+}
+
+class RenderBackend
+{
+public:
+    virtual ~RenderBackend() {}
+
+    virtual void Clear(RenderColor color) = 0;
+
+    virtual void DrawCircle(float centerX, float centerY, float radius, RenderColor color, float thickness) = 0;
+    virtual void FillCircle(float centerX, float centerY, float radius, RenderColor color) = 0;
+
+    virtual void DrawRectangle(float left, float top, float right, float bottom, RenderColor color, float thickness) = 0;
+    virtual void FillRectangle(float left, float top, float right, float bottom, RenderColor color) = 0;
+
+    /// Until the next SetClip() or ResetClip(), only the pixels in columns [left, right)
+    /// of rows [top, bottom) are drawn to - Clear() included, as in Allegro. It's how a
+    /// part of the screen gets redrawn without touching the rest (see DirtyRegions.h).
+    virtual void SetClip(int left, int top, int right, int bottom) = 0;
+    virtual void ResetClip() = 0;
+};
+
+/// The backend the shapes draw with. Until somebody calls SetRenderBackend, it's one
+/// that throws everything away. Passing nullptr puts that one back.
+///
+/// Each thread has its own: a simulation thread can draw a ShapeStore into a
+/// QueuedBackend (see RenderQueue.h) while the render thread draws with another.
+void SetRenderBackend(RenderBackend* backend);
+RenderBackend& GetRenderBackend();
@@ -0,0 +1,237 @@
+#include "RenderQueue.h"
+
+RenderQueue::RenderQueue(int producers, size_t capacity)
+    : mDraining(0)
+{
+    for (int producer = 0; producer < producers; producer++)
+    {
+        mRings.emplace_back(new SpscQueue<RenderCommand>(capacity));
+    }
+}
+
+void RenderQueue::Push(int producer, const RenderCommand& command)
+{
+    SpscQueue<RenderCommand>& ring = *mRings[producer];
+    if (!ring.TryPush(command))
+    {
+        while (true)
+        {
+            uint64_t seen = mRoom.Prepare();
+            if (ring.TryPush(command))
+                break;
+
+            // The render thread may be asleep waiting for the end of the frame, which
+            // won't come until this is pushed
+            mWork.Notify();
+            mRoom.Wait(seen);
+        }
+    }
+
+    if (command.type == RenderCommand::kEndFrame)
+        mWork.Notify();
+}
+
+bool RenderQueue::DrainFrame(RenderBackend& backend)
+{
+    RenderCommand command;
+    bool popped = false;
+    while (mDraining < ProducerCount())
+    {
+        SpscQueue<RenderCommand>& ring = *mRings[mDraining];
+        while (true)
+        {
+            if (!ring.TryPop(command))
+            {
+                if (popped)
+                    mRoom.Notify();
+                return false;
+            }
+
+            popped = true;
+            if (command.type == RenderCommand::kEndFrame)
+                break;
+            Run(command, backend);
+        }
+        mDraining++;
+    }
+
+    mDraining = 0;
+    mRoom.Notify();
+    return true;
+}
+
+void RenderQueue::Run(const RenderCommand& command, RenderBackend& backend)
+{
+    const float* values = command.values;
+    switch (command.type)
+    {
+    case RenderCommand::kClear:
+        backend.Clear(command.color);
+        break;
+    case RenderCommand::kDrawCircle:
+        backend.DrawCircle(values[0], values[1], values[2], command.color, command.thickness);
+        break;
+    case RenderCommand::kFillCircle:
+        backend.FillCircle(values[0], values[1], values[2], command.color);
+        break;
+    case RenderCommand::kDrawRectangle:
+        backend.DrawRectangle(values[0], values[1], values[2], values[3], command.color, command.thickness);
+        break;
+    case RenderCommand::kFillRectangle:
+        backend.FillRectangle(values[0], values[1], values[2], values[3], command.color);
+        break;
+    case RenderCommand::kFillSpan:
+        // Row y's pixel centers are at y + 0.5, so this covers exactly that row
+        backend.FillRectangle(values[1], values[0], values[2], values[0] + 1.0f, command.color);
+        break;
+    case RenderCommand::kSetClip:
+        backend.SetClip((int)values[0], (int)values[1], (int)values[2], (int)values[3]);
+        break;
+    case RenderCommand::kResetClip:
+        backend.ResetClip();
+        break;
+    case RenderCommand::kEndFrame:
+        break;
+    }
+}
+
+QueueStats RenderQueue::Stats() const
+{
+    QueueStats total = { 0, 0, 0, 0 };
+    for (const std::unique_ptr<SpscQueue<RenderCommand>>& ring : mRings)
+    {
+        QueueStats stats = ring->Stats();
+        total.pushed += stats.pushed;
+        total.fullStalls += stats.fullStalls;
+        total.emptyPolls += stats.emptyPolls;
+        if (stats.maxDepth > total.maxDepth)
+            total.maxDepth = stats.maxDepth;
+    }
+    return total;
+}
+
+QueuedBackend::QueuedBackend(RenderQueue& queue, int producer)
+    : mQueue(queue)
+    , mProducer(producer)
+{}
+
+void QueuedBackend::Push(RenderCommand::Type type, RenderColor color, float thickness, float a, float b, float c, float d)
+{
+    RenderCommand command;
+    command.type = type;
+    command.color = color;
+    command.thickness = thickness;
+    command.values[0] = a;
+    command.values[1] = b;
+    command.values[2] = c;
+    command.values[3] = d;
+    mQueue.Push(mProducer, command);
+}
+
+void QueuedBackend::Clear(RenderColor color)
+{
+    Push(RenderCommand::kClear, color, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+}
+
+void QueuedBackend::DrawCircle(float centerX, float centerY, float radius, RenderColor color, float thickness)
+{
+    Push(RenderCommand::kDrawCircle, color, thickness, centerX, centerY, radius, 0.0f);
+}
+
+void QueuedBackend::FillCircle(float centerX, float centerY, float radius, RenderColor color)
+{
+    Push(RenderCommand::kFillCircle, color, 0.0f, centerX, centerY, radius, 0.0f);
+}
+
+void QueuedBackend::DrawRectangle(float left, float top, float right, float bottom, RenderColor color, float thickness)
+{
+    Push(RenderCommand::kDrawRectangle, color, thickness, left, top, right, bottom);
+}
+
+void QueuedBackend::FillRectangle(float left, float top, float right, float bottom, RenderColor color)
+{
+    Push(RenderCommand::kFillRectangle, color, 0.0f, left, top, right, bottom);
+}
+
+// Clip rectangles and spans are whole pixels; floats hold those exactly up to 16
+// million, far past any screen.
+void QueuedBackend::SetClip(int left, int top, int right, int bottom)
+{
+    Push(RenderCommand::kSetClip, RenderColor(), 0.0f, (float)left, (float)top, (float)right, (float)bottom);
+}
+
+void QueuedBackend::ResetClip()
+{
+    Push(RenderCommand::kResetClip, RenderColor(), 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+}
+
+void QueuedBackend::FillSpan(int y, int left, int right, RenderColor color)
+{
+    Push(RenderCommand::kFillSpan, color, 0.0f, (float)y, (float)left, (float)right, 0.0f);
+}
+
+void QueuedBackend::EndFrame()
+{
+    Push(RenderCommand::kEndFrame, RenderColor(), 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+}
+
+RenderThread::RenderThread(RenderQueue& queue, int width, int height)
+    : mQueue(queue)
+    , mBack(0)
+    , mFront(1)
+    , mMiddle(2)
+    , mStopping(false)
+    , mFramesDrawn(0)
+    , mFramesDropped(0)
+{
+    for (int frame = 0; frame < 3; frame++)
+    {
+        mFrames.emplace_back(new SoftwareBackend(width, height));
+    }
+
+    mThread = std::thread(&RenderThread::Run, this);
+}
+
+RenderThread::~RenderThread()
+{
+    mStopping.store(true);
+    mQueue.WakeRenderThread();
+    mThread.join();
+}
+
+void RenderThread::Run()
+{
+    while (true)
+    {
+        // Checking mStopping after PrepareWait() means the destructor's wake up
+        // can't slip in between the check and the wait
+        uint64_t seen = mQueue.PrepareWait();
+        if (mStopping.load())
+            break;
+
+        if (!mQueue.DrainFrame(*mFrames[mBack]))
+        {
+            // Nothing to do until a producer finishes its part of the frame
+            mQueue.WaitForWork(seen);
+            continue;
+        }
+
+        // Release, so that whoever acquires this frame sees all of its pixels
+        int previous = mMiddle.exchange(mBack | kFresh, std::memory_order_acq_rel);
+        if (previous & kFresh)
+            mFramesDropped.fetch_add(1, std::memory_order_relaxed);
+        mBack = previous & kFrameMask;
+        mFramesDrawn.fetch_add(1, std::memory_order_release);
+    }
+}
+
+const SoftwareBackend* RenderThread::AcquireFrame()
+{
+    // Only the render thread sets kFresh, and only this clears it
+    if ((mMiddle.load(std::memory_order_relaxed) & kFresh) == 0)
+        return nullptr;
+
+    int previous = mMiddle.exchange(mFront, std::memory_order_acq_rel);
+    mFront = previous & kFrameMask;
+    return mFrames[mFront].get();
+}
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "CacheLine.h"
+#include "LockFreeQueue.h"
+#include "RenderBackend.h"
+#include "SoftwareBackend.h"
+
+/// ---------------------------------------------------------------------------------
+/// Drawing on one thread what other threads decided to draw.
+///
+/// Most graphics APIs (Allegro included) want to be called from a single thread, so
+/// a simulation spread over several threads can't just draw as it goes. Instead,
+/// each simulation thread draws into a QueuedBackend, which doesn't draw anything: it
+/// turns each call into a RenderCommand and pushes it into a RenderQueue. A
+/// RenderThread pops the commands and runs them on a real backend.
+///
+/// Every simulation thread ('producer') has a ring of its own - a SpscQueue, from
+/// LockFreeQueue.h - so no producer ever waits for another, and the render thread
+/// never waits for any of them. When a producer has drawn its part of a frame, it
+/// calls EndFrame(). The frame is done once every producer has; the render thread
+/// draws each producer's part in turn, producer 0 first, so the order things are
+/// drawn in (and so the picture) is the same every time, however the threads happen
+/// to be scheduled.
+///
+///     RenderQueue queue(2);
+///     RenderThread renderThread(queue, 800, 600);
+///
+///     // On simulation thread 0 (and likewise on 1, with rectangles)
+///     QueuedBackend output(queue, 0);
+///     SetRenderBackend(&output);
+///     output.Clear(MakeRenderColor(0, 0, 0));
+///     shapes.DrawCircles();
+///     output.EndFrame();
+///
+///     // On the display thread
+///     if (const SoftwareBackend* frame = renderThread.AcquireFrame())
+///         Show(frame->Pixels());
+///
+/// A producer that finds its ring full has got more than a ring's worth ahead of the
+/// render thread, and has to wait for it; that's the only waiting there is. Stats()
+/// counts how often it happened, and the most commands that have been waiting at
+/// once, which is what to look at when choosing the capacity.
+///
+/// Whoever waits sleeps, rather than spinning: the render thread until a producer
+/// finishes its part of a frame (or fills its ring), a producer until the render
+/// thread has made some room. Waking them is a Wakeup from LockFreeQueue.h, so
+/// pushing costs no more than an atomic increment while nobody's asleep.
+/// ---------------------------------------------------------------------------------
+
+/// One RenderBackend call. 28 bytes, so two fit in a cache line.
+struct RenderCommand
+{
+    enum Type : uint8_t
+    {
+        kClear,
+        kDrawCircle,        ///< values: center x, center y, radius
+        kFillCircle,
+        kDrawRectangle,     ///< values: left, top, right, bottom
+        kFillRectangle,
+        kFillSpan,          ///< values: row, left, right (a row of whole pixels)
+        kSetClip,           ///< values: left, top, right, bottom
+        kResetClip,
+        kEndFrame,          ///< The producer's part of the frame is finished
+    };
+
+    Type        type;
+    RenderColor color;
+    float       thickness;
+    float       values[4];
+};
+
+static_assert(sizeof(RenderCommand) == 28, "RenderCommand should be 28 bytes, so two fit in a cache line");
+static_assert(2 * sizeof(RenderCommand) <= kCacheLineSize, "Two RenderCommands should fit in a cache line");
+
+class RenderQueue
+{
+public:
+    /// Enough for a few thousand shapes per producer per frame before anyone waits.
+    static const size_t kDefaultCapacity = 4096;
+
+    /// `producers` threads will each push commands, with their own number, 0 to
+    /// producers - 1. Each one's ring holds `capacity` commands (rounded up to a
+    /// power of two).
+    explicit RenderQueue(int producers, size_t capacity = kDefaultCapacity);
+
+    int ProducerCount() const { return (int)mRings.size(); }
+
+    /// From producer `producer`'s thread only. If its ring is full, wakes the render
+    /// thread and sleeps until it has made room.
+    void Push(int producer, const RenderCommand& command);
+
+    /// From the render thread only. Runs the queued commands on `backend` until the
+    /// current frame is finished (returns true), or until it gets to a producer that
+    /// hasn't pushed the rest of its part yet (returns false). Call it again later and
+    /// it carries on from where it stopped.
+    bool DrainFrame(RenderBackend& backend);
+
+    /// For the render thread, when DrainFrame() returns false: take PrepareWait()'s
+    /// value before calling DrainFrame(), and WaitForWork() sleeps until a producer
+    /// has finished its part of a frame, or filled its ring, since then.
+    uint64_t PrepareWait() const { return mWork.Prepare(); }
+    void WaitForWork(uint64_t seen) { mWork.Wait(seen); }
+
+    /// Wakes the render thread if it's in WaitForWork() (to tell it to stop, say).
+    void WakeRenderThread() { mWork.Notify(); }
+
+    /// Every ring's stats added up (maxDepth is the deepest of them).
+    QueueStats Stats() const;
+    QueueStats ProducerStats(int producer) const { return mRings[producer]->Stats(); }
+
+private:
+    static void Run(const RenderCommand& command, RenderBackend& backend);
+
+    std::vector<std::unique_ptr<SpscQueue<RenderCommand>>> mRings;
+    int mDraining;      ///< The producer whose part of the frame DrainFrame is working through
+
+    Wakeup mWork;       ///< The render thread sleeps on this
+    Wakeup mRoom;       ///< Producers with a full ring sleep on this
+};
+
+/// The producer's end of a RenderQueue: a RenderBackend that queues everything it's
+/// asked to draw. Use one per simulation thread.
+class QueuedBackend : public RenderBackend
+{
+public:
+    QueuedBackend(RenderQueue& queue, int producer);
+
+    virtual void Clear(RenderColor color) override;
+
+    virtual void DrawCircle(float centerX, float centerY, float radius, RenderColor color, float thickness) override;
+    virtual void FillCircle(float centerX, float centerY, float radius, RenderColor color) override;
+
+    virtual void DrawRectangle(float left, float top, float right, float bottom, RenderColor color, float thickness) override;
+    virtual void FillRectangle(float left, float top, float right, float bottom, RenderColor color) override;
+
+    virtual void SetClip(int left, int top, int right, int bottom) override;
+    virtual void ResetClip() override;
+
+    /// Pixels [left, right) of row y: for pictures that aren't made of shapes. It's
+    /// drawn as a one pixel high FillRectangle.
+    void FillSpan(int y, int left, int right, RenderColor color);
+
+    /// This thread's part of the frame is finished.
+    void EndFrame();
+
+private:
+    void Push(RenderCommand::Type type, RenderColor color, float thickness, float a, float b, float c, float d);
+
+    RenderQueue& mQueue;
+    int mProducer;
+};
+
+/// The render thread: drains a RenderQueue into SoftwareBackends, one frame at a time,
+/// and hands each finished frame over to whoever wants to show it.
+///
+/// The hand-over uses three frames rather than two. With two, the render thread
+/// would have to wait for the display thread to let go of the front frame before it
+/// could start the next - or the display thread wait for a frame to finish. With
+/// three there's always a spare: the render thread draws into the 'back' one, and
+/// when that's finished, swaps it with the 'middle' one in a single atomic exchange.
+/// AcquireFrame() swaps the middle one with the 'front' one the same way. Neither
+/// side ever waits; if the render thread finishes two frames before anyone acquires
+/// one, the older is simply dropped (and counted).
+///
+/// A frame isn't cleared before it's drawn into - it still holds the picture from
+/// three frames ago - so the producers should start each frame with a Clear().
+class RenderThread
+{
+public:
+    /// Starts the thread.
+    RenderThread(RenderQueue& queue, int width, int height);
+
+    /// Stops the thread, leaving anything still queued. Stop the producers first:
+    /// one waiting for room in a full ring would wait forever.
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    /// The newest finished frame, or nullptr if there hasn't been a new one since the
+    /// last call. It's yours until the next call. Call it from one thread only.
+    const SoftwareBackend* AcquireFrame();
+
+    uint64_t FramesDrawn() const { return mFramesDrawn.load(std::memory_order_acquire); }
+
+    /// Finished frames that were replaced by newer ones before AcquireFrame() got them
+    uint64_t FramesDropped() const { return mFramesDropped.load(std::memory_order_relaxed); }
+
+private:
+    static const int kFresh = 4;        ///< Set in mMiddle when it holds a frame nobody has acquired
+    static const int kFrameMask = 3;
+
+    void Run();
+
+    RenderQueue& mQueue;
+    std::vector<std::unique_ptr<SoftwareBackend>> mFrames;
+    int mBack;                          ///< The render thread's
+    int mFront;                         ///< AcquireFrame()'s
+    std::atomic<int> mMiddle;           ///< The one that's changing hands, plus kFresh
+
+    std::atomic<bool>     mStopping;
+    std::atomic<uint64_t> mFramesDrawn;
+    std::atomic<uint64_t> mFramesDropped;
+    std::thread           mThread;
+};
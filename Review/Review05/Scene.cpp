@@ -0,0 +1,18 @@
+#include "Scene.h"
+#include "ShapeStore.h"
+
+void BuildScene(ShapeStore& shapes)
+{
+    shapes.Reserve(5, 5);
+
+    shapes.AddCircle(20.0f, 30.0f, 5.0f);
+    shapes.AddCircle(40.0f, 60.0f, 10.0f);
+    shapes.AddCircle(60.0f, 90.0f, 15.0f);
+    shapes.AddCircle(80.0f, 120.0f, 20.0f);
+    shapes.AddCircle(100.0f, 150.0f, 30.0f);
+    shapes.AddRectangle(200.0f, 300.0f, 5.0f, 5.0f);
+    shapes.AddRectangle(220.0f, 330.0f, 10.0f, 10.0f);
+    shapes.AddRectangle(240.0f, 360.0f, 15.0f, 15.0f);
+    shapes.AddRectangle(260.0f, 390.0f, 20.0f, 20.0f);
+    shapes.AddRectangle(280.0f, 420.0f, 25.0f, 25.0f);
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+class ShapeStore;
+
+/// The ten shapes main.cpp draws, so that the Allegro and headless versions draw
+/// exactly the same thing.
+void BuildScene(ShapeStore& shapes);
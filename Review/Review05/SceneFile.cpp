@@ -0,0 +1,416 @@
+#include "SceneFile.h"
+
+#include "Crc32.h"
+#include "ShapeStore.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char kSceneMagic[8] = { 'R', '0', '5', 'S', 'C', 'E', 'N', 'E' };
+static const uint64_t kSceneAlignment = 64;
+
+static bool IsLittleEndianHost()
+{
+    const uint32_t one = 1;
+    uint8_t firstByte;
+    memcpy(&firstByte, &one, 1);
+    return firstByte == 1;
+}
+
+static uint64_t AlignUp(uint64_t offset)
+{
+    return (offset + kSceneAlignment - 1) & ~(kSceneAlignment - 1);
+}
+
+static uint32_t HeaderCrc(const SceneFileHeader& header)
+{
+    return Crc32(0, &header, offsetof(SceneFileHeader, headerCrc));
+}
+
+// The files can be bigger than 2GB, which plain fseek() can't get past on Windows
+static bool SeekTo(FILE* file, uint64_t offset)
+{
+#if defined(_WIN32)
+    return _fseeki64(file, (long long)offset, SEEK_SET) == 0;
+#else
+    return fseeko(file, (off_t)offset, SEEK_SET) == 0;
+#endif
+}
+
+const char* SceneFileStatusName(SceneFileStatus status)
+{
+    switch (status)
+    {
+    case SceneFileStatus::Ok:                   return "ok";
+    case SceneFileStatus::CantOpen:             return "can't open the file";
+    case SceneFileStatus::NotASceneFile:        return "not a scene file";
+    case SceneFileStatus::UnsupportedVersion:   return "unsupported version";
+    case SceneFileStatus::UnsupportedHost:      return "scene files need a little-endian machine";
+    case SceneFileStatus::Truncated:            return "truncated";
+    case SceneFileStatus::BadLayout:            return "bad layout";
+    case SceneFileStatus::ChecksumMismatch:     return "checksum mismatch";
+    }
+    return "unknown";
+}
+
+/// ---------------------------------------------------------------------------------
+/// SceneWriter
+/// ---------------------------------------------------------------------------------
+SceneWriter::SceneWriter()
+    : mFile(nullptr)
+    , mFailed(false)
+{
+    memset(&mHeader, 0, sizeof(mHeader));
+    memset(mWritten, 0, sizeof(mWritten));
+    memset(mBuffered, 0, sizeof(mBuffered));
+}
+
+SceneWriter::~SceneWriter()
+{
+    if (mFile != nullptr)
+        Close();
+}
+
+bool SceneWriter::Open(const char* path, size_t circleCount, size_t rectangleCount)
+{
+    if (mFile != nullptr || !IsLittleEndianHost())
+        return false;
+
+    mFile = fopen(path, "wb");
+    if (mFile == nullptr)
+        return false;
+
+    mFailed = false;
+    memset(&mHeader, 0, sizeof(mHeader));
+    memset(mWritten, 0, sizeof(mWritten));
+    memset(mBuffered, 0, sizeof(mBuffered));
+    mBuffers.resize(kBufferFloats * kSceneArrayCount);
+
+    memcpy(mHeader.magic, kSceneMagic, sizeof(kSceneMagic));
+    mHeader.version = kSceneFileVersion;
+    mHeader.headerSize = sizeof(SceneFileHeader);
+    mHeader.circleCount = circleCount;
+    mHeader.rectangleCount = rectangleCount;
+
+    uint64_t offset = AlignUp(sizeof(SceneFileHeader));
+    for (int array = 0; array < kSceneArrayCount; array++)
+    {
+        uint64_t count = array < kSceneRectangleX ? circleCount : rectangleCount;
+        mHeader.arrayOffset[array] = offset;
+        offset = AlignUp(offset + count * sizeof(float));
+    }
+    mHeader.fileSize = offset;
+
+    // A header of zeroes for now: until Close() fills it in, the file won't open
+    SceneFileHeader blank;
+    memset(&blank, 0, sizeof(blank));
+    if (fwrite(&blank, sizeof(blank), 1, mFile) != 1)
+        mFailed = true;
+
+    return true;
+}
+
+void SceneWriter::AddCircle(float inX, float inY, float radius)
+{
+    Put(kSceneCircleX, inX);
+    Put(kSceneCircleY, inY);
+    Put(kSceneCircleRadius, radius);
+}
+
+void SceneWriter::AddRectangle(float inX, float inY, float width, float height)
+{
+    Put(kSceneRectangleX, inX);
+    Put(kSceneRectangleY, inY);
+    Put(kSceneRectangleWidth, width);
+    Put(kSceneRectangleHeight, height);
+}
+
+void SceneWriter::Put(SceneArray array, float value)
+{
+    uint64_t count = array < kSceneRectangleX ? mHeader.circleCount : mHeader.rectangleCount;
+    if (mFile == nullptr || mWritten[array] + mBuffered[array] >= count)
+    {
+        mFailed = true;
+        return;
+    }
+
+    mBuffers[array * kBufferFloats + mBuffered[array]] = value;
+    if (++mBuffered[array] == kBufferFloats)
+        Flush(array);
+}
+
+void SceneWriter::Flush(SceneArray array)
+{
+    if (mBuffered[array] == 0)
+        return;
+
+    const float* values = &mBuffers[array * kBufferFloats];
+    const size_t bytes = mBuffered[array] * sizeof(float);
+
+    if (!SeekTo(mFile, mHeader.arrayOffset[array] + mWritten[array] * sizeof(float)) ||
+        fwrite(values, 1, bytes, mFile) != bytes)
+    {
+        mFailed = true;
+    }
+
+    mHeader.arrayCrc[array] = Crc32(mHeader.arrayCrc[array], values, bytes);
+    mWritten[array] += mBuffered[array];
+    mBuffered[array] = 0;
+}
+
+bool SceneWriter::Close()
+{
+    if (mFile == nullptr)
+        return false;
+
+    uint64_t end = sizeof(SceneFileHeader);
+    for (int array = 0; array < kSceneArrayCount; array++)
+    {
+        Flush((SceneArray)array);
+
+        uint64_t count = array < kSceneRectangleX ? mHeader.circleCount : mHeader.rectangleCount;
+        if (mWritten[array] != count)
+            mFailed = true;
+
+        // An empty array's offset is past the end of what's been written so far
+        uint64_t arrayEnd = mHeader.arrayOffset[array] + mWritten[array] * sizeof(float);
+        if (mWritten[array] > 0 && arrayEnd > end)
+            end = arrayEnd;
+    }
+
+    // Pad the last array out to fileSize. The gaps between arrays are already zero:
+    // seeking past the end of a file and writing fills the hole in with zeroes.
+    static const uint8_t zeroes[kSceneAlignment] = {};
+    if (!mFailed && end < mHeader.fileSize)
+    {
+        size_t padding = (size_t)(mHeader.fileSize - end);
+        if (!SeekTo(mFile, end) || fwrite(zeroes, 1, padding, mFile) != padding)
+            mFailed = true;
+    }
+
+    if (!mFailed)
+    {
+        mHeader.headerCrc = HeaderCrc(mHeader);
+        if (!SeekTo(mFile, 0) || fwrite(&mHeader, sizeof(mHeader), 1, mFile) != 1)
+            mFailed = true;
+    }
+
+    if (fclose(mFile) != 0)
+        mFailed = true;
+    mFile = nullptr;
+
+    mBuffers.clear();
+    mBuffers.shrink_to_fit();
+    return !mFailed;
+}
+
+bool WriteScene(const char* path, const ShapeStore& shapes)
+{
+    const ShapeStore::CirclePool& circles = shapes.Circles();
+    const ShapeStore::RectanglePool& rectangles = shapes.Rectangles();
+
+    SceneWriter writer;
+    if (!writer.Open(path, circles.Count(), rectangles.Count()))
+        return false;
+
+    for (size_t index = 0; index < circles.Count(); index++)
+    {
+        writer.AddCircle(circles.x[index], circles.y[index], circles.radius[index]);
+    }
+
+    for (size_t index = 0; index < rectangles.Count(); index++)
+    {
+        writer.AddRectangle(rectangles.x[index], rectangles.y[index], rectangles.width[index], rectangles.height[index]);
+    }
+
+    return writer.Close();
+}
+
+/// ---------------------------------------------------------------------------------
+/// MappedScene
+/// ---------------------------------------------------------------------------------
+MappedScene::MappedScene()
+    : mData(nullptr)
+    , mSize(0)
+    , mCircles()
+    , mRectangles()
+{
+}
+
+MappedScene::~MappedScene()
+{
+    Close();
+}
+
+SceneFileStatus MappedScene::Open(const char* path, bool verifyChecksums)
+{
+    Close();
+
+    if (!IsLittleEndianHost())
+        return SceneFileStatus::UnsupportedHost;
+
+    // Once the file's mapped, its handle can go: the mapping keeps what it needs
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return SceneFileStatus::CantOpen;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || (unsigned long long)size.QuadPart > (size_t)-1)
+    {
+        CloseHandle(file);
+        return SceneFileStatus::CantOpen;
+    }
+    if ((size_t)size.QuadPart < sizeof(SceneFileHeader))
+    {
+        CloseHandle(file);
+        return SceneFileStatus::NotASceneFile;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr)
+        return SceneFileStatus::CantOpen;
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data == nullptr)
+        return SceneFileStatus::CantOpen;
+
+    mSize = (size_t)size.QuadPart;
+#else
+    int file = open(path, O_RDONLY);
+    if (file < 0)
+        return SceneFileStatus::CantOpen;
+
+    struct stat info;
+    if (fstat(file, &info) != 0 || (unsigned long long)info.st_size > (size_t)-1)
+    {
+        close(file);
+        return SceneFileStatus::CantOpen;
+    }
+    if ((size_t)info.st_size < sizeof(SceneFileHeader))
+    {
+        close(file);
+        return SceneFileStatus::NotASceneFile;
+    }
+
+    void* data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (data == MAP_FAILED)
+        return SceneFileStatus::CantOpen;
+
+    mSize = (size_t)info.st_size;
+#endif
+
+    mData = static_cast<const uint8_t*>(data);
+
+    SceneFileStatus status = Validate(verifyChecksums);
+    if (status != SceneFileStatus::Ok)
+        Close();
+    return status;
+}
+
+// Everything in the header comes from a file, so none of it is trusted until it's
+// been checked against the size of the file - offsets and counts included.
+SceneFileStatus MappedScene::Validate(bool verifyChecksums)
+{
+    SceneFileHeader header;
+    memcpy(&header, mData, sizeof(header));
+
+    if (memcmp(header.magic, kSceneMagic, sizeof(kSceneMagic)) != 0)
+        return SceneFileStatus::NotASceneFile;
+    if (header.version != kSceneFileVersion)
+        return SceneFileStatus::UnsupportedVersion;
+    if (header.headerSize != sizeof(SceneFileHeader))
+        return SceneFileStatus::BadLayout;
+    if (header.headerCrc != HeaderCrc(header))
+        return SceneFileStatus::ChecksumMismatch;
+    if (header.fileSize > mSize)
+        return SceneFileStatus::Truncated;
+
+    const uint8_t* arrays[kSceneArrayCount];
+    for (int array = 0; array < kSceneArrayCount; array++)
+    {
+        uint64_t count = array < kSceneRectangleX ? header.circleCount : header.rectangleCount;
+        uint64_t offset = header.arrayOffset[array];
+
+        // Written as subtractions, so a huge count or offset can't wrap around
+        if (offset % kSceneAlignment != 0 || offset < sizeof(SceneFileHeader) || offset > header.fileSize ||
+            count > (header.fileSize - offset) / sizeof(float))
+        {
+            return SceneFileStatus::BadLayout;
+        }
+
+        arrays[array] = mData + offset;
+        if (verifyChecksums && Crc32(0, arrays[array], (size_t)count * sizeof(float)) != header.arrayCrc[array])
+            return SceneFileStatus::ChecksumMismatch;
+    }
+
+    // The mapping starts on a page boundary and every offset is a multiple of 64, so
+    // the floats are all properly aligned.
+    mCircles.x = reinterpret_cast<const float*>(arrays[kSceneCircleX]);
+    mCircles.y = reinterpret_cast<const float*>(arrays[kSceneCircleY]);
+    mCircles.radius = reinterpret_cast<const float*>(arrays[kSceneCircleRadius]);
+    mCircles.count = (size_t)header.circleCount;
+
+    mRectangles.x = reinterpret_cast<const float*>(arrays[kSceneRectangleX]);
+    mRectangles.y = reinterpret_cast<const float*>(arrays[kSceneRectangleY]);
+    mRectangles.width = reinterpret_cast<const float*>(arrays[kSceneRectangleWidth]);
+    mRectangles.height = reinterpret_cast<const float*>(arrays[kSceneRectangleHeight]);
+    mRectangles.count = (size_t)header.rectangleCount;
+
+    return SceneFileStatus::Ok;
+}
+
+void MappedScene::Close()
+{
+    if (mData != nullptr)
+    {
+#if defined(_WIN32)
+        UnmapViewOfFile(mData);
+#else
+        munmap(const_cast<uint8_t*>(mData), mSize);
+#endif
+    }
+
+    mData = nullptr;
+    mSize = 0;
+    mCircles = CircleArrays();
+    mRectangles = RectangleArrays();
+}
+
+void MappedScene::Draw() const
+{
+    DrawCircleArrays(mCircles.x, mCircles.y, mCircles.radius, mCircles.count);
+    DrawRectangleArrays(mRectangles.x, mRectangles.y, mRectangles.width, mRectangles.height, mRectangles.count);
+}
+
+void MappedScene::CopyTo(ShapeStore& shapes) const
+{
+    // Through Clear(), so that a store with TrackChanges() on gets the whole screen
+    // marked dirty
+    shapes.Clear();
+
+    ShapeStore::CirclePool& circles = shapes.Circles();
+    circles.x.assign(mCircles.x, mCircles.x + mCircles.count);
+    circles.y.assign(mCircles.y, mCircles.y + mCircles.count);
+    circles.radius.assign(mCircles.radius, mCircles.radius + mCircles.count);
+
+    ShapeStore::RectanglePool& rectangles = shapes.Rectangles();
+    rectangles.x.assign(mRectangles.x, mRectangles.x + mRectangles.count);
+    rectangles.y.assign(mRectangles.y, mRectangles.y + mRectangles.count);
+    rectangles.width.assign(mRectangles.width, mRectangles.width + mRectangles.count);
+    rectangles.height.assign(mRectangles.height, mRectangles.height + mRectangles.count);
+}
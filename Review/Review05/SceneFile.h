@@ -0,0 +1,194 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+class ShapeStore;
+
+/// ---------------------------------------------------------------------------------
+/// Saving a ShapeStore to a file, and drawing straight out of the file.
+///
+/// BuildScene() adds ten shapes one call at a time, which is fine for ten. A scene of
+/// millions loaded like that - read a record, build a shape, push it into a vector,
+/// over and over - spends its startup time copying and allocating. A scene file is
+/// laid out exactly like a ShapeStore's pools: the circles' x's, then their y's, then
+/// their radii, then the same for the rectangles' x, y, width and height. Each array
+/// is little-endian floats, starting on a 64 byte boundary. So there's nothing to
+/// parse: MappedScene maps the file into memory and hands out pointers into it, and
+/// the operating system reads in the pages as they're first touched.
+///
+///     offset 0     the header (128 bytes: see SceneFileHeader)
+///     64*n         circle x[circleCount]
+///     64*n         circle y[circleCount]
+///     ...          (and so on, each array padded to 64 bytes)
+///     64*n         rectangle height[rectangleCount]
+///
+/// The header has a CRC-32 of each array and one of itself. The header's is always
+/// checked when a file's opened (it's 124 bytes); the arrays' are checked too unless
+/// you ask Open() not to. That reads the whole file, about 10 milliseconds for a million
+/// shapes - but without it, a flipped bit in a file is a shape in the wrong place
+/// rather than an error.
+///
+/// The version goes up whenever the layout changes; a file with a different version
+/// isn't opened at all. The file is little-endian whatever wrote it, and since the
+/// arrays are used in place, it can only be opened on a little-endian machine (which
+/// is every one these examples run on).
+/// ---------------------------------------------------------------------------------
+
+const uint32_t kSceneFileVersion = 1;
+
+/// Where each array is: SceneFileHeader::arrayOffset[kSceneCircleX] and so on
+enum SceneArray
+{
+    kSceneCircleX,
+    kSceneCircleY,
+    kSceneCircleRadius,
+    kSceneRectangleX,
+    kSceneRectangleY,
+    kSceneRectangleWidth,
+    kSceneRectangleHeight,
+    kSceneArrayCount
+};
+
+struct SceneFileHeader
+{
+    char     magic[8];                          ///< "R05SCENE"
+    uint32_t version;                           ///< kSceneFileVersion
+    uint32_t headerSize;                        ///< sizeof(SceneFileHeader)
+    uint64_t circleCount;
+    uint64_t rectangleCount;
+    uint64_t fileSize;
+    uint64_t arrayOffset[kSceneArrayCount];     ///< From the start of the file
+    uint32_t arrayCrc[kSceneArrayCount];
+    uint32_t headerCrc;                         ///< Of everything above
+};
+
+static_assert(sizeof(SceneFileHeader) == 128, "SceneFileHeader should be 128 bytes");
+
+enum class SceneFileStatus
+{
+    Ok,
+    CantOpen,               ///< Missing, unreadable, or couldn't be mapped
+    NotASceneFile,          ///< Too short, or the wrong magic (or a SceneWriter never finished it)
+    UnsupportedVersion,
+    UnsupportedHost,        ///< A big-endian machine
+    Truncated,              ///< Shorter than the header says it is
+    BadLayout,              ///< Arrays that are misaligned or run off the end
+    ChecksumMismatch        ///< The header or one of the arrays isn't what was written
+};
+
+const char* SceneFileStatusName(SceneFileStatus status);
+
+/// ---------------------------------------------------------------------------------
+/// Writes a scene file a shape at a time, without ever holding the whole scene.
+///
+/// It needs to know how many of each shape there'll be up front, so it knows where
+/// each array starts. After that, shapes can be added in any order; each array has
+/// its own 64K buffer, written out to its place in the file whenever it fills up.
+/// Close() writes the header last, so a file that was never finished (or whose counts
+/// came out wrong) doesn't open.
+/// ---------------------------------------------------------------------------------
+class SceneWriter
+{
+public:
+    SceneWriter();
+    ~SceneWriter();
+
+    SceneWriter(const SceneWriter&) = delete;
+    SceneWriter& operator=(const SceneWriter&) = delete;
+
+    bool Open(const char* path, size_t circleCount, size_t rectangleCount);
+
+    /// Adding more than Open() said there'd be fails the whole file (in Close()).
+    void AddCircle(float inX, float inY, float radius);
+    void AddRectangle(float inX, float inY, float width, float height);
+
+    /// Returns false if anything went wrong since Open(): a failed write, or not
+    /// exactly the number of shapes promised.
+    bool Close();
+
+private:
+    static const size_t kBufferFloats = 16384;
+
+    void Put(SceneArray array, float value);
+    void Flush(SceneArray array);
+
+    FILE*              mFile;
+    bool               mFailed;
+    SceneFileHeader    mHeader;
+    uint64_t           mWritten[kSceneArrayCount];   ///< Floats already in the file
+    size_t             mBuffered[kSceneArrayCount];
+    std::vector<float> mBuffers;                     ///< kBufferFloats for each array
+};
+
+/// Everything in `shapes`, in one go. Returns false if the file couldn't be written.
+bool WriteScene(const char* path, const ShapeStore& shapes);
+
+/// ---------------------------------------------------------------------------------
+/// A scene file, mapped into memory read-only.
+///
+/// Open() checks the header and that every array is inside the file, and then the
+/// arrays are used right where they are: Circles() and Rectangles() point into the
+/// mapping, the same shape as ShapeStore's pools. Nothing is copied or allocated.
+/// The pointers are good until Close() (or the destructor).
+/// ---------------------------------------------------------------------------------
+class MappedScene
+{
+public:
+    struct CircleArrays
+    {
+        const float* x;
+        const float* y;
+        const float* radius;
+        size_t       count;
+
+        size_t Count() const { return count; }
+    };
+
+    struct RectangleArrays
+    {
+        const float* x;
+        const float* y;
+        const float* width;
+        const float* height;
+        size_t       count;
+
+        size_t Count() const { return count; }
+    };
+
+    MappedScene();
+    ~MappedScene();
+
+    MappedScene(const MappedScene&) = delete;
+    MappedScene& operator=(const MappedScene&) = delete;
+
+    /// Pass verifyChecksums = false to skip reading the whole file to check the
+    /// arrays' CRCs (the header's is still checked).
+    SceneFileStatus Open(const char* path, bool verifyChecksums = true);
+    void Close();
+
+    bool IsOpen() const { return mData != nullptr; }
+
+    size_t Count() const { return mCircles.count + mRectangles.count; }
+    const CircleArrays& Circles() const { return mCircles; }
+    const RectangleArrays& Rectangles() const { return mRectangles; }
+
+    /// The same as ShapeStore::Draw(): every circle, then every rectangle.
+    void Draw() const;
+
+    /// Replaces whatever's in `shapes` with a copy of the scene, for when you need
+    /// to change it (or index it: SpatialIndex.h works on a ShapeStore). Like
+    /// ShapeStore::Clear(), it dirties the whole screen if the store is tracking
+    /// changes.
+    void CopyTo(ShapeStore& shapes) const;
+
+private:
+    SceneFileStatus Validate(bool verifyChecksums);
+
+    const uint8_t*  mData;
+    size_t          mSize;
+    CircleArrays    mCircles;
+    RectangleArrays mRectangles;
+};
@@ -0,0 +1,156 @@
+#include "ScenePipeline.h"
+
+#include "Math2DBatch.h"
+#include "RenderBackend.h"
+#include "Shape.h"
+
+ScenePipeline::ScenePipeline(ThreadPool& pool)
+    : mPool(pool)
+{
+}
+
+void ScenePipeline::Prepare(ShapeStore& store, const Affine2D& motion, const AABB& viewport)
+{
+    UpdateTransforms(store, motion);
+    Cull(store, viewport);
+    SortByType();
+    BuildDrawList(store);
+}
+
+// Circles first, then rectangles: the order Draw() draws them in. The chunks (and
+// their visible lists) are reused from frame to frame.
+void ScenePipeline::SplitIntoChunks(const ShapeStore& store)
+{
+    const size_t circleCount = store.Circles().Count();
+    const size_t rectangleCount = store.Rectangles().Count();
+    const size_t circleChunks = (circleCount + kChunkSize - 1) / kChunkSize;
+    const size_t rectangleChunks = (rectangleCount + kChunkSize - 1) / kChunkSize;
+
+    mChunks.resize(circleChunks + rectangleChunks);
+    for (size_t index = 0; index < mChunks.size(); index++)
+    {
+        Chunk& chunk = mChunks[index];
+        chunk.rectangles = index >= circleChunks;
+
+        size_t total = chunk.rectangles ? rectangleCount : circleCount;
+        chunk.first = (chunk.rectangles ? index - circleChunks : index) * kChunkSize;
+        chunk.count = total - chunk.first < kChunkSize ? total - chunk.first : kChunkSize;
+        chunk.offset = 0;
+    }
+}
+
+void ScenePipeline::UpdateTransforms(ShapeStore& store, const Affine2D& motion)
+{
+    SplitIntoChunks(store);
+
+    ShapeStore::CirclePool& circles = store.Circles();
+    ShapeStore::RectanglePool& rectangles = store.Rectangles();
+
+    mPool.ParallelFor((int)mChunks.size(), [&](int index)
+    {
+        const Chunk& chunk = mChunks[index];
+        float* x = chunk.rectangles ? rectangles.x.data() : circles.x.data();
+        float* y = chunk.rectangles ? rectangles.y.data() : circles.y.data();
+        TransformPoints(x + chunk.first, y + chunk.first, x + chunk.first, y + chunk.first, chunk.count, motion);
+    });
+}
+
+void ScenePipeline::Cull(const ShapeStore& store, const AABB& viewport)
+{
+    SplitIntoChunks(store);
+
+    // The same padding as DrawVisible(): outlines stick out half a pixel
+    const AABB padded(viewport.min - Vec2(1.0f, 1.0f), viewport.max + Vec2(1.0f, 1.0f));
+    const ShapeStore::CirclePool& circles = store.Circles();
+    const ShapeStore::RectanglePool& rectangles = store.Rectangles();
+
+    mPool.ParallelFor((int)mChunks.size(), [&](int index)
+    {
+        Chunk& chunk = mChunks[index];
+        chunk.visible.clear();
+
+        const size_t end = chunk.first + chunk.count;
+        if (chunk.rectangles)
+        {
+            for (size_t shape = chunk.first; shape < end; shape++)
+            {
+                AABB bounds = RectangleBounds(rectangles.x[shape], rectangles.y[shape], rectangles.width[shape], rectangles.height[shape]);
+                if (Overlaps(bounds, padded))
+                {
+                    chunk.visible.push_back(RectangleId(shape));
+                }
+            }
+        }
+        else
+        {
+            for (size_t shape = chunk.first; shape < end; shape++)
+            {
+                AABB bounds = CircleBounds(circles.x[shape], circles.y[shape], circles.radius[shape]);
+                if (Overlaps(bounds, padded))
+                {
+                    chunk.visible.push_back(CircleId(shape));
+                }
+            }
+        }
+    });
+}
+
+// A handful of additions, one per chunk - far too little to be worth splitting up
+void ScenePipeline::SortByType()
+{
+    size_t total = 0;
+    for (Chunk& chunk : mChunks)
+    {
+        chunk.offset = total;
+        total += chunk.visible.size();
+    }
+    mDrawList.resize(total);
+}
+
+void ScenePipeline::BuildDrawList(const ShapeStore& store)
+{
+    const ShapeStore::CirclePool& circles = store.Circles();
+    const ShapeStore::RectanglePool& rectangles = store.Rectangles();
+
+    mPool.ParallelFor((int)mChunks.size(), [&](int index)
+    {
+        const Chunk& chunk = mChunks[index];
+        DrawCommand* out = mDrawList.data() + chunk.offset;
+
+        for (ShapeId id : chunk.visible)
+        {
+            size_t shape = ShapeIndex(id);
+            out->id = id;
+            if (chunk.rectangles)
+            {
+                float halfWidth = rectangles.width[shape] * 0.5f;
+                float halfHeight = rectangles.height[shape] * 0.5f;
+                out->shape[0] = rectangles.x[shape] - halfWidth;
+                out->shape[1] = rectangles.y[shape] - halfHeight;
+                out->shape[2] = rectangles.x[shape] + halfWidth;
+                out->shape[3] = rectangles.y[shape] + halfHeight;
+            }
+            else
+            {
+                out->shape[0] = circles.x[shape];
+                out->shape[1] = circles.y[shape];
+                out->shape[2] = circles.radius[shape];
+                out->shape[3] = 0.0f;
+            }
+            out++;
+        }
+    });
+}
+
+void ScenePipeline::Submit() const
+{
+    RenderBackend& backend = GetRenderBackend();
+
+    for (const DrawCommand& command : mDrawList)
+    {
+        if (IsRectangleId(command.id))
+            backend.DrawRectangle(command.shape[0], command.shape[1], command.shape[2], command.shape[3], kShapeColor, kShapeThickness);
+        else
+            backend.DrawCircle(command.shape[0], command.shape[1], command.shape[2], kShapeColor, kShapeThickness);
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+
+#include "Bounds.h"
+#include "Math2D.h"
+#include "ShapeStore.h"
+#include "ThreadPool.h"
+
+/// One shape, ready to hand to the RenderBackend without looking at the store again.
+struct DrawCommand
+{
+    ShapeId id;         ///< IsRectangleId(id) says which kind it is
+    float   shape[4];   ///< A circle's x, y and radius; a rectangle's left, top, right and bottom
+};
+
+/// ---------------------------------------------------------------------------------
+/// A frame of a moving scene, in stages, with all but the last spread over a
+/// ThreadPool.
+///
+///  1. UpdateTransforms: moves every shape's center by a transform (everything
+///     orbiting the middle of the screen, say).
+///  2. Cull: finds the shapes whose bounds overlap the viewport.
+///  3. SortByType: puts the visible shapes in drawing order, circles then rectangles.
+///  4. BuildDrawList: turns each visible shape into a DrawCommand.
+///  5. Submit: draws the list with the current RenderBackend.
+///
+/// Stages 1 to 4 only read and write memory, so Prepare() runs them on the pool.
+/// Submit() is the only one that talks to the backend, and it's the only one that
+/// has to run on the render thread - Allegro, like most graphics APIs, wants to be
+/// called from one thread only.
+///
+/// The shapes are cut into chunks of kChunkSize, each all circles or all
+/// rectangles, and each stage hands the pool one task per chunk. A chunk's visible
+/// shapes come out of Cull already in index order, and the circle chunks come before
+/// the rectangle ones, so sorting by type doesn't need to compare anything: it's a
+/// running total of how many each chunk found, which says where in the draw list
+/// that chunk's commands go. Then BuildDrawList can fill the list in parallel, with
+/// no locks, because every chunk writes its own part of it.
+///
+/// Why not cull with the BVH from SpatialIndex.h? Every shape moves every frame, so
+/// the tree would have to be rebuilt every frame too, and that costs more than
+/// testing each shape's bounds once - which is what Cull does.
+///
+/// The result is exactly what DrawVisible() draws with the same viewport; only the
+/// work before Submit() is spread out.
+/// ---------------------------------------------------------------------------------
+class ScenePipeline
+{
+public:
+    explicit ScenePipeline(ThreadPool& pool);
+
+    /// Stages 1 to 4. `motion` only moves the centers; the sizes stay the same, so
+    /// anything but a rotation and a translation will distort the scene over time.
+    void Prepare(ShapeStore& store, const Affine2D& motion, const AABB& viewport);
+
+    /// The stages one at a time, in this order, for timing them separately.
+    void UpdateTransforms(ShapeStore& store, const Affine2D& motion);
+    void Cull(const ShapeStore& store, const AABB& viewport);
+    void SortByType();
+    void BuildDrawList(const ShapeStore& store);
+
+    /// Draws the draw list, in order, with the current RenderBackend. Call it from the
+    /// render thread.
+    void Submit() const;
+
+    const std::vector<DrawCommand>& DrawList() const { return mDrawList; }
+
+    /// How many shapes a task handles. Big enough that handing out a task costs
+    /// next to nothing by comparison, small enough that a million shapes make plenty
+    /// of tasks for a 32 core machine.
+    static const size_t kChunkSize = 16384;
+
+private:
+    struct Chunk
+    {
+        bool                 rectangles;
+        size_t               first;
+        size_t               count;
+        std::vector<ShapeId> visible;   ///< Kept between frames, so it doesn't have to grow again
+        size_t               offset;    ///< Where its commands go in mDrawList
+    };
+
+    void SplitIntoChunks(const ShapeStore& store);
+
+    ThreadPool&              mPool;
+    std::vector<Chunk>       mChunks;
+    std::vector<DrawCommand> mDrawList;
+};
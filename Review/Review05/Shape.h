@@ -1,16 +1,14 @@
 #pragma once
 
-struct Point2D
-{
-    float x;
-    float y;
+#include "Bounds.h"
+#include "Math2D.h"
+#include "RenderBackend.h"
 
-    Point2D(float inX, float inY)
-    {
-        x = inX;
-        y = inY;
-    }
-};
+/// How every shape is drawn: a one pixel, white outline. ShapeStore and ScenePipeline
+/// draw shapes without going through Circle and Rectangle, so they use these too, and
+/// the pictures stay the same whichever way they're drawn.
+const RenderColor kShapeColor = { 255, 255, 255, 255 };
+const float kShapeThickness = 1.0f;
 
 class VirtualShape
 {
@@ -23,4 +21,7 @@ public:
     Point2D mCenter;
 
     virtual void Draw() = 0;
+
+    /// The box the shape fits in, for culling and picking (see SpatialIndex.h).
+    virtual AABB Bounds() const = 0;
 };
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include "ShapeBatcher.h"
+
+#include <math.h>
+
+static const int kMinSegments = 8;
+static const int kMaxSegments = 128;
+
+// Roughly one segment per couple of pixels of circumference, like Allegro does.
+static int SegmentsFor(float radius)
+{
+    int segments = (int)(sqrtf(radius > 0.0f ? radius : 0.0f) * 8.0f);
+    if (segments < kMinSegments)
+        return kMinSegments;
+    if (segments > kMaxSegments)
+        return kMaxSegments;
+    return segments;
+}
+
+static ALLEGRO_COLOR ToAllegro(RenderColor color)
+{
+    return al_map_rgba(color.r, color.g, color.b, color.a);
+}
+
+ShapeBatcher::ShapeBatcher()
+    : mUnitCircles(kMaxSegments + 1)
+    , mPendingShapes(0)
+    , mDrawCalls(0)
+{}
+
+void ShapeBatcher::Clear(RenderColor color)
+{
+    Flush();
+    al_clear_to_color(ToAllegro(color));
+}
+
+void ShapeBatcher::SetClip(int left, int top, int right, int bottom)
+{
+    Flush();
+    al_set_clipping_rectangle(left, top, right - left, bottom - top);
+}
+
+void ShapeBatcher::ResetClip()
+{
+    Flush();
+    al_reset_clipping_rectangle();
+}
+
+void ShapeBatcher::DrawCircle(float centerX, float centerY, float radius, RenderColor color, float thickness)
+{
+    float half = (thickness > 0.0f ? thickness : 1.0f) * 0.5f;
+    AddRing(mCircles, centerX, centerY, radius + half, radius - half, ToAllegro(color));
+    mPendingShapes++;
+}
+
+void ShapeBatcher::FillCircle(float centerX, float centerY, float radius, RenderColor color)
+{
+    AddRing(mCircles, centerX, centerY, radius, -1.0f, ToAllegro(color));
+    mPendingShapes++;
+}
+
+void ShapeBatcher::DrawRectangle(float left, float top, float right, float bottom, RenderColor color, float thickness)
+{
+    float half = (thickness > 0.0f ? thickness : 1.0f) * 0.5f;
+    ALLEGRO_COLOR allegroColor = ToAllegro(color);
+
+    // Top and bottom run the full width; the sides fill in between them
+    AddQuad(mRectangles, left - half, top - half, right + half, top + half, allegroColor);
+    AddQuad(mRectangles, left - half, bottom - half, right + half, bottom + half, allegroColor);
+    AddQuad(mRectangles, left - half, top + half, left + half, bottom - half, allegroColor);
+    AddQuad(mRectangles, right - half, top + half, right + half, bottom - half, allegroColor);
+    mPendingShapes++;
+}
+
+void ShapeBatcher::FillRectangle(float left, float top, float right, float bottom, RenderColor color)
+{
+    AddQuad(mRectangles, left, top, right, bottom, ToAllegro(color));
+    mPendingShapes++;
+}
+
+void ShapeBatcher::Flush()
+{
+    Submit(mCircles);
+    Submit(mRectangles);
+    mPendingShapes = 0;
+}
+
+void ShapeBatcher::Submit(Batch& batch)
+{
+    if (!batch.indices.empty())
+    {
+        al_draw_indexed_prim(batch.vertices.data(), nullptr, nullptr,
+                             batch.indices.data(), (int)batch.indices.size(),
+                             ALLEGRO_PRIM_TRIANGLE_LIST);
+        mDrawCalls++;
+    }
+
+    // clear() keeps the capacity, so the next frame doesn't allocate
+    batch.vertices.clear();
+    batch.indices.clear();
+}
+
+void ShapeBatcher::AddVertex(Batch& batch, float x, float y, const ALLEGRO_COLOR& color)
+{
+    ALLEGRO_VERTEX vertex;
+    vertex.x = x;
+    vertex.y = y;
+    vertex.z = 0.0f;
+    vertex.u = 0.0f;
+    vertex.v = 0.0f;
+    vertex.color = color;
+    batch.vertices.push_back(vertex);
+}
+
+void ShapeBatcher::AddQuad(Batch& batch, float left, float top, float right, float bottom, const ALLEGRO_COLOR& color)
+{
+    int first = (int)batch.vertices.size();
+    AddVertex(batch, left, top, color);
+    AddVertex(batch, right, top, color);
+    AddVertex(batch, right, bottom, color);
+    AddVertex(batch, left, bottom, color);
+
+    const int quad[6] = { 0, 1, 2, 0, 2, 3 };
+    for (int corner : quad)
+    {
+        batch.indices.push_back(first + corner);
+    }
+}
+
+void ShapeBatcher::AddRing(Batch& batch, float centerX, float centerY, float outerRadius, float innerRadius, const ALLEGRO_COLOR& color)
+{
+    if (outerRadius <= 0.0f)
+        return;
+
+    int segments = SegmentsFor(outerRadius);
+    const std::vector<float>& unit = UnitCircle(segments);
+    int first = (int)batch.vertices.size();
+
+    if (innerRadius <= 0.0f)
+    {
+        // A fan around the center: vertex 0 is the center, 1..segments the rim
+        AddVertex(batch, centerX, centerY, color);
+        for (int segment = 0; segment < segments; segment++)
+        {
+            AddVertex(batch, centerX + unit[segment * 2] * outerRadius, centerY + unit[segment * 2 + 1] * outerRadius, color);
+        }
+
+        for (int segment = 0; segment < segments; segment++)
+        {
+            batch.indices.push_back(first);
+            batch.indices.push_back(first + 1 + segment);
+            batch.indices.push_back(first + 1 + (segment + 1) % segments);
+        }
+        return;
+    }
+
+    // Outer and inner rim, interleaved; one quad per segment
+    for (int segment = 0; segment < segments; segment++)
+    {
+        float unitX = unit[segment * 2];
+        float unitY = unit[segment * 2 + 1];
+        AddVertex(batch, centerX + unitX * outerRadius, centerY + unitY * outerRadius, color);
+        AddVertex(batch, centerX + unitX * innerRadius, centerY + unitY * innerRadius, color);
+    }
+
+    for (int segment = 0; segment < segments; segment++)
+    {
+        int outer = first + segment * 2;
+        int inner = outer + 1;
+        int nextOuter = first + ((segment + 1) % segments) * 2;
+        int nextInner = nextOuter + 1;
+
+        batch.indices.push_back(outer);
+        batch.indices.push_back(nextOuter);
+        batch.indices.push_back(inner);
+        batch.indices.push_back(inner);
+        batch.indices.push_back(nextOuter);
+        batch.indices.push_back(nextInner);
+    }
+}
+
+const std::vector<float>& ShapeBatcher::UnitCircle(int segments)
+{
+    std::vector<float>& unit = mUnitCircles[segments];
+    if (unit.empty())
+    {
+        unit.resize(segments * 2);
+        for (int segment = 0; segment < segments; segment++)
+        {
+            float angle = 2.0f * 3.14159265f * (float)segment / (float)segments;
+            unit[segment * 2] = cosf(angle);
+            unit[segment * 2 + 1] = sinf(angle);
+        }
+    }
+    return unit;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+
+#include <allegro5/allegro.h>
+#include <allegro5/allegro_primitives.h>
+
+#include "RenderBackend.h"
+
+/// ---------------------------------------------------------------------------------
+/// A RenderBackend that doesn't draw anything straight away. Every al_draw_circle or
+/// al_draw_rectangle is a separate trip through Allegro (and on to the GPU), with its
+/// own state setup, and with thousands of shapes that overhead is most of the frame.
+///
+/// Instead, the batcher turns each shape into triangles on the CPU and collects them:
+///  - circles are cut into segments: a fan of triangles when filled, a ring of quads
+///    when outlined,
+///  - rectangles are a quad when filled, four quads (one per side) when outlined.
+///
+/// Flush() then hands each batch to Allegro in one al_draw_indexed_prim call: two
+/// draw calls for the whole frame, however many shapes there are.
+///
+///     ShapeBatcher batcher;
+///     SetRenderBackend(&batcher);
+///     shapes.Draw();
+///     batcher.Flush();
+/// ---------------------------------------------------------------------------------
+class ShapeBatcher : public RenderBackend
+{
+public:
+    ShapeBatcher();
+
+    /// Flushes what's been gathered so far first, so it ends up under the clear.
+    virtual void Clear(RenderColor color) override;
+
+    virtual void DrawCircle(float centerX, float centerY, float radius, RenderColor color, float thickness) override;
+    virtual void FillCircle(float centerX, float centerY, float radius, RenderColor color) override;
+
+    virtual void DrawRectangle(float left, float top, float right, float bottom, RenderColor color, float thickness) override;
+    virtual void FillRectangle(float left, float top, float right, float bottom, RenderColor color) override;
+
+    /// These flush first too: what's been gathered so far was meant for the old clip.
+    virtual void SetClip(int left, int top, int right, int bottom) override;
+    virtual void ResetClip() override;
+
+    /// Draws everything gathered since the last Flush() to Allegro's current target:
+    /// one call for the circles, one for the rectangles (none for an empty batch).
+    void Flush();
+
+    /// Draw calls Flush() has made since the last ResetDrawCalls(). Reset it at the
+    /// start of each frame to get draw calls per frame.
+    unsigned DrawCalls() const { return mDrawCalls; }
+    void ResetDrawCalls() { mDrawCalls = 0; }
+
+    /// Shapes and vertices waiting for the next Flush()
+    size_t PendingShapes() const { return mPendingShapes; }
+    size_t PendingVertices() const { return mCircles.vertices.size() + mRectangles.vertices.size(); }
+
+private:
+    struct Batch
+    {
+        std::vector<ALLEGRO_VERTEX> vertices;
+        std::vector<int>            indices;
+    };
+
+    void AddVertex(Batch& batch, float x, float y, const ALLEGRO_COLOR& color);
+    void AddQuad(Batch& batch, float left, float top, float right, float bottom, const ALLEGRO_COLOR& color);
+
+    /// The ring between the two radii; a negative inner radius is a filled circle.
+    void AddRing(Batch& batch, float centerX, float centerY, float outerRadius, float innerRadius, const ALLEGRO_COLOR& color);
+
+    /// cos/sin pairs for a circle cut into `segments` pieces, worked out once.
+    const std::vector<float>& UnitCircle(int segments);
+
+    void Submit(Batch& batch);
+
+    Batch mCircles;
+    Batch mRectangles;
+    std::vector<std::vector<float>> mUnitCircles;
+    size_t mPendingShapes;
+    unsigned mDrawCalls;
+};
@@ -0,0 +1,202 @@
+#include "ShapeStore.h"
+
+#include "DirtyRegions.h"
+#include "RenderBackend.h"
+#include "Shape.h"
+
+#include <math.h>
+
+size_t ShapeStore::AddCircle(float inX, float inY, float radius)
+{
+    mCircles.x.push_back(inX);
+    mCircles.y.push_back(inY);
+    mCircles.radius.push_back(radius);
+    Changed(AABB(), CircleBounds(inX, inY, radius));
+    return mCircles.Count() - 1;
+}
+
+size_t ShapeStore::AddRectangle(float inX, float inY, float width, float height)
+{
+    mRectangles.x.push_back(inX);
+    mRectangles.y.push_back(inY);
+    mRectangles.width.push_back(width);
+    mRectangles.height.push_back(height);
+    Changed(AABB(), RectangleBounds(inX, inY, width, height));
+    return mRectangles.Count() - 1;
+}
+
+void ShapeStore::Reserve(size_t circleCount, size_t rectangleCount)
+{
+    mCircles.x.reserve(circleCount);
+    mCircles.y.reserve(circleCount);
+    mCircles.radius.reserve(circleCount);
+
+    mRectangles.x.reserve(rectangleCount);
+    mRectangles.y.reserve(rectangleCount);
+    mRectangles.width.reserve(rectangleCount);
+    mRectangles.height.reserve(rectangleCount);
+}
+
+void ShapeStore::Clear()
+{
+    mCircles = CirclePool();
+    mRectangles = RectanglePool();
+
+    if (mChanges != nullptr)
+        mChanges->AddAll();
+}
+
+void ShapeStore::SetCenter(ShapeId id, Vec2 center)
+{
+    size_t shape = ShapeIndex(id);
+    AABB before = Bounds(id);
+    if (IsRectangleId(id))
+    {
+        mRectangles.x[shape] = center.x;
+        mRectangles.y[shape] = center.y;
+    }
+    else
+    {
+        mCircles.x[shape] = center.x;
+        mCircles.y[shape] = center.y;
+    }
+    Changed(before, Bounds(id));
+}
+
+void ShapeStore::SetRadius(size_t circle, float radius)
+{
+    AABB before = Bounds(CircleId(circle));
+    mCircles.radius[circle] = radius;
+    Changed(before, Bounds(CircleId(circle)));
+}
+
+void ShapeStore::SetSize(size_t rectangle, float width, float height)
+{
+    AABB before = Bounds(RectangleId(rectangle));
+    mRectangles.width[rectangle] = width;
+    mRectangles.height[rectangle] = height;
+    Changed(before, Bounds(RectangleId(rectangle)));
+}
+
+void ShapeStore::Changed(const AABB& before, const AABB& after)
+{
+    if (mChanges == nullptr)
+        return;
+    if (before.min == after.min && before.max == after.max)
+        return;
+
+    mChanges->Add(before);
+    mChanges->Add(after);
+}
+
+void ShapeStore::Draw() const
+{
+    DrawCircles();
+    DrawRectangles();
+}
+
+void ShapeStore::DrawCircles() const
+{
+    DrawCircleArrays(mCircles.x.data(), mCircles.y.data(), mCircles.radius.data(), mCircles.Count());
+}
+
+void ShapeStore::DrawRectangles() const
+{
+    DrawRectangleArrays(mRectangles.x.data(), mRectangles.y.data(), mRectangles.width.data(), mRectangles.height.data(), mRectangles.Count());
+}
+
+void DrawCircleArrays(const float* x, const float* y, const float* radius, size_t count)
+{
+    RenderBackend& backend = GetRenderBackend();
+
+    for (size_t index = 0; index < count; index++)
+    {
+        backend.DrawCircle(x[index], y[index], radius[index], kShapeColor, kShapeThickness);
+    }
+}
+
+void DrawRectangleArrays(const float* x, const float* y, const float* width, const float* height, size_t count)
+{
+    RenderBackend& backend = GetRenderBackend();
+
+    for (size_t index = 0; index < count; index++)
+    {
+        float halfWidth = width[index] * 0.5f;
+        float halfHeight = height[index] * 0.5f;
+        backend.DrawRectangle(x[index] - halfWidth, y[index] - halfHeight,
+                              x[index] + halfWidth, y[index] + halfHeight,
+                              kShapeColor, kShapeThickness);
+    }
+}
+
+void ShapeStore::Draw(const ShapeId* ids, size_t count) const
+{
+    RenderBackend& backend = GetRenderBackend();
+
+    for (size_t index = 0; index < count; index++)
+    {
+        size_t shape = ShapeIndex(ids[index]);
+        if (IsRectangleId(ids[index]))
+        {
+            float halfWidth = mRectangles.width[shape] * 0.5f;
+            float halfHeight = mRectangles.height[shape] * 0.5f;
+            backend.DrawRectangle(mRectangles.x[shape] - halfWidth, mRectangles.y[shape] - halfHeight,
+                                  mRectangles.x[shape] + halfWidth, mRectangles.y[shape] + halfHeight,
+                                  kShapeColor, kShapeThickness);
+        }
+        else
+        {
+            backend.DrawCircle(mCircles.x[shape], mCircles.y[shape], mCircles.radius[shape], kShapeColor, kShapeThickness);
+        }
+    }
+}
+
+AABB ShapeStore::Bounds(ShapeId id) const
+{
+    size_t shape = ShapeIndex(id);
+    if (IsRectangleId(id))
+        return RectangleBounds(mRectangles.x[shape], mRectangles.y[shape], mRectangles.width[shape], mRectangles.height[shape]);
+    return CircleBounds(mCircles.x[shape], mCircles.y[shape], mCircles.radius[shape]);
+}
+
+void ShapeStore::CollectBounds(std::vector<ShapeId>& ids, std::vector<AABB>& bounds) const
+{
+    ids.clear();
+    bounds.clear();
+    ids.reserve(Count());
+    bounds.reserve(Count());
+
+    for (size_t index = 0; index < mCircles.Count(); index++)
+    {
+        ids.push_back(CircleId(index));
+        bounds.push_back(CircleBounds(mCircles.x[index], mCircles.y[index], mCircles.radius[index]));
+    }
+    for (size_t index = 0; index < mRectangles.Count(); index++)
+    {
+        ids.push_back(RectangleId(index));
+        bounds.push_back(RectangleBounds(mRectangles.x[index], mRectangles.y[index], mRectangles.width[index], mRectangles.height[index]));
+    }
+}
+
+bool ShapeStore::Contains(ShapeId id, Vec2 point) const
+{
+    size_t shape = ShapeIndex(id);
+    if (IsRectangleId(id))
+        return ::Contains(Bounds(id), point);
+
+    Vec2 offset = point - Vec2(mCircles.x[shape], mCircles.y[shape]);
+    return LengthSquared(offset) <= mCircles.radius[shape] * mCircles.radius[shape];
+}
+
+bool ShapeStore::Overlaps(ShapeId id, const AABB& region) const
+{
+    size_t shape = ShapeIndex(id);
+    if (IsRectangleId(id))
+        return ::Overlaps(Bounds(id), region);
+
+    // The point of the region closest to the circle's center
+    float x = mCircles.x[shape];
+    float y = mCircles.y[shape];
+    Vec2 closest(fminf(fmaxf(x, region.min.x), region.max.x), fminf(fmaxf(y, region.min.y), region.max.y));
+    return LengthSquared(closest - Vec2(x, y)) <= mCircles.radius[shape] * mCircles.radius[shape];
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "Bounds.h"
+#include "Shape.h"
+#include "Circle.h"
+#include "Rectangle.h"
+
+class DirtyRegions;
+
+/// ---------------------------------------------------------------------------------
+/// A different way of holding on to lots of shapes.
+///
+/// `VirtualShape** shapes` is an array of pointers to objects that could be anywhere
+/// in memory. Drawing them means following each pointer, loading its vtable and
+/// calling through it - and with millions of shapes, almost every one of those is a
+/// cache miss.
+///
+/// A ShapeStore keeps each kind of shape in its own pool, and each pool is a
+/// 'structure of arrays': all the x's together, all the y's together, and so on.
+/// Drawing the circles is then one loop over a few contiguous float arrays, with no
+/// pointers to follow and no vtable to look up per shape.
+///
+/// Shapes are identified by their index in their own pool; removing shapes isn't
+/// supported (Clear() everything instead).
+///
+/// The pools can be changed directly, but nothing gets to hear about it. Changes made
+/// through SetCenter(), SetRadius() and SetSize() (and by adding shapes, Clear() and
+/// ForEach()) are passed on to the DirtyRegions given to TrackChanges(), if there is
+/// one, so that only the parts of the screen they touched need redrawing.
+/// ---------------------------------------------------------------------------------
+
+/// One shape in a ShapeStore, for code that deals with both kinds at once (the spatial
+/// indexes in SpatialIndex.h, say): a circle's id is its index, a rectangle's is its
+/// index with the top bit set. Adding shapes never changes an id, and ids sort into
+/// the order Draw() draws the shapes in.
+typedef uint32_t ShapeId;
+
+const ShapeId kRectangleIdBit = 0x80000000u;
+
+inline ShapeId CircleId(size_t index) { return (ShapeId)index; }
+inline ShapeId RectangleId(size_t index) { return (ShapeId)index | kRectangleIdBit; }
+inline bool IsRectangleId(ShapeId id) { return (id & kRectangleIdBit) != 0; }
+inline size_t ShapeIndex(ShapeId id) { return (size_t)(id & ~kRectangleIdBit); }
+
+class ShapeStore
+{
+public:
+    ShapeStore() : mChanges(nullptr) {}
+
+    struct CirclePool
+    {
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> radius;
+
+        size_t Count() const { return x.size(); }
+    };
+
+    struct RectanglePool
+    {
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> width;
+        std::vector<float> height;
+
+        size_t Count() const { return x.size(); }
+    };
+
+    /// Returns the new circle's index in Circles().
+    size_t AddCircle(float inX, float inY, float radius);
+
+    /// Returns the new rectangle's index in Rectangles().
+    size_t AddRectangle(float inX, float inY, float width, float height);
+
+    void Reserve(size_t circleCount, size_t rectangleCount);
+    void Clear();
+
+    size_t Count() const { return mCircles.Count() + mRectangles.Count(); }
+
+    /// Where to report changes to; nullptr (the default) stops reporting them.
+    void TrackChanges(DirtyRegions* changes) { mChanges = changes; }
+
+    void SetCenter(ShapeId id, Vec2 center);
+    void SetRadius(size_t circle, float radius);
+    void SetSize(size_t rectangle, float width, float height);
+
+    const CirclePool& Circles() const { return mCircles; }
+    CirclePool& Circles() { return mCircles; }
+    const RectanglePool& Rectangles() const { return mRectangles; }
+    RectanglePool& Rectangles() { return mRectangles; }
+
+    /// Draws every circle, then every rectangle, with the current RenderBackend.
+    void Draw() const;
+    void DrawCircles() const;
+    void DrawRectangles() const;
+
+    /// Draws just these shapes, in the order given.
+    void Draw(const ShapeId* ids, size_t count) const;
+
+    AABB Bounds(ShapeId id) const;
+
+    /// Every shape's id and bounds, circles first: what a spatial index is built from.
+    void CollectBounds(std::vector<ShapeId>& ids, std::vector<AABB>& bounds) const;
+
+    /// Exact tests against the shape itself, not just its bounds.
+    bool Contains(ShapeId id, Vec2 point) const;
+    bool Overlaps(ShapeId id, const AABB& region) const;
+
+    /// For code that still wants a VirtualShape&: calls `function(VirtualShape&)` once
+    /// per shape, circles first. Each call gets a temporary Circle or Rectangle built
+    /// from the pools, and anything the function changes (the center, the radius, the
+    /// size) is copied back afterwards. Don't hang on to the reference.
+    ///
+    /// This is for compatibility, not speed; use the pools directly where you can.
+    template<typename Function>
+    void ForEach(Function function)
+    {
+        for (size_t index = 0; index < mCircles.Count(); index++)
+        {
+            AABB before = Bounds(CircleId(index));
+            Circle circle(mCircles.x[index], mCircles.y[index], mCircles.radius[index]);
+            function(static_cast<VirtualShape&>(circle));
+            mCircles.x[index] = circle.mCenter.x;
+            mCircles.y[index] = circle.mCenter.y;
+            mCircles.radius[index] = circle.mRadius;
+            Changed(before, Bounds(CircleId(index)));
+        }
+
+        for (size_t index = 0; index < mRectangles.Count(); index++)
+        {
+            AABB before = Bounds(RectangleId(index));
+            Rectangle rectangle(mRectangles.x[index], mRectangles.y[index], mRectangles.width[index], mRectangles.height[index]);
+            function(static_cast<VirtualShape&>(rectangle));
+            mRectangles.x[index] = rectangle.mCenter.x;
+            mRectangles.y[index] = rectangle.mCenter.y;
+            mRectangles.width[index] = rectangle.mWidth;
+            mRectangles.height[index] = rectangle.mHeight;
+            Changed(before, Bounds(RectangleId(index)));
+        }
+    }
+
+private:
+    /// A shape that was inside `before` is now inside `after`. Does nothing if they're
+    /// the same, or if changes aren't being tracked.
+    void Changed(const AABB& before, const AABB& after);
+
+    CirclePool    mCircles;
+    RectanglePool mRectangles;
+    DirtyRegions* mChanges;
+};
+
+/// The loops ShapeStore::DrawCircles() and DrawRectangles() run, for shapes kept in
+/// plain arrays that aren't in a ShapeStore (a MappedScene's, say). x and y are the
+/// centers.
+void DrawCircleArrays(const float* x, const float* y, const float* radius, size_t count);
+void DrawRectangleArrays(const float* x, const float* y, const float* width, const float* height, size_t count);
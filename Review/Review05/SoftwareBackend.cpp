@@ -0,0 +1,366 @@
+#include "SoftwareBackend.h"
+
+#include "Crc32.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SOFTWARE_BACKEND_SSE2 1
+#else
+#define SOFTWARE_BACKEND_SSE2 0
+#endif
+
+SoftwareBackend::SoftwareBackend(int width, int height)
+    : mWidth(width > 0 ? width : 0)
+    , mHeight(height > 0 ? height : 0)
+    , mPixels((size_t)mWidth * (size_t)mHeight, 0)
+    , mClipLeft(0)
+    , mClipTop(0)
+    , mClipRight(mWidth)
+    , mClipBottom(mHeight)
+{}
+
+uint32_t SoftwareBackend::Pack(RenderColor color)
+{
+    uint8_t bytes[4] = { color.r, color.g, color.b, color.a };
+    uint32_t packed;
+    memcpy(&packed, bytes, sizeof(packed));
+    return packed;
+}
+
+RenderColor SoftwareBackend::GetPixel(int x, int y) const
+{
+    RenderColor color = { 0, 0, 0, 0 };
+    if (x >= 0 && x < mWidth && y >= 0 && y < mHeight)
+        memcpy(&color, &mPixels[(size_t)y * mWidth + x], sizeof(color));
+    return color;
+}
+
+/// ---------------------------------------------------------------------------------
+/// Spans
+/// ---------------------------------------------------------------------------------
+
+// The first pixel whose center is at or past `edge`. Written so that NaN comes out as
+// 0 too, rather than going to the (undefined) conversion to int.
+static int FirstPixel(float edge, int limit)
+{
+    float pixel = ceilf(edge - 0.5f);
+    if (!(pixel >= 0.0f))
+        return 0;
+    if (pixel > (float)limit)
+        return limit;
+    return (int)pixel;
+}
+
+void SoftwareBackend::FillSpan(int y, int left, int right, uint32_t color)
+{
+    if (y < mClipTop || y >= mClipBottom)
+        return;
+    if (left < mClipLeft)
+        left = mClipLeft;
+    if (right > mClipRight)
+        right = mClipRight;
+    if (left >= right)
+        return;
+
+    uint32_t* pixel = mPixels.data() + (size_t)y * mWidth + left;
+    uint32_t* end = pixel + (right - left);
+
+#if SOFTWARE_BACKEND_SSE2
+    // Four pixels per store
+    const __m128i color4 = _mm_set1_epi32((int)color);
+    for (; pixel + 4 <= end; pixel += 4)
+    {
+        _mm_storeu_si128((__m128i*)pixel, color4);
+    }
+#endif
+
+    for (; pixel < end; pixel++)
+    {
+        *pixel = color;
+    }
+}
+
+void SoftwareBackend::FillSpan(int y, float left, float right, uint32_t color)
+{
+    FillSpan(y, FirstPixel(left, mWidth), FirstPixel(right, mWidth), color);
+}
+
+void SoftwareBackend::PlotPixel(int x, int y, uint32_t color)
+{
+    if (x >= mClipLeft && x < mClipRight && y >= mClipTop && y < mClipBottom)
+        mPixels[(size_t)y * mWidth + x] = color;
+}
+
+void SoftwareBackend::SetClip(int left, int top, int right, int bottom)
+{
+    mClipLeft = left > 0 ? (left < mWidth ? left : mWidth) : 0;
+    mClipTop = top > 0 ? (top < mHeight ? top : mHeight) : 0;
+    mClipRight = right > mClipLeft ? (right < mWidth ? right : mWidth) : mClipLeft;
+    mClipBottom = bottom > mClipTop ? (bottom < mHeight ? bottom : mHeight) : mClipTop;
+}
+
+void SoftwareBackend::ResetClip()
+{
+    SetClip(0, 0, mWidth, mHeight);
+}
+
+/// ---------------------------------------------------------------------------------
+/// Shapes
+/// ---------------------------------------------------------------------------------
+void SoftwareBackend::Clear(RenderColor color)
+{
+    uint32_t packed = Pack(color);
+    for (int y = mClipTop; y < mClipBottom; y++)
+    {
+        FillSpan(y, mClipLeft, mClipRight, packed);
+    }
+}
+
+void SoftwareBackend::FillRectangle(float left, float top, float right, float bottom, RenderColor color)
+{
+    uint32_t packed = Pack(color);
+    int firstRow = FirstPixel(top, mHeight);
+    int endRow = FirstPixel(bottom, mHeight);
+
+    for (int y = firstRow; y < endRow; y++)
+    {
+        FillSpan(y, left, right, packed);
+    }
+}
+
+void SoftwareBackend::DrawRectangle(float left, float top, float right, float bottom, RenderColor color, float thickness)
+{
+    float half = (thickness > 0.0f ? thickness : 1.0f) * 0.5f;
+
+    // Top and bottom edges run the full width; the sides fill in between them
+    FillRectangle(left - half, top - half, right + half, top + half, color);
+    FillRectangle(left - half, bottom - half, right + half, bottom + half, color);
+    FillRectangle(left - half, top + half, left + half, bottom - half, color);
+    FillRectangle(right - half, top + half, right + half, bottom - half, color);
+}
+
+void SoftwareBackend::FillRing(float centerX, float centerY, float outerRadius, float innerRadius, uint32_t color)
+{
+    if (outerRadius <= 0.0f)
+        return;
+
+    int firstRow = FirstPixel(centerY - outerRadius, mHeight);
+    int endRow = FirstPixel(centerY + outerRadius, mHeight);
+    float outerSquared = outerRadius * outerRadius;
+    float innerSquared = innerRadius > 0.0f ? innerRadius * innerRadius : -1.0f;
+
+    for (int y = firstRow; y < endRow; y++)
+    {
+        float dy = (float)y + 0.5f - centerY;
+        float dySquared = dy * dy;
+        if (dySquared > outerSquared)
+            continue;
+
+        float outerHalf = sqrtf(outerSquared - dySquared);
+
+        if (dySquared < innerSquared)
+        {
+            // This row goes through the hole: one span either side of it
+            float innerHalf = sqrtf(innerSquared - dySquared);
+            FillSpan(y, centerX - outerHalf, centerX - innerHalf, color);
+            FillSpan(y, centerX + innerHalf, centerX + outerHalf, color);
+        }
+        else
+        {
+            FillSpan(y, centerX - outerHalf, centerX + outerHalf, color);
+        }
+    }
+}
+
+/// The midpoint circle algorithm: walk one eighth of the circle, from (r, 0) up to
+/// the diagonal, choosing between stepping straight up or up-and-left by checking
+/// which side of the circle the midpoint between them is on. The other seven eighths
+/// are mirror images. Only integer adds in the loop.
+///
+/// The numbers can come from a scene file that nobody checked, so they're checked
+/// here before they're turned into ints: NaN, infinity or anything past the range of
+/// an int would be undefined behaviour.
+void SoftwareBackend::MidpointCircle(float centerX, float centerY, float radius, uint32_t color)
+{
+    if (!isfinite(centerX) || !isfinite(centerY) || !isfinite(radius) || radius < 0.0f)
+        return;
+
+    // Past the diagonal, the loop would spend most of its time off the surface (and
+    // the ints could overflow). A circle that big, or that far away, is drawn as a one
+    // pixel wide ring instead, which only visits the rows it's on.
+    float diagonal = sqrtf((float)mWidth * (float)mWidth + (float)mHeight * (float)mHeight);
+    if (radius > diagonal || centerX < -diagonal || centerX > (float)mWidth + diagonal ||
+        centerY < -diagonal || centerY > (float)mHeight + diagonal)
+    {
+        FillRing(centerX, centerY, radius + 0.5f, radius - 0.5f, color);
+        return;
+    }
+
+    int cx = (int)floorf(centerX);
+    int cy = (int)floorf(centerY);
+    int x = (int)(radius + 0.5f);
+    int y = 0;
+    int decision = 1 - x;
+
+    while (x >= y)
+    {
+        PlotPixel(cx + x, cy + y, color);
+        PlotPixel(cx - x, cy + y, color);
+        PlotPixel(cx + x, cy - y, color);
+        PlotPixel(cx - x, cy - y, color);
+        PlotPixel(cx + y, cy + x, color);
+        PlotPixel(cx - y, cy + x, color);
+        PlotPixel(cx + y, cy - x, color);
+        PlotPixel(cx - y, cy - x, color);
+
+        y++;
+        if (decision < 0)
+        {
+            decision += 2 * y + 1;
+        }
+        else
+        {
+            x--;
+            decision += 2 * (y - x) + 1;
+        }
+    }
+}
+
+void SoftwareBackend::DrawCircle(float centerX, float centerY, float radius, RenderColor color, float thickness)
+{
+    if (thickness <= 1.0f)
+    {
+        MidpointCircle(centerX, centerY, radius, Pack(color));
+        return;
+    }
+
+    float half = thickness * 0.5f;
+    FillRing(centerX, centerY, radius + half, radius - half, Pack(color));
+}
+
+void SoftwareBackend::FillCircle(float centerX, float centerY, float radius, RenderColor color)
+{
+    FillRing(centerX, centerY, radius, -1.0f, Pack(color));
+}
+
+/// ---------------------------------------------------------------------------------
+/// Image files
+/// ---------------------------------------------------------------------------------
+bool SoftwareBackend::WritePPM(const char* path) const
+{
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr)
+        return false;
+
+    fprintf(file, "P6\n%d %d\n255\n", mWidth, mHeight);
+
+    std::vector<uint8_t> row((size_t)mWidth * 3);
+    for (int y = 0; y < mHeight; y++)
+    {
+        const uint8_t* pixel = (const uint8_t*)(mPixels.data() + (size_t)y * mWidth);
+        for (int x = 0; x < mWidth; x++)
+        {
+            row[x * 3 + 0] = pixel[x * 4 + 0];
+            row[x * 3 + 1] = pixel[x * 4 + 1];
+            row[x * 3 + 2] = pixel[x * 4 + 2];
+        }
+        fwrite(row.data(), 1, row.size(), file);
+    }
+
+    bool ok = ferror(file) == 0;
+    return fclose(file) == 0 && ok;
+}
+
+static void PutBigEndian32(std::vector<uint8_t>& out, uint32_t value)
+{
+    out.push_back((uint8_t)(value >> 24));
+    out.push_back((uint8_t)(value >> 16));
+    out.push_back((uint8_t)(value >> 8));
+    out.push_back((uint8_t)value);
+}
+
+// length, type, data, then a CRC of the type and data
+static void WritePngChunk(FILE* file, const char* type, const std::vector<uint8_t>& data)
+{
+    std::vector<uint8_t> chunk;
+    chunk.reserve(data.size() + 12);
+    PutBigEndian32(chunk, (uint32_t)data.size());
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    PutBigEndian32(chunk, Crc32(0, chunk.data() + 4, chunk.size() - 4));
+    fwrite(chunk.data(), 1, chunk.size(), file);
+}
+
+bool SoftwareBackend::WritePNG(const char* path) const
+{
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr)
+        return false;
+
+    static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    fwrite(signature, 1, sizeof(signature), file);
+
+    std::vector<uint8_t> header;
+    PutBigEndian32(header, (uint32_t)mWidth);
+    PutBigEndian32(header, (uint32_t)mHeight);
+    header.push_back(8);    // bits per channel
+    header.push_back(6);    // RGBA
+    header.push_back(0);    // deflate
+    header.push_back(0);    // the standard filters
+    header.push_back(0);    // not interlaced
+    WritePngChunk(file, "IHDR", header);
+
+    // Each row is a filter type (0, 'none') followed by the pixels, which are
+    // already RGBA bytes.
+    const size_t rowBytes = (size_t)mWidth * 4;
+    std::vector<uint8_t> raw;
+    raw.reserve((rowBytes + 1) * mHeight);
+    for (int y = 0; y < mHeight; y++)
+    {
+        const uint8_t* pixels = (const uint8_t*)(mPixels.data() + (size_t)y * mWidth);
+        raw.push_back(0);
+        raw.insert(raw.end(), pixels, pixels + rowBytes);
+    }
+
+    // A zlib stream of 'stored' (uncompressed) deflate blocks, 64K at most each
+    std::vector<uint8_t> compressed;
+    compressed.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+    compressed.push_back(0x78);
+    compressed.push_back(0x01);
+
+    size_t offset = 0;
+    do
+    {
+        size_t size = raw.size() - offset;
+        if (size > 65535)
+            size = 65535;
+        bool last = offset + size == raw.size();
+
+        compressed.push_back(last ? 1 : 0);
+        compressed.push_back((uint8_t)size);
+        compressed.push_back((uint8_t)(size >> 8));
+        compressed.push_back((uint8_t)~size);
+        compressed.push_back((uint8_t)(~size >> 8));
+        compressed.insert(compressed.end(), raw.begin() + offset, raw.begin() + offset + size);
+        offset += size;
+    } while (offset < raw.size());
+
+    uint32_t adlerA = 1;
+    uint32_t adlerB = 0;
+    for (uint8_t byte : raw)
+    {
+        adlerA = (adlerA + byte) % 65521;
+        adlerB = (adlerB + adlerA) % 65521;
+    }
+    PutBigEndian32(compressed, (adlerB << 16) | adlerA);
+
+    WritePngChunk(file, "IDAT", compressed);
+    WritePngChunk(file, "IEND", std::vector<uint8_t>());
+
+    bool ok = ferror(file) == 0;
+    return fclose(file) == 0 && ok;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#include "RenderBackend.h"
+
+/// ---------------------------------------------------------------------------------
+/// A RenderBackend that draws into an array of pixels in memory, on the CPU, with no
+/// display (or Allegro) anywhere in sight. Handy on servers, and for 'golden image'
+/// tests: render a scene, write it out with WritePPM/WritePNG, and compare it with
+/// one you know is right.
+///
+/// Everything is drawn as horizontal runs of pixels ('spans'), one row at a time:
+///  - filled rectangles are one span per row,
+///  - filled circles work out where each row enters and leaves the circle,
+///  - thick outlines are the same thing with a hole in the middle,
+///  - one pixel outlines of circles use the midpoint circle algorithm.
+///
+/// A pixel is covered when its center is inside the shape. Colors simply replace
+/// what's there; there's no blending.
+/// ---------------------------------------------------------------------------------
+class SoftwareBackend : public RenderBackend
+{
+public:
+    SoftwareBackend(int width, int height);
+
+    int Width() const { return mWidth; }
+    int Height() const { return mHeight; }
+
+    /// Width() * Height() pixels, row by row from the top. Each one is 4 bytes: R, G,
+    /// B and A, in that order in memory (whatever the CPU's byte order).
+    const uint32_t* Pixels() const { return mPixels.data(); }
+    uint32_t* Pixels() { return mPixels.data(); }
+
+    static uint32_t Pack(RenderColor color);
+    RenderColor GetPixel(int x, int y) const;
+
+    /// Binary PPM (P6); drops the alpha channel. Returns false if the file couldn't
+    /// be written.
+    bool WritePPM(const char* path) const;
+
+    /// RGBA PNG. It isn't compressed (it uses 'stored' deflate blocks), so it's big,
+    /// but any image viewer or diff tool can open it.
+    bool WritePNG(const char* path) const;
+
+    virtual void Clear(RenderColor color) override;
+
+    virtual void DrawCircle(float centerX, float centerY, float radius, RenderColor color, float thickness) override;
+    virtual void FillCircle(float centerX, float centerY, float radius, RenderColor color) override;
+
+    virtual void DrawRectangle(float left, float top, float right, float bottom, RenderColor color, float thickness) override;
+    virtual void FillRectangle(float left, float top, float right, float bottom, RenderColor color) override;
+
+    virtual void SetClip(int left, int top, int right, int bottom) override;
+    virtual void ResetClip() override;
+
+private:
+    /// Pixels [left, right) of row y; clipped to the clip rectangle.
+    void FillSpan(int y, int left, int right, uint32_t color);
+    void FillSpan(int y, float left, float right, uint32_t color);
+
+    void PlotPixel(int x, int y, uint32_t color);
+
+    /// Rows of the ring between innerRadius and outerRadius. A negative innerRadius
+    /// fills the whole circle.
+    void FillRing(float centerX, float centerY, float outerRadius, float innerRadius, uint32_t color);
+
+    void MidpointCircle(float centerX, float centerY, float radius, uint32_t color);
+
+    int mWidth;
+    int mHeight;
+    std::vector<uint32_t> mPixels;
+
+    // The clip rectangle, always inside the framebuffer: columns [mClipLeft,
+    // mClipRight) of rows [mClipTop, mClipBottom)
+    int mClipLeft;
+    int mClipTop;
+    int mClipRight;
+    int mClipBottom;
+};
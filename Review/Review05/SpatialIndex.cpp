@@ -0,0 +1,406 @@
+#include "SpatialIndex.h"
+
+#include <math.h>
+
+/// ---------------------------------------------------------------------------------
+/// UniformGrid
+/// ---------------------------------------------------------------------------------
+UniformGrid::UniformGrid(const AABB& world, float cellSize)
+    : mOrigin(world.min)
+    , mInverseCellSize(1.0f / cellSize)
+{
+    mColumns = std::max((int)ceilf((world.max.x - world.min.x) * mInverseCellSize), 1);
+    mRows = std::max((int)ceilf((world.max.y - world.min.y) * mInverseCellSize), 1);
+    mCells.resize((size_t)mColumns * (size_t)mRows);
+}
+
+void UniformGrid::Clear()
+{
+    for (std::vector<Entry>& cell : mCells)
+    {
+        cell.clear();
+    }
+    mBounds.clear();
+}
+
+// Clamped in float, before the conversion: a shape a long way outside the world
+// shouldn't overflow an int.
+static int CellCoordinate(float value, int cellCount)
+{
+    float cell = floorf(value);
+    if (!(cell >= 0.0f))        // Also catches NaN
+        return 0;
+    if (cell >= (float)(cellCount - 1))
+        return cellCount - 1;
+    return (int)cell;
+}
+
+UniformGrid::CellRange UniformGrid::CellsFor(const AABB& bounds) const
+{
+    CellRange range;
+    range.minX = CellCoordinate((bounds.min.x - mOrigin.x) * mInverseCellSize, mColumns);
+    range.minY = CellCoordinate((bounds.min.y - mOrigin.y) * mInverseCellSize, mRows);
+    range.maxX = CellCoordinate((bounds.max.x - mOrigin.x) * mInverseCellSize, mColumns);
+    range.maxY = CellCoordinate((bounds.max.y - mOrigin.y) * mInverseCellSize, mRows);
+    return range;
+}
+
+void UniformGrid::AddToCells(ShapeId id, const AABB& bounds)
+{
+    CellRange range = CellsFor(bounds);
+    Entry entry = { bounds, id };
+
+    for (int y = range.minY; y <= range.maxY; y++)
+    {
+        for (int x = range.minX; x <= range.maxX; x++)
+        {
+            mCells[CellIndex(x, y)].push_back(entry);
+        }
+    }
+}
+
+void UniformGrid::RemoveFromCells(ShapeId id, const AABB& bounds)
+{
+    CellRange range = CellsFor(bounds);
+
+    for (int y = range.minY; y <= range.maxY; y++)
+    {
+        for (int x = range.minX; x <= range.maxX; x++)
+        {
+            // Order within a cell doesn't matter, so swap with the last one and pop
+            std::vector<Entry>& cell = mCells[CellIndex(x, y)];
+            for (size_t index = 0; index < cell.size(); index++)
+            {
+                if (cell[index].id == id)
+                {
+                    cell[index] = cell.back();
+                    cell.pop_back();
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void UniformGrid::Insert(ShapeId id, const AABB& bounds)
+{
+    std::unordered_map<ShapeId, AABB>::iterator found = mBounds.find(id);
+    if (found != mBounds.end())
+    {
+        Update(id, bounds);
+        return;
+    }
+
+    mBounds[id] = bounds;
+    AddToCells(id, bounds);
+}
+
+void UniformGrid::Update(ShapeId id, const AABB& bounds)
+{
+    std::unordered_map<ShapeId, AABB>::iterator found = mBounds.find(id);
+    if (found == mBounds.end())
+    {
+        Insert(id, bounds);
+        return;
+    }
+
+    AABB previous = found->second;
+    found->second = bounds;
+
+    CellRange before = CellsFor(previous);
+    CellRange after = CellsFor(bounds);
+    if (before.minX != after.minX || before.minY != after.minY || before.maxX != after.maxX || before.maxY != after.maxY)
+    {
+        RemoveFromCells(id, previous);
+        AddToCells(id, bounds);
+        return;
+    }
+
+    // Still in the same cells (the usual case for a small move): just refresh the
+    // copies of its bounds
+    for (int y = after.minY; y <= after.maxY; y++)
+    {
+        for (int x = after.minX; x <= after.maxX; x++)
+        {
+            for (Entry& entry : mCells[CellIndex(x, y)])
+            {
+                if (entry.id == id)
+                {
+                    entry.bounds = bounds;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+bool UniformGrid::Remove(ShapeId id)
+{
+    std::unordered_map<ShapeId, AABB>::iterator found = mBounds.find(id);
+    if (found == mBounds.end())
+        return false;
+
+    RemoveFromCells(id, found->second);
+    mBounds.erase(found);
+    return true;
+}
+
+void UniformGrid::Query(const AABB& region, std::vector<ShapeId>& out) const
+{
+    CellRange range = CellsFor(region);
+
+    for (int y = range.minY; y <= range.maxY; y++)
+    {
+        for (int x = range.minX; x <= range.maxX; x++)
+        {
+            for (const Entry& entry : mCells[CellIndex(x, y)])
+            {
+                if (!Overlaps(entry.bounds, region))
+                    continue;
+
+                // A shape covering several of these cells is in all of them; only
+                // the first of them (top left) reports it.
+                CellRange cells = CellsFor(entry.bounds);
+                if (x == std::max(cells.minX, range.minX) && y == std::max(cells.minY, range.minY))
+                {
+                    out.push_back(entry.id);
+                }
+            }
+        }
+    }
+}
+
+void UniformGrid::Query(Vec2 point, std::vector<ShapeId>& out) const
+{
+    CellRange range = CellsFor(AABB(point, point));
+
+    for (const Entry& entry : mCells[CellIndex(range.minX, range.minY)])
+    {
+        if (Contains(entry.bounds, point))
+        {
+            out.push_back(entry.id);
+        }
+    }
+}
+
+/// ---------------------------------------------------------------------------------
+/// BoundingVolumeHierarchy
+/// ---------------------------------------------------------------------------------
+static const int kBinCount = 16;
+
+struct SplitBin
+{
+    AABB   bounds;
+    size_t count;
+};
+
+// Which of the kBinCount bins along `axis` a center falls in. The build uses this
+// both to score the splits and to do the chosen one, so the two always agree.
+static int BinFor(Vec2 center, int axis, const AABB& centers, float binsPerUnit)
+{
+    float offset = axis == 0 ? center.x - centers.min.x : center.y - centers.min.y;
+    int bin = (int)(offset * binsPerUnit);
+    return bin < 0 ? 0 : (bin >= kBinCount ? kBinCount - 1 : bin);
+}
+
+void BoundingVolumeHierarchy::Build(const ShapeStore& store)
+{
+    std::vector<ShapeId> ids;
+    std::vector<AABB> bounds;
+    store.CollectBounds(ids, bounds);
+    Build(ids.data(), bounds.data(), ids.size());
+}
+
+void BoundingVolumeHierarchy::Build(const ShapeId* ids, const AABB* bounds, size_t count)
+{
+    mIds.assign(ids, ids + count);
+    mBounds.assign(bounds, bounds + count);
+    mNodes.clear();
+    mDepth = 0;
+    if (count == 0)
+        return;
+
+    std::vector<Vec2> centers(count);
+    for (size_t index = 0; index < count; index++)
+    {
+        centers[index] = mBounds[index].Center();
+    }
+
+    // Every split adds two nodes and makes one more leaf, so that's the most there'll be
+    mNodes.reserve(2 * count - 1);
+    Node root = { AABB(), 0, (uint32_t)count };
+    mNodes.push_back(root);
+
+    struct Pending
+    {
+        uint32_t node;
+        int      depth;
+    };
+    std::vector<Pending> pending;
+    Pending first = { 0, 1 };
+    pending.push_back(first);
+
+    while (!pending.empty())
+    {
+        Pending current = pending.back();
+        pending.pop_back();
+
+        const size_t begin = mNodes[current.node].first;
+        const size_t end = begin + mNodes[current.node].count;
+
+        AABB nodeBounds;
+        AABB centerBounds;
+        for (size_t index = begin; index < end; index++)
+        {
+            nodeBounds = Union(nodeBounds, mBounds[index]);
+            centerBounds = Union(centerBounds, centers[index]);
+        }
+        mNodes[current.node].bounds = nodeBounds;
+        mDepth = std::max(mDepth, current.depth);
+
+        if (end - begin <= (size_t)kMaxLeafSize || current.depth >= kMaxDepth)
+            continue;
+
+        // Score the cut after each bin on both axes: the size of each side's box times
+        // the number of shapes on that side.
+        int bestAxis = -1;
+        int bestBin = 0;
+        float bestCost = 0.0f;
+        for (int axis = 0; axis < 2; axis++)
+        {
+            float extent = axis == 0 ? centerBounds.max.x - centerBounds.min.x : centerBounds.max.y - centerBounds.min.y;
+            if (!(extent > 0.0f))
+                continue;
+
+            float binsPerUnit = (float)kBinCount / extent;
+            SplitBin bins[kBinCount];
+            for (SplitBin& bin : bins)
+            {
+                bin.count = 0;
+            }
+            for (size_t index = begin; index < end; index++)
+            {
+                SplitBin& bin = bins[BinFor(centers[index], axis, centerBounds, binsPerUnit)];
+                bin.bounds = Union(bin.bounds, mBounds[index]);
+                bin.count++;
+            }
+
+            // Sweep from the right to get each cut's right hand side, then from the
+            // left, scoring as we go
+            float rightArea[kBinCount];
+            size_t rightCount[kBinCount];
+            AABB right;
+            size_t rightShapes = 0;
+            for (int bin = kBinCount - 1; bin > 0; bin--)
+            {
+                right = Union(right, bins[bin].bounds);
+                rightShapes += bins[bin].count;
+                rightArea[bin] = right.HalfPerimeter();
+                rightCount[bin] = rightShapes;
+            }
+
+            AABB left;
+            size_t leftShapes = 0;
+            for (int bin = 0; bin < kBinCount - 1; bin++)
+            {
+                left = Union(left, bins[bin].bounds);
+                leftShapes += bins[bin].count;
+                if (leftShapes == 0 || rightCount[bin + 1] == 0)
+                    continue;
+
+                float cost = left.HalfPerimeter() * (float)leftShapes + rightArea[bin + 1] * (float)rightCount[bin + 1];
+                if (bestAxis < 0 || cost < bestCost)
+                {
+                    bestAxis = axis;
+                    bestBin = bin;
+                    bestCost = cost;
+                }
+            }
+        }
+
+        // Split: shapes in bins up to bestBin go left. If every center is in the same
+        // place there's nothing to score, so just cut the list in half.
+        size_t middle = begin + (end - begin) / 2;
+        if (bestAxis >= 0)
+        {
+            float extent = bestAxis == 0 ? centerBounds.max.x - centerBounds.min.x : centerBounds.max.y - centerBounds.min.y;
+            float binsPerUnit = (float)kBinCount / extent;
+            size_t low = begin;
+            size_t high = end;
+            while (low < high)
+            {
+                if (BinFor(centers[low], bestAxis, centerBounds, binsPerUnit) <= bestBin)
+                {
+                    low++;
+                }
+                else
+                {
+                    high--;
+                    std::swap(mIds[low], mIds[high]);
+                    std::swap(mBounds[low], mBounds[high]);
+                    std::swap(centers[low], centers[high]);
+                }
+            }
+            middle = low;
+        }
+
+        uint32_t leftChild = (uint32_t)mNodes.size();
+        Node leftNode = { AABB(), (uint32_t)begin, (uint32_t)(middle - begin) };
+        Node rightNode = { AABB(), (uint32_t)middle, (uint32_t)(end - middle) };
+        mNodes.push_back(leftNode);
+        mNodes.push_back(rightNode);
+        mNodes[current.node].first = leftChild;
+        mNodes[current.node].count = 0;
+
+        Pending leftPending = { leftChild, current.depth + 1 };
+        Pending rightPending = { leftChild + 1, current.depth + 1 };
+        pending.push_back(rightPending);
+        pending.push_back(leftPending);
+    }
+}
+
+template<typename Overlap>
+void BoundingVolumeHierarchy::Search(Overlap overlaps, std::vector<ShapeId>& out) const
+{
+    if (mNodes.empty())
+        return;
+
+    // Each level down pops one node and pushes two, so the stack never holds more
+    // than one node per level, plus one
+    uint32_t stack[kMaxDepth + 1];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        const Node& node = mNodes[stack[--top]];
+        if (!overlaps(node.bounds))
+            continue;
+
+        if (node.count > 0)
+        {
+            for (uint32_t index = node.first; index < node.first + node.count; index++)
+            {
+                if (overlaps(mBounds[index]))
+                {
+                    out.push_back(mIds[index]);
+                }
+            }
+        }
+        else
+        {
+            stack[top++] = node.first + 1;
+            stack[top++] = node.first;
+        }
+    }
+}
+
+void BoundingVolumeHierarchy::Query(const AABB& region, std::vector<ShapeId>& out) const
+{
+    Search([&](const AABB& bounds) { return Overlaps(bounds, region); }, out);
+}
+
+void BoundingVolumeHierarchy::Query(Vec2 point, std::vector<ShapeId>& out) const
+{
+    Search([&](const AABB& bounds) { return Contains(bounds, point); }, out);
+}
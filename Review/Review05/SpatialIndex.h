@@ -0,0 +1,187 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include "Bounds.h"
+#include "ShapeStore.h"
+
+/// ---------------------------------------------------------------------------------
+/// Finding shapes by where they are, without looking at every one of them.
+///
+/// ShapeStore::Draw() draws everything, on screen or not, and the only way to find
+/// the shape under the mouse is to test them all. With a million shapes in a world
+/// much bigger than the screen, that's a million shapes' worth of work to draw the
+/// few hundred you can see. A spatial index sorts the shapes' bounding boxes by
+/// position once, so a query only looks at the ones near the region it asks about.
+///
+/// Two kinds, for two kinds of scene:
+///
+/// UniformGrid, for shapes that move. The world is cut into equal square cells, and
+/// each cell lists the shapes that overlap it. Moving a shape only touches the cells
+/// it leaves and enters, so updating every frame is cheap. It works best when the
+/// shapes are spread evenly and are about the size of a cell or smaller.
+///
+/// BoundingVolumeHierarchy, for shapes that stay put. A tree of boxes: each node's
+/// box holds all the shapes below it, so a query skips a whole subtree as soon as
+/// its box misses. Building it is the expensive part (it's built once, from
+/// everything), but it copes with any mix of sizes and any clustering.
+///
+/// Both give back ShapeIds whose *bounds* overlap the query; ShapeStore's Contains()
+/// and Overlaps() do the exact test. Queries are const and don't change anything, so
+/// several threads can query the same index at once.
+/// ---------------------------------------------------------------------------------
+
+class UniformGrid
+{
+public:
+    /// Shapes outside `world` are kept in the cells along its edge, so they're still
+    /// found - just not as quickly.
+    UniformGrid(const AABB& world, float cellSize);
+
+    size_t Count() const { return mBounds.size(); }
+    void Clear();
+
+    void Insert(ShapeId id, const AABB& bounds);
+    void Update(ShapeId id, const AABB& bounds);
+    bool Remove(ShapeId id);
+
+    /// Adds the shapes whose bounds overlap `region` (or contain `point`) to `out`.
+    /// Each shape is added once, however many cells it covers.
+    void Query(const AABB& region, std::vector<ShapeId>& out) const;
+    void Query(Vec2 point, std::vector<ShapeId>& out) const;
+
+private:
+    struct Entry
+    {
+        AABB    bounds;     // A copy, so a query never has to look anything up
+        ShapeId id;
+    };
+
+    struct CellRange
+    {
+        int minX, minY;
+        int maxX, maxY;
+    };
+
+    CellRange CellsFor(const AABB& bounds) const;
+    int CellIndex(int x, int y) const { return y * mColumns + x; }
+    void AddToCells(ShapeId id, const AABB& bounds);
+    void RemoveFromCells(ShapeId id, const AABB& bounds);
+
+    Vec2  mOrigin;
+    float mInverseCellSize;
+    int   mColumns;
+    int   mRows;
+
+    std::vector<std::vector<Entry>> mCells;
+    std::unordered_map<ShapeId, AABB> mBounds;  ///< Where each shape was put, to find it again
+};
+
+class BoundingVolumeHierarchy
+{
+public:
+    BoundingVolumeHierarchy() : mDepth(0) {}
+
+    /// Builds the tree over `count` shapes, replacing what was there before.
+    ///
+    /// Each split is picked with the 'surface area heuristic': a query looks inside a
+    /// box roughly in proportion to the box's size, so the best split is the one with
+    /// the smallest (size of box * shapes inside) added up over both halves. The
+    /// candidates are 16 evenly spaced cuts along each axis.
+    void Build(const ShapeId* ids, const AABB* bounds, size_t count);
+
+    /// Convenience: every shape in the store.
+    void Build(const ShapeStore& store);
+
+    size_t Count() const { return mIds.size(); }
+    size_t NodeCount() const { return mNodes.size(); }
+    int Depth() const { return mDepth; }
+    AABB WorldBounds() const { return mNodes.empty() ? AABB() : mNodes[0].bounds; }
+
+    void Query(const AABB& region, std::vector<ShapeId>& out) const;
+    void Query(Vec2 point, std::vector<ShapeId>& out) const;
+
+    /// Deeper than this, a node becomes a leaf however many shapes it has. It keeps
+    /// the query's stack a fixed size; a tree of balanced splits this deep would hold
+    /// 2^48 shapes.
+    static const int kMaxDepth = 48;
+    static const int kMaxLeafSize = 4;
+
+private:
+    /// A leaf has count > 0 and holds mIds[first] to mIds[first + count - 1]. Any
+    /// other node's children are mNodes[first] and mNodes[first + 1].
+    struct Node
+    {
+        AABB     bounds;
+        uint32_t first;
+        uint32_t count;
+    };
+
+    template<typename Overlap>
+    void Search(Overlap overlaps, std::vector<ShapeId>& out) const;
+
+    std::vector<Node>    mNodes;
+    std::vector<ShapeId> mIds;      ///< In leaf order, so each leaf's shapes are together
+    std::vector<AABB>    mBounds;   ///< Likewise
+    int                  mDepth;
+};
+
+/// ---------------------------------------------------------------------------------
+/// Culling and picking with either index
+/// ---------------------------------------------------------------------------------
+
+/// Draws the shapes whose bounds overlap `viewport`, in the same order Draw() would,
+/// and returns how many that was. `visible` is scratch space; keep it around between
+/// frames so it doesn't have to grow again.
+template<typename Index>
+size_t DrawVisible(const ShapeStore& store, const Index& index, const AABB& viewport, std::vector<ShapeId>& visible)
+{
+    // Outlines are centered on the edge, so they stick out half a pixel
+    AABB padded(viewport.min - Vec2(1.0f, 1.0f), viewport.max + Vec2(1.0f, 1.0f));
+
+    visible.clear();
+    index.Query(padded, visible);
+    std::sort(visible.begin(), visible.end());
+    store.Draw(visible.data(), visible.size());
+    return visible.size();
+}
+
+/// The shape at `point` that's drawn on top of any others there (the last one Draw()
+/// draws). Returns false if there's none, and leaves `picked` alone.
+template<typename Index>
+bool PickShape(const ShapeStore& store, const Index& index, Vec2 point, ShapeId& picked, std::vector<ShapeId>& scratch)
+{
+    scratch.clear();
+    index.Query(point, scratch);
+
+    bool found = false;
+    ShapeId top = 0;
+    for (ShapeId id : scratch)
+    {
+        if ((!found || id > top) && store.Contains(id, point))
+        {
+            top = id;
+            found = true;
+        }
+    }
+
+    if (found)
+        picked = top;
+    return found;
+}
+
+/// Every shape that really overlaps `region` (not just its bounds), in drawing order.
+template<typename Index>
+void PickShapes(const ShapeStore& store, const Index& index, const AABB& region, std::vector<ShapeId>& picked)
+{
+    picked.clear();
+    index.Query(region, picked);
+    picked.erase(std::remove_if(picked.begin(), picked.end(),
+                                [&](ShapeId id) { return !store.Overlaps(id, region); }),
+                 picked.end());
+    std::sort(picked.begin(), picked.end());
+}
@@ -2,56 +2,122 @@
 #include <allegro5/allegro_font.h>
 #include <allegro5/allegro_primitives.h>
 
-#include <new>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
 
+#include "AllocationTracker.h"
+#include "DirtyRegions.h"
 #include "Shape.h"
 #include "Circle.h"
 #include "Rectangle.h"
+#include "ShapeStore.h"
+#include "Scene.h"
+#include "AllegroBackend.h"
+#include "ShapeBatcher.h"
+#include "SpatialIndex.h"
 
 ALLEGRO_FONT* gFont = nullptr;
 
-void main()
+int main()
 {
+    ReportLeaksAtExit();
+
     al_init();
     al_init_font_addon();
     al_init_primitives_addon();
 
-    char* buffer = (char*)malloc(1000);
-
     ALLEGRO_DISPLAY* display = al_create_display(800, 600);
     gFont = al_create_builtin_font();
 
-    VirtualShape** shapes = new VirtualShape*[10];
+    // The circles and rectangles live in their own pools, instead of ten separate
+    // `new`s behind an array of VirtualShape pointers. See ShapeStore.h.
+    ShapeStore shapes;
+    BuildScene(shapes);
+
+    // The shapes don't know about Allegro; they draw with whichever RenderBackend
+    // is current. HeadlessMain.cpp draws the same scene with the SoftwareBackend.
+    //
+    // AllegroBackend makes one al_draw_* call per shape. The ShapeBatcher gathers the
+    // whole frame into vertex buffers and draws them in Flush(), one call per batch.
+    AllegroBackend backend;
+    SetRenderBackend(&backend);
+    shapes.Draw();
+    unsigned unbatchedCalls = backend.DrawCalls();
+
+    ShapeBatcher batcher;
+    SetRenderBackend(&batcher);
+
+    // The frames are drawn into a bitmap of our own, which keeps its pixels from one
+    // frame to the next (after al_flip_display, the backbuffer's are undefined). That
+    // way each frame only has to redraw what changed; see DirtyRegions.h.
+    ALLEGRO_BITMAP* canvas = al_create_bitmap(800, 600);
+    al_set_target_bitmap(canvas);
+
+    // Only what's on screen goes to the batcher. With these ten shapes that's all of
+    // them; with a world bigger than the screen it's what keeps the frame cheap.
+    BoundingVolumeHierarchy index;
+    index.Build(shapes);
+    std::vector<ShapeId> visible;
+
+    const RenderColor background = MakeRenderColor(0, 0, 0);
+    batcher.ResetDrawCalls();
+    batcher.Clear(background);
+    DrawVisible(shapes, index, AABB(Vec2(0.0f, 0.0f), Vec2(800.0f, 600.0f)), visible);
+    batcher.Flush();
+
+    printf("%u shapes: %u draw calls one at a time, %u batched\n",
+           (unsigned)shapes.Count(), unbatchedCalls, batcher.DrawCalls());
+
+    // Five seconds of circle 4 sliding from side to side. The BVH can't follow a
+    // shape that moves, so the redraws query a UniformGrid instead.
+    UniformGrid grid(AABB(Vec2(0.0f, 0.0f), Vec2(800.0f, 600.0f)), 64.0f);
+    for (size_t circle = 0; circle < shapes.Circles().Count(); circle++)
+    {
+        grid.Insert(CircleId(circle), shapes.Bounds(CircleId(circle)));
+    }
+    for (size_t rectangle = 0; rectangle < shapes.Rectangles().Count(); rectangle++)
+    {
+        grid.Insert(RectangleId(rectangle), shapes.Bounds(RectangleId(rectangle)));
+    }
+
+    DirtyRegions dirty(800, 600);
+    shapes.TrackChanges(&dirty);
 
-    shapes[0] = new Circle(20.0f, 30.0f, 5.0f);
-    shapes[1] = new Circle(40.0f, 60.0f, 10.0f);
-    shapes[2] = new Circle(60.0f, 90.0f, 15.0f);
-    shapes[3] = new Circle(80.0f, 120.0f, 20.0f);
-    shapes[4] = new Circle(100.0f, 150.0f, 30.0f);
-    shapes[5] = new Rectangle(200.0f, 300.0f, 5.0f, 5.0f);
-    shapes[6] = new Rectangle(220.0f, 330.0f, 10.0f, 10.0f);
-    shapes[7] = new Rectangle(240.0f, 360.0f, 15.0f, 15.0f);
-    shapes[8] = new Rectangle(260.0f, 390.0f, 20.0f, 20.0f);
-    shapes[9] = new Rectangle(280.0f, 420.0f, 25.0f, 25.0f);
+    const ShapeId moving = CircleId(4);
+    const Vec2 center(shapes.Circles().x[4], shapes.Circles().y[4]);
+    double start = al_get_time();
+    double totalPercent = 0.0;
+    int frames = 0;
 
-    for (int index = 0; index < 10; index++)
+    for (double now = start; now - start < 5.0; now = al_get_time())
     {
-        shapes[index]->Draw();
+        shapes.SetCenter(moving, center + Vec2(200.0f * sinf((float)(now - start) * 2.0f), 0.0f));
+        grid.Update(moving, shapes.Bounds(moving));
+
+        al_set_target_bitmap(canvas);
+        batcher.ResetDrawCalls();
+        RedrawDirty(shapes, grid, dirty, background, visible);
+        totalPercent += dirty.DirtyPercent();
+        frames++;
+
+        al_set_target_backbuffer(display);
+        al_draw_bitmap(canvas, 0.0f, 0.0f, 0);
+        al_draw_textf(gFont, al_map_rgb(255, 255, 0), 10.0f, 10.0f, 0,
+                      "%u shapes, %u draw calls, %.1f%% of the pixels redrawn",
+                      (unsigned)shapes.Count(), batcher.DrawCalls(), dirty.DirtyPercent());
+        dirty.Clear();
+
+        al_flip_display();
+        al_rest(1.0 / 60.0);
     }
 
-    al_flip_display();
-    al_rest(5.0);
-
-    delete shapes[0];
-    delete shapes[1];
-    delete shapes[2];
-    delete shapes[3];
-    delete shapes[4];
-    delete shapes[5];
-    delete shapes[6];
-    delete shapes[7];
-    delete shapes[8];
-    delete shapes[9];
+    printf("%d frames, redrawing %.1f%% of the pixels per frame on average\n",
+           frames, frames > 0 ? totalPercent / frames : 0.0);
+
+    shapes.TrackChanges(nullptr);
+    SetRenderBackend(nullptr);
+    al_destroy_bitmap(canvas);
 
     al_destroy_font(gFont);
     al_destroy_display(display);
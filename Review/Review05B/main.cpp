@@ -1,15 +1,4 @@
-
-struct Point2D
-{
-    float x;
-    float y;
-
-    Point2D(float inX, float inY)
-    {
-        x = inX;
-        y = inY;
-    }
-};
+#include "Math2D.h"
 
 class VirtualShape
 {